@@ -46,19 +46,19 @@
 //////////////////////////////////////////////////////////////////////////////////
 
 #include <assert.h>
+#include <string.h>
 #include "debug.h"
 #include "xil_printf.h"
 
 #include "memory_map.h"
 
 P_LOGICAL_SLICE_MAP logicalSliceMapPtr;
-P_VIRTUAL_SLICE_MAP virtualSliceMapPtr;
+P_VALID_SLICE_MAP validSliceMapPtr;
 P_VIRTUAL_BLOCK_MAP virtualBlockMapPtr;
 P_VIRTUAL_DIE_MAP virtualDieMapPtr;
 P_PHY_BLOCK_MAP phyBlockMapPtr;
 P_BAD_BLOCK_TABLE_INFO_MAP bbtInfoMapPtr;
 
-unsigned char sliceAllocationTargetDie; // the destination die of next slice command
 unsigned int mbPerbadBlockSpace;
 
 /**
@@ -66,7 +66,7 @@ unsigned int mbPerbadBlockSpace;
  *
  * The following tasks will be finished in the function:
  *
- * - Initialize logical and virtual slice map (all entries map to NONE)
+ * - Initialize logical slice map (all entries map to NONE) and clear the validity bitmaps
  * - Read/Remake the bad block table of each die
  * - Replace bad blocks with the reserved blocks in the same die
  * - Initialize V2P table and free block list
@@ -84,7 +84,7 @@ void InitAddressMap()
     unsigned int blockNo, dieNo;
 
     logicalSliceMapPtr = (P_LOGICAL_SLICE_MAP)LOGICAL_SLICE_MAP_ADDR;
-    virtualSliceMapPtr = (P_VIRTUAL_SLICE_MAP)VIRTUAL_SLICE_MAP_ADDR;
+    validSliceMapPtr   = (P_VALID_SLICE_MAP)VALID_SLICE_MAP_ADDR;
     virtualBlockMapPtr = (P_VIRTUAL_BLOCK_MAP)VIRTUAL_BLOCK_MAP_ADDR;
     virtualDieMapPtr   = (P_VIRTUAL_DIE_MAP)VIRTUAL_DIE_MAP_ADDR;
     phyBlockMapPtr     = (P_PHY_BLOCK_MAP)PHY_BLOCK_MAP_ADDR;
@@ -101,26 +101,27 @@ void InitAddressMap()
         bbtInfoMapPtr->bbtInfo[dieNo].grownBadUpdate = BBT_INFO_GROWN_BAD_UPDATE_NONE;
     }
 
-    // by default, the request start from the first die
-    sliceAllocationTargetDie = FindDieForFreeSliceAllocation();
-
     InitSliceMap();
     InitBlockDieMap();
 }
 
 /**
- * @brief Initialize Logical and Virtual Slick Map.
+ * @brief Initialize Logical Slice Map and the validity bitmaps.
  *
- * This function simply initialize all the slice addresses in the both map to NONE.
+ * This function simply initialize all the slice addresses in the logical slice map to NONE,
+ * and marks all the virtual slices invalid.
  */
 void InitSliceMap()
 {
+#if !SUPPORT_DFTL
     int sliceAddr;
+
+    // the logical slice map is not resident in DFTL mode, check `InitMapCache()`
     for (sliceAddr = 0; sliceAddr < SLICES_PER_SSD; sliceAddr++)
-    {
         logicalSliceMapPtr->logicalSlice[sliceAddr].virtualSliceAddr = VSA_NONE;
-        virtualSliceMapPtr->virtualSlice[sliceAddr].logicalSliceAddr = LSA_NONE;
-    }
+#endif
+
+    memset(validSliceMapPtr, 0, sizeof(VALID_SLICE_MAP));
 }
 
 /**
@@ -290,6 +291,10 @@ void InitDieMap()
  *  - If the target physical block of the virtual block is non-bad block, add the virtual
  *    block into free block list; otherwise, ignore and avoid to use the virtual block.
  *
+ *  - The last `OCSSD_PHY_BLOCKS_PER_DIE` virtual blocks of each die are reserved for the
+ *    physical address commands, they are never added into the free block list, so the FTL
+ *    will never allocate, collect or migrate them.
+ *
  * @sa
  *  - `Vblock2PblockOfTbsTranslation` defines the V2P mapping rule.
  *  - `InitAddressMap` and `RemapBadBlock()` defines bad block remapping rule.
@@ -307,19 +312,18 @@ void InitBlockMap()
         {
             phyBlockNo       = Vblock2PblockOfTbsTranslation(virtualBlockNo);
             remappedPhyBlock = phyBlockMapPtr->phyBlock[dieNo][phyBlockNo].remappedPhyBlock;
-            virtualBlockMapPtr->block[dieNo][virtualBlockNo].bad =
-                phyBlockMapPtr->phyBlock[dieNo][remappedPhyBlock].bad;
+            VBLK_BAD(dieNo, virtualBlockNo) = phyBlockMapPtr->phyBlock[dieNo][remappedPhyBlock].bad;
 
-            virtualBlockMapPtr->block[dieNo][virtualBlockNo].free            = 1;
-            virtualBlockMapPtr->block[dieNo][virtualBlockNo].invalidSliceCnt = 0;
-            virtualBlockMapPtr->block[dieNo][virtualBlockNo].currentPage     = 0;
-            virtualBlockMapPtr->block[dieNo][virtualBlockNo].eraseCnt        = 0;
+            VBLK_FREE(dieNo, virtualBlockNo)         = (virtualBlockNo < FTL_BLOCKS_PER_DIE);
+            VBLK_INVALID_CNT(dieNo, virtualBlockNo)  = 0;
+            VBLK_CURRENT_PAGE(dieNo, virtualBlockNo) = 0;
+            VBLK_ERASE_CNT(dieNo, virtualBlockNo)    = 0;
 
-            // bad block should not be added to free block list
-            if (virtualBlockMapPtr->block[dieNo][virtualBlockNo].bad)
+            // bad block and reserved block should not be added to free block list
+            if (VBLK_BAD(dieNo, virtualBlockNo) || !VBLK_FREE(dieNo, virtualBlockNo))
             {
-                virtualBlockMapPtr->block[dieNo][virtualBlockNo].prevBlock = BLOCK_NONE;
-                virtualBlockMapPtr->block[dieNo][virtualBlockNo].nextBlock = BLOCK_NONE;
+                VBLK_PREV_IDX(dieNo, virtualBlockNo) = BLOCK_NONE;
+                VBLK_NEXT_IDX(dieNo, virtualBlockNo) = BLOCK_NONE;
             }
             else
                 PutToFbList(dieNo, virtualBlockNo);
@@ -773,6 +777,9 @@ void EraseTotalBlockSpace()
 
 /**
  * @brief Erase all the non-bad main blocks on user dies and wait until done.
+ *
+ * @note The blocks reserved for the physical address commands are owned by the host, so
+ * they are left as they are.
  */
 void EraseUserBlockSpace()
 {
@@ -780,9 +787,9 @@ void EraseUserBlockSpace()
 
     xil_printf("Erase User block space...wait for a minute...\r\n");
 
-    for (blockNo = 0; blockNo < USER_BLOCKS_PER_DIE; blockNo++)
+    for (blockNo = 0; blockNo < FTL_BLOCKS_PER_DIE; blockNo++)
         for (dieNo = 0; dieNo < USER_DIES; dieNo++)
-            if (!virtualBlockMapPtr->block[dieNo][blockNo].bad)
+            if (!VBLK_BAD(dieNo, blockNo))
             {
                 reqSlotTag = GetFromFreeReqQ();
 
@@ -874,7 +881,7 @@ unsigned int AddrTransRead(unsigned int logicalSliceAddr)
 
     if (logicalSliceAddr < SLICES_PER_SSD)
     {
-        virtualSliceAddr = logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
+        virtualSliceAddr = GetMappedVsa(logicalSliceAddr);
 
         if (virtualSliceAddr != VSA_NONE)
             return virtualSliceAddr;
@@ -908,10 +915,10 @@ unsigned int AddrTransWrite(unsigned int logicalSliceAddr)
     {
         InvalidateOldVsa(logicalSliceAddr);
 
-        virtualSliceAddr = FindFreeVirtualSlice();
+        virtualSliceAddr = FindFreeVirtualSlice(FindDieForFreeSliceAllocation(logicalSliceAddr));
 
-        logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = virtualSliceAddr;
-        virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
+        SetMappedVsa(logicalSliceAddr, virtualSliceAddr);
+        SET_VSA_VALID(virtualSliceAddr);
 
         return virtualSliceAddr;
     }
@@ -919,18 +926,37 @@ unsigned int AddrTransWrite(unsigned int logicalSliceAddr)
         assert(!"[WARNING] Logical address is larger than maximum logical address served by SSD [WARNING]");
 }
 
+/**
+ * @brief Remove the mapping of the specified logical slice.
+ *
+ * The old virtual slice is invalidated as it was overwritten, and the logical slice will be
+ * read as zeros until it is written again, check `DataReadFromNand()`.
+ *
+ * @param logicalSliceAddr the logical address of the target slice.
+ */
+void AddrTransUnmap(unsigned int logicalSliceAddr)
+{
+    if (logicalSliceAddr < SLICES_PER_SSD)
+    {
+        InvalidateOldVsa(logicalSliceAddr);
+        SetMappedVsa(logicalSliceAddr, VSA_NONE);
+    }
+    else
+        assert(!"[WARNING] Logical address is larger than maximum logical address served by SSD [WARNING]");
+}
+
 /**
  * @brief Select a free physical page (virtual slice).
  *
  * In current implementation, the target page to serve the write request is determined by
  * checking the following three variables:
  *
- *  - `sliceAllocationTargetDie`:
+ *  - `dieNo`:
  *
  *      The die where the next request should be issued to.
  *
  *      To exploit the parallelism of each die, especially under write-intensive workload,
- *      the write requests will be interleaved to each die.
+ *      the write requests will be interleaved to each die of the namespace.
  *
  *      Check `FindDieForFreeSliceAllocation()` for details.
  *
@@ -943,34 +969,38 @@ unsigned int AddrTransWrite(unsigned int logicalSliceAddr)
  *      current working block are used, the fw will select a new free block from the free
  *      block list as the new current working block of that die.
  *
- *      If there the free block list of that die is empty, the fw will try to release
- *      invalid blocks by doing GC.
+ *      Before the free block list of that die becomes empty, the fw starts releasing
+ *      invalid blocks by doing GC in bounded steps, one step before each write. If the
+ *      list is still empty, the ongoing GC is finished at once.
  *
- *      Check `GetFromFbList()` and `GarbageCollection()` for the details.
+ *      Check `GetFromFbList()`, `IncrementalGarbageCollection()` and `GarbageCollection()`
+ *      for the details.
  *
- *  - `VIRTUAL_BLOCK_ENTRY::currentPage`:
+ *  - `VBLK_CURRENT_PAGE()`:
  *
  *      The current working page of the current working block on the die.
  *
  *      Current implementation just selects the free page sequentially from the current
  *      working block.
  *
- * @sa `VIRTUAL_DIE_ENTRY`, `VIRTUAL_BLOCK_ENTRY`, `FindDieForFreeSliceAllocation()`.
+ * @sa `VIRTUAL_DIE_ENTRY`, `VIRTUAL_BLOCK_MAP`, `FindDieForFreeSliceAllocation()`.
  *
  * @warning why the `currentPage` might be full after GC?
- * @warning why assign dieNo before return? redundant?
  *
+ * @param dieNo the die to serve the write request.
  * @return unsigned int the VSA for the request.
  */
-unsigned int FindFreeVirtualSlice()
+unsigned int FindFreeVirtualSlice(unsigned int dieNo)
 {
-    unsigned int currentBlock, virtualSliceAddr, dieNo;
+    unsigned int currentBlock, virtualSliceAddr;
+
+    // the GC may replace the current block, so do it first
+    IncrementalGarbageCollection(dieNo);
 
-    dieNo        = sliceAllocationTargetDie;
     currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
 
     // if the currently used block is full, assign a free block as new current block
-    if (virtualBlockMapPtr->block[dieNo][currentBlock].currentPage == USER_PAGES_PER_BLOCK)
+    if (VBLK_CURRENT_PAGE(dieNo, currentBlock) == USER_PAGES_PER_BLOCK)
     {
         currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_NORMAL);
 
@@ -982,7 +1012,7 @@ unsigned int FindFreeVirtualSlice()
             currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
 
             // FIXME: why need to check whether `currentPage` is full?
-            if (virtualBlockMapPtr->block[dieNo][currentBlock].currentPage == USER_PAGES_PER_BLOCK)
+            if (VBLK_CURRENT_PAGE(dieNo, currentBlock) == USER_PAGES_PER_BLOCK)
             {
                 currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_NORMAL);
                 if (currentBlock != BLOCK_FAIL)
@@ -990,18 +1020,49 @@ unsigned int FindFreeVirtualSlice()
                 else
                     assert(!"[WARNING] There is no available block [WARNING]");
             }
-            else if (virtualBlockMapPtr->block[dieNo][currentBlock].currentPage > USER_PAGES_PER_BLOCK)
+            else if (VBLK_CURRENT_PAGE(dieNo, currentBlock) > USER_PAGES_PER_BLOCK)
                 assert(!"[WARNING] Current page management fail [WARNING]");
         }
     }
-    else if (virtualBlockMapPtr->block[dieNo][currentBlock].currentPage > USER_PAGES_PER_BLOCK)
+    else if (VBLK_CURRENT_PAGE(dieNo, currentBlock) > USER_PAGES_PER_BLOCK)
+        assert(!"[WARNING] Current page management fail [WARNING]");
+
+    virtualSliceAddr =
+        Vorg2VsaTranslation(dieNo, currentBlock, VBLK_CURRENT_PAGE(dieNo, currentBlock));
+    VBLK_CURRENT_PAGE(dieNo, currentBlock)++;
+    return virtualSliceAddr;
+}
+
+/**
+ * @brief Select a free virtual slice on the specified die without triggering GC.
+ *
+ * Similar to `FindFreeVirtualSlice()`, but fails instead of doing GC if the current block
+ * is full and no free block is left for normal requests. This is used by the map cache,
+ * which may write back translation pages in the middle of a GC.
+ *
+ * @param dieNo the die to allocate the free slice.
+ * @return unsigned int the free virtual slice address, or `VSA_FAIL` if GC is needed.
+ */
+unsigned int FindFreeVirtualSliceWithoutGc(unsigned int dieNo)
+{
+    unsigned int currentBlock, virtualSliceAddr;
+
+    currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
+
+    if (VBLK_CURRENT_PAGE(dieNo, currentBlock) == USER_PAGES_PER_BLOCK)
+    {
+        currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_NORMAL);
+        if (currentBlock == BLOCK_FAIL)
+            return VSA_FAIL;
+
+        virtualDieMapPtr->die[dieNo].currentBlock = currentBlock;
+    }
+    else if (VBLK_CURRENT_PAGE(dieNo, currentBlock) > USER_PAGES_PER_BLOCK)
         assert(!"[WARNING] Current page management fail [WARNING]");
 
     virtualSliceAddr =
-        Vorg2VsaTranslation(dieNo, currentBlock, virtualBlockMapPtr->block[dieNo][currentBlock].currentPage);
-    virtualBlockMapPtr->block[dieNo][currentBlock].currentPage++;
-    sliceAllocationTargetDie = FindDieForFreeSliceAllocation(); // sliceAllocationTargetDie should be updated
-    dieNo                    = sliceAllocationTargetDie;        // don't merge the 2 lines
+        Vorg2VsaTranslation(dieNo, currentBlock, VBLK_CURRENT_PAGE(dieNo, currentBlock));
+    VBLK_CURRENT_PAGE(dieNo, currentBlock)++;
     return virtualSliceAddr;
 }
 
@@ -1018,7 +1079,7 @@ unsigned int FindFreeVirtualSliceForGc(unsigned int copyTargetDieNo, unsigned in
     }
     currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
 
-    if (virtualBlockMapPtr->block[dieNo][currentBlock].currentPage == USER_PAGES_PER_BLOCK)
+    if (VBLK_CURRENT_PAGE(dieNo, currentBlock) == USER_PAGES_PER_BLOCK)
     {
 
         currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_GC);
@@ -1028,41 +1089,45 @@ unsigned int FindFreeVirtualSliceForGc(unsigned int copyTargetDieNo, unsigned in
         else
             assert(!"[WARNING] There is no available block [WARNING]");
     }
-    else if (virtualBlockMapPtr->block[dieNo][currentBlock].currentPage > USER_PAGES_PER_BLOCK)
+    else if (VBLK_CURRENT_PAGE(dieNo, currentBlock) > USER_PAGES_PER_BLOCK)
         assert(!"[WARNING] Current page management fail [WARNING]");
 
     virtualSliceAddr =
-        Vorg2VsaTranslation(dieNo, currentBlock, virtualBlockMapPtr->block[dieNo][currentBlock].currentPage);
-    virtualBlockMapPtr->block[dieNo][currentBlock].currentPage++;
+        Vorg2VsaTranslation(dieNo, currentBlock, VBLK_CURRENT_PAGE(dieNo, currentBlock));
+    VBLK_CURRENT_PAGE(dieNo, currentBlock)++;
     return virtualSliceAddr;
 }
 
 /**
- * @brief Update and get the die number to serve the next write request.
+ * @brief Update and get the die number to serve the next write request of a namespace.
  *
  * To exploit the parallelism, the write request should first be interleaved on different
  * channels to take advantage of the channel parallelism. If all the channels' same way
  * are used, select the next way of each channel to use the die parallelism.
  *
+ * Since the dies are numbered channel first, this is done by simply selecting the dies of
+ * the die set of the namespace in order, so the namespaces with disjoint die sets never
+ * write to the same die.
+ *
  * @warning As paper the mentioned, may not perform well if latency largely varied.
  *
+ * @sa `NAMESPACE_ENTRY`, `Pcw2VdieTranslation()`.
+ *
+ * @param logicalSliceAddr the logical slice to be written.
  * @return unsigned int The target die number.
  */
-unsigned int FindDieForFreeSliceAllocation()
+unsigned int FindDieForFreeSliceAllocation(unsigned int logicalSliceAddr)
 {
-    static unsigned char targetCh  = 0;
-    static unsigned char targetWay = 0;
-    unsigned int targetDie;
+    unsigned int nsid, targetDie;
+    NAMESPACE_ENTRY *ns;
 
-    targetDie = Pcw2VdieTranslation(targetCh, targetWay);
+    nsid = GetNamespaceId(logicalSliceAddr);
+    if (nsid == NSID_NONE)
+        assert(!"[WARNING] The logical slice belongs to no namespace [WARNING]");
 
-    if (targetCh != (USER_CHANNELS - 1))
-        targetCh = targetCh + 1;
-    else
-    {
-        targetCh  = 0;
-        targetWay = (targetWay + 1) % USER_WAYS;
-    }
+    ns            = NS_ENTRY(nsid);
+    targetDie     = ns->targetDie;
+    ns->targetDie = ns->firstDie + (targetDie - ns->firstDie + 1) % ns->numOfDie;
 
     return targetDie;
 }
@@ -1078,39 +1143,51 @@ unsigned int FindDieForFreeSliceAllocation()
  * before, we should check if the corresponding physical page exists before doing GC on
  * the invalidated physical page.
  *
+ * Invalidating a slice only clears its bit in the validity bitmap, check `VALID_SLICE_MAP`.
+ *
  * @param logicalSliceAddr LSA that specifies the virtual slice to be invalidated.
  */
 void InvalidateOldVsa(unsigned int logicalSliceAddr)
 {
     unsigned int virtualSliceAddr, dieNo, blockNo;
 
-    virtualSliceAddr = logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
+    virtualSliceAddr = GetMappedVsa(logicalSliceAddr);
 
     if (virtualSliceAddr != VSA_NONE)
     {
-        if (virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr != logicalSliceAddr)
+        if (!IS_VSA_VALID(virtualSliceAddr))
             return;
 
+        CLR_VSA_VALID(virtualSliceAddr);
         dieNo   = Vsa2VdieTranslation(virtualSliceAddr);
         blockNo = Vsa2VblockTranslation(virtualSliceAddr);
 
+        // the victim of an ongoing GC is not in any victim list, and will be erased soon
+        if (blockNo == gcVictimMapPtr->victimBlock[dieNo])
+        {
+            VBLK_INVALID_CNT(dieNo, blockNo)++;
+            SetMappedVsa(logicalSliceAddr, VSA_NONE);
+            return;
+        }
+
         // unlink
         SelectiveGetFromGcVictimList(dieNo, blockNo);
-        virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt++;
-        logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = VSA_NONE;
+        VBLK_INVALID_CNT(dieNo, blockNo)++;
+        SetMappedVsa(logicalSliceAddr, VSA_NONE);
 
-        PutToGcVictimList(dieNo, blockNo, virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt);
+        PutToGcVictimList(dieNo, blockNo, VBLK_INVALID_CNT(dieNo, blockNo));
     }
 }
 
 /**
- * @brief Erase the specified block of the specified die and discard its LSAs.
+ * @brief Erase the specified block of the specified die and invalidate its slices.
  *
  * This function will:
  *
  * - Send a ERASE request to erase the specified block
  * - Move the specified block to free block list
- * - Discard all the logical slice addresses of the origin block
+ * - Clear the validity bitmap of the specified block
+ * - Update the state of the static wear leveling, check `CheckWearLeveling()`
  *
  * @todo programmedPageCnt
  *
@@ -1121,7 +1198,7 @@ void InvalidateOldVsa(unsigned int logicalSliceAddr)
  */
 void EraseBlock(unsigned int dieNo, unsigned int blockNo)
 {
-    unsigned int pageNo, virtualSliceAddr, reqSlotTag;
+    unsigned int reqSlotTag;
 
     reqSlotTag = GetFromFreeReqQ();
 
@@ -1132,54 +1209,69 @@ void EraseBlock(unsigned int dieNo, unsigned int blockNo)
     reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
     reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
     reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr     = Vorg2VsaTranslation(dieNo, blockNo, 0);
-    reqPoolPtr->reqPool[reqSlotTag].nandInfo.programmedPageCnt =
-        virtualBlockMapPtr->block[dieNo][blockNo].currentPage;
+    reqPoolPtr->reqPool[reqSlotTag].nandInfo.programmedPageCnt    = VBLK_CURRENT_PAGE(dieNo, blockNo);
 
     SelectLowLevelReqQ(reqSlotTag);
 
     // block map indicated blockNo initialization
-    virtualBlockMapPtr->block[dieNo][blockNo].free = 1;
-    virtualBlockMapPtr->block[dieNo][blockNo].eraseCnt++;
-    virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt = 0;
-    virtualBlockMapPtr->block[dieNo][blockNo].currentPage     = 0;
+    VBLK_FREE(dieNo, blockNo) = 1;
+    VBLK_ERASE_CNT(dieNo, blockNo)++;
+    VBLK_INVALID_CNT(dieNo, blockNo)  = 0;
+    VBLK_CURRENT_PAGE(dieNo, blockNo) = 0;
 
     PutToFbList(dieNo, blockNo);
 
-    for (pageNo = 0; pageNo < USER_PAGES_PER_BLOCK; pageNo++)
-    {
-        virtualSliceAddr = Vorg2VsaTranslation(dieNo, blockNo, pageNo);
-        virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr = LSA_NONE;
-    }
+    memset(validSliceMapPtr->validBitmap[dieNo][blockNo], 0, VALID_BITMAP_WORDS_PER_BLOCK * sizeof(unsigned int));
+
+    CheckWearLeveling(dieNo, blockNo);
 }
 
 /**
- * @brief Append the given virtual block to the free block list of its die.
+ * @brief Insert the given virtual block to the free block list of its die.
+ *
+ * The free block list is kept in ascending order of the erase counts, and the blocks with
+ * the same erase count are kept in FIFO order, so `GetFromFbList()` always allocates the
+ * least erased free block (dynamic wear leveling). A newly erased block is usually one of
+ * the most erased blocks, so the position is searched from the tail.
+ *
+ * @sa `WEAR_LEVELING_MAP` for the static wear leveling.
  *
  * @param dieNo the die number of the given block.
  * @param blockNo VBN of the specified block.
  */
 void PutToFbList(unsigned int dieNo, unsigned int blockNo)
 {
-    if (virtualDieMapPtr->die[dieNo].tailFreeBlock != BLOCK_NONE)
+    unsigned int prevBlock, nextBlock;
+
+    prevBlock = virtualDieMapPtr->die[dieNo].tailFreeBlock;
+    while ((prevBlock != BLOCK_NONE) && (VBLK_ERASE_CNT(dieNo, prevBlock) > VBLK_ERASE_CNT(dieNo, blockNo)))
+        prevBlock = VBLK_PREV_IDX(dieNo, prevBlock);
+
+    if (prevBlock != BLOCK_NONE)
     {
-        virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = virtualDieMapPtr->die[dieNo].tailFreeBlock;
-        virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-        virtualBlockMapPtr->block[dieNo][virtualDieMapPtr->die[dieNo].tailFreeBlock].nextBlock = blockNo;
-        virtualDieMapPtr->die[dieNo].tailFreeBlock                                             = blockNo;
+        nextBlock                       = VBLK_NEXT_IDX(dieNo, prevBlock);
+        VBLK_NEXT_IDX(dieNo, prevBlock) = blockNo;
     }
     else
     {
-        virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = BLOCK_NONE;
-        virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-        virtualDieMapPtr->die[dieNo].headFreeBlock          = blockNo;
-        virtualDieMapPtr->die[dieNo].tailFreeBlock          = blockNo;
+        nextBlock                                  = virtualDieMapPtr->die[dieNo].headFreeBlock;
+        virtualDieMapPtr->die[dieNo].headFreeBlock = blockNo;
     }
 
+    if (nextBlock != BLOCK_NONE)
+        VBLK_PREV_IDX(dieNo, nextBlock) = blockNo;
+    else
+        virtualDieMapPtr->die[dieNo].tailFreeBlock = blockNo;
+
+    VBLK_PREV_IDX(dieNo, blockNo) = prevBlock;
+    VBLK_NEXT_IDX(dieNo, blockNo) = nextBlock;
+
     virtualDieMapPtr->die[dieNo].freeBlockCnt++;
 }
 
 /**
- * @brief Pop the first block in the free block list of the specified die.
+ * @brief Pop the first block, which is the least erased one, in the free block list of the
+ * specified die.
  *
  * @note Each die will reserve some free blocks (`VIRTUAL_DIE_ENTRY::freeBlockCnt`), so if
  * the number of free blocks is less then the number of preserved blocks, `BLOCK_FAIL`
@@ -1210,11 +1302,10 @@ unsigned int GetFromFbList(unsigned int dieNo, unsigned int getFreeBlockOption)
     else
         assert(!"[WARNING] Wrong getFreeBlockOption [WARNING]");
 
-    if (virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock != BLOCK_NONE)
+    if (VBLK_NEXT_IDX(dieNo, evictedBlockNo) != BLOCK_NONE)
     {
-        virtualDieMapPtr->die[dieNo].headFreeBlock = virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock;
-        virtualBlockMapPtr->block[dieNo][virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock].prevBlock =
-            BLOCK_NONE;
+        virtualDieMapPtr->die[dieNo].headFreeBlock                  = VBLK_NEXT_IDX(dieNo, evictedBlockNo);
+        VBLK_PREV_IDX(dieNo, VBLK_NEXT_IDX(dieNo, evictedBlockNo)) = BLOCK_NONE;
     }
     else
     {
@@ -1222,11 +1313,11 @@ unsigned int GetFromFbList(unsigned int dieNo, unsigned int getFreeBlockOption)
         virtualDieMapPtr->die[dieNo].tailFreeBlock = BLOCK_NONE;
     }
 
-    virtualBlockMapPtr->block[dieNo][evictedBlockNo].free = 0;
+    VBLK_FREE(dieNo, evictedBlockNo) = 0;
     virtualDieMapPtr->die[dieNo].freeBlockCnt--;
 
-    virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock = BLOCK_NONE;
-    virtualBlockMapPtr->block[dieNo][evictedBlockNo].prevBlock = BLOCK_NONE;
+    VBLK_NEXT_IDX(dieNo, evictedBlockNo) = BLOCK_NONE;
+    VBLK_PREV_IDX(dieNo, evictedBlockNo) = BLOCK_NONE;
 
     return evictedBlockNo;
 }
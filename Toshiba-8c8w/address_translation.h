@@ -206,22 +206,29 @@ typedef struct _LOGICAL_SLICE_MAP
     LOGICAL_SLICE_ENTRY logicalSlice[SLICES_PER_SSD];
 } LOGICAL_SLICE_MAP, *P_LOGICAL_SLICE_MAP;
 
+#define VALID_BITMAP_WORDS_PER_BLOCK (SLICES_PER_BLOCK / 32)
+
 /**
- * @brief Exactly the Logical Slice Address
+ * @brief The validity bitmaps of the virtual slices, one bit per slice.
+ *
+ * A bit is set once the slice is allocated to a logical slice, and cleared when the logical
+ * slice is overwritten or unmapped, or when the block is erased. There is no reverse map,
+ * the logical slice address is programmed into the spare region of the slice instead, check
+ * `SPARE_DATA_ENTRY`, so the GC only reads the valid slices to find their owners.
  */
-typedef struct _VIRTUAL_SLICE_ENTRY
+typedef struct _VALID_SLICE_MAP
 {
-    /* The corresponding logical slice address (index) of the virtual slice. */
-    unsigned int logicalSliceAddr;
-} VIRTUAL_SLICE_ENTRY, *P_VIRTUAL_SLICE_ENTRY;
+    unsigned int validBitmap[USER_DIES][USER_BLOCKS_PER_DIE][VALID_BITMAP_WORDS_PER_BLOCK];
+} VALID_SLICE_MAP, *P_VALID_SLICE_MAP;
 
 /**
- * @brief The Virtual -> Logical Slice mapping table.
+ * @brief The metadata at the beginning of the spare region of each slice programmed by the
+ * FTL, check `IssueNandReq()`.
  */
-typedef struct _VIRTUAL_SLICE_MAP
+typedef struct _SPARE_DATA_ENTRY
 {
-    VIRTUAL_SLICE_ENTRY virtualSlice[SLICES_PER_SSD];
-} VIRTUAL_SLICE_MAP, *P_VIRTUAL_SLICE_MAP;
+    unsigned int logicalSliceAddr; // the owner of the slice when it was programmed
+} SPARE_DATA_ENTRY, *P_SPARE_DATA_ENTRY;
 
 /* -------------------------------------------------------------------------- */
 /*               Structures for managing Virtual Block Metadata               */
@@ -237,17 +244,25 @@ typedef struct _VIRTUAL_BLOCK_ENTRY
     unsigned int invalidSliceCnt : 16; // how many invalid slices in this block
     unsigned int reserved0 : 10;       //
     unsigned int currentPage : 16;     // the current working page number of this block
-    unsigned int eraseCnt : 16;        // how many times this block have been erased
+    unsigned int reserved1 : 16;       // the erase count is kept in `VIRTUAL_BLOCK_MAP::eraseCnt`
     unsigned int prevBlock : 16;       // VBN of the prev block in free/victim block list
     unsigned int nextBlock : 16;       // VBN of the next block in free/victim block list
 } VIRTUAL_BLOCK_ENTRY, *P_VIRTUAL_BLOCK_ENTRY;
 
 /**
  * @brief The block metadata table for all the blocks.
+ *
+ * The erase counts are kept in a dense array apart from the entries, so the scans over all
+ * the blocks (e.g. `GetAvgEraseCnt()`) read 2 bytes per block instead of a 12-byte entry.
+ * The cost is an extra cache line per block on the walk of `PutToFbList()`, the other hot
+ * paths are unchanged, check `tools/vblock_layout_sim.c`.
+ *
+ * The fields should be accessed by `VBLK_*()`, e.g. `VBLK_INVALID_CNT(iDie, iBlk)++`.
  */
 typedef struct _VIRTUAL_BLOCK_MAP
 {
     VIRTUAL_BLOCK_ENTRY block[USER_DIES][USER_BLOCKS_PER_DIE];
+    unsigned short eraseCnt[USER_DIES][USER_BLOCKS_PER_DIE]; // how many times this block have been erased
 } VIRTUAL_BLOCK_MAP, *P_VIRTUAL_BLOCK_MAP;
 
 /**
@@ -329,9 +344,11 @@ void InitBlockDieMap();
 
 unsigned int AddrTransRead(unsigned int logicalSliceAddr);
 unsigned int AddrTransWrite(unsigned int logicalSliceAddr);
-unsigned int FindFreeVirtualSlice();
+void AddrTransUnmap(unsigned int logicalSliceAddr);
+unsigned int FindFreeVirtualSlice(unsigned int dieNo);
+unsigned int FindFreeVirtualSliceWithoutGc(unsigned int dieNo);
 unsigned int FindFreeVirtualSliceForGc(unsigned int copyTargetDieNo, unsigned int victimBlockNo);
-unsigned int FindDieForFreeSliceAllocation();
+unsigned int FindDieForFreeSliceAllocation(unsigned int logicalSliceAddr);
 
 void InvalidateOldVsa(unsigned int logicalSliceAddr);
 void EraseBlock(unsigned int dieNo, unsigned int blockNo);
@@ -343,13 +360,12 @@ void UpdatePhyBlockMapForGrownBadBlock(unsigned int dieNo, unsigned int phyBlock
 void UpdateBadBlockTableForGrownBadBlock(unsigned int tempBufAddr);
 
 extern P_LOGICAL_SLICE_MAP logicalSliceMapPtr;
-extern P_VIRTUAL_SLICE_MAP virtualSliceMapPtr;
+extern P_VALID_SLICE_MAP validSliceMapPtr;
 extern P_VIRTUAL_BLOCK_MAP virtualBlockMapPtr;
 extern P_VIRTUAL_DIE_MAP virtualDieMapPtr;
 extern P_PHY_BLOCK_MAP phyBlockMapPtr;
 extern P_BAD_BLOCK_TABLE_INFO_MAP bbtInfoMapPtr;
 
-extern unsigned char sliceAllocationTargetDie;
 extern unsigned int mbPerbadBlockSpace;
 
 /* -------------------------------------------------------------------------- */
@@ -362,17 +378,25 @@ extern unsigned int mbPerbadBlockSpace;
 #define VDIE_PREV_ENTRY(iDie) (VDIE_ENTRY(VDIE_PREV_IDX((iDie))))
 #define VDIE_NEXT_ENTRY(iDie) (VDIE_ENTRY(VDIE_NEXT_IDX((iDie))))
 
-#define VBLK_ENTRY(iDie, iBlk)      (&virtualBlockMapPtr->block[(iDie)][(iBlk)])
-#define VBLK_PREV_IDX(iDie, iBlk)   (VBLK_ENTRY((iDie), (iBlk))->prevBlock)
-#define VBLK_NEXT_IDX(iDie, iBlk)   (VBLK_ENTRY((iDie), (iBlk))->nextBlock)
-#define VBLK_PREV_ENTRY(iDie, iBlk) (VBLK_ENTRY((iDie), VBLK_PREV_IDX((iDie), (iBlk))))
-#define VBLK_NEXT_ENTRY(iDie, iBlk) (VBLK_ENTRY((iDie), VBLK_NEXT_IDX((iDie), (iBlk))))
-#define PBLK_ENTRY(iDie, iBlk)      (&phyBlockMapPtr->phyBlock[(iDie)][(iBlk)])
+#define VBLK_ENTRY(iDie, iBlk)        (&virtualBlockMapPtr->block[(iDie)][(iBlk)])
+#define VBLK_BAD(iDie, iBlk)          (VBLK_ENTRY((iDie), (iBlk))->bad)
+#define VBLK_FREE(iDie, iBlk)         (VBLK_ENTRY((iDie), (iBlk))->free)
+#define VBLK_INVALID_CNT(iDie, iBlk)  (VBLK_ENTRY((iDie), (iBlk))->invalidSliceCnt)
+#define VBLK_PREV_IDX(iDie, iBlk)     (VBLK_ENTRY((iDie), (iBlk))->prevBlock)
+#define VBLK_NEXT_IDX(iDie, iBlk)     (VBLK_ENTRY((iDie), (iBlk))->nextBlock)
+#define VBLK_CURRENT_PAGE(iDie, iBlk) (VBLK_ENTRY((iDie), (iBlk))->currentPage)
+#define VBLK_ERASE_CNT(iDie, iBlk)    (virtualBlockMapPtr->eraseCnt[(iDie)][(iBlk)])
+#define PBLK_ENTRY(iDie, iBlk)        (&phyBlockMapPtr->phyBlock[(iDie)][(iBlk)])
 
 #define LSA_ENTRY(lsa) (&logicalSliceMapPtr->logicalSlice[(lsa)])
-#define VSA_ENTRY(vsa) (&virtualSliceMapPtr->virtualSlice[(vsa)])
 #define LSA2VSA(lsa)   (LSA_ENTRY((lsa))->virtualSliceAddr)
-#define VSA2LSA(vsa)   (VSA_ENTRY((vsa))->logicalSliceAddr)
+
+#define VSA_VALID_WORD(vsa)                                                                                       \
+    (validSliceMapPtr->validBitmap[VSA2VDIE((vsa))][VSA2VBLK((vsa))][VSA2VPAGE((vsa)) / 32])
+#define VSA_VALID_MASK(vsa) (1U << (VSA2VPAGE((vsa)) % 32))
+#define IS_VSA_VALID(vsa)   ((VSA_VALID_WORD((vsa)) & VSA_VALID_MASK((vsa))) != 0)
+#define SET_VSA_VALID(vsa)  (VSA_VALID_WORD((vsa)) |= VSA_VALID_MASK((vsa)))
+#define CLR_VSA_VALID(vsa)  (VSA_VALID_WORD((vsa)) &= ~VSA_VALID_MASK((vsa)))
 
 #define VDIE2PCH(iDie)              (Vdie2PchTranslation((iDie)))
 #define VDIE2PWAY(iDie)             (Vdie2PwayTranslation((iDie)))
@@ -126,11 +126,23 @@ void InitDataBuf()
  */
 unsigned int CheckDataBufHit(unsigned int reqSlotTag)
 {
-    unsigned int bufEntry, logicalSliceAddr;
+    return CheckDataBufHitByLsa(reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr);
+}
 
-    // get the bucket index of the given request
-    logicalSliceAddr = reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr;
-    bufEntry         = dataBufHashTablePtr->dataBufHash[FindDataBufHashTableEntry(logicalSliceAddr)].headEntry;
+/**
+ * @brief Get the data buffer entry index of the given logical slice.
+ *
+ * Same as `CheckDataBufHit()`, but the logical slice is specified directly, for the slices
+ * not owned by any request (e.g., the source slice of a Copy command).
+ *
+ * @param logicalSliceAddr the logical slice address to be checked.
+ */
+unsigned int CheckDataBufHitByLsa(unsigned int logicalSliceAddr)
+{
+    unsigned int bufEntry;
+
+    // get the bucket index of the given logical slice
+    bufEntry = dataBufHashTablePtr->dataBufHash[FindDataBufHashTableEntry(logicalSliceAddr)].headEntry;
 
     // traverse the bucket and try to find the data buffer entry of target request
     while (bufEntry != DATA_BUF_NONE)
@@ -322,6 +334,16 @@ void PutToDataBufHashList(unsigned int bufEntry)
 
     hashEntry = FindDataBufHashTableEntry(dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr);
 
+#ifdef DEBUG
+    // a slice cached by two entries lets the stale one serve reads after the other is evicted
+    unsigned int iEntry;
+
+    for (iEntry = dataBufHashTablePtr->dataBufHash[hashEntry].headEntry; iEntry != DATA_BUF_NONE;
+         iEntry = dataBufMapPtr->dataBuf[iEntry].hashNextEntry)
+        if (dataBufMapPtr->dataBuf[iEntry].logicalSliceAddr == dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr)
+            assert(!"[WARNING] The logical slice is already cached [WARNING]");
+#endif
+
     if (dataBufHashTablePtr->dataBufHash[hashEntry].tailEntry != DATA_BUF_NONE)
     {
         dataBufMapPtr->dataBuf[bufEntry].hashPrevEntry = dataBufHashTablePtr->dataBufHash[hashEntry].tailEntry;
@@ -181,6 +181,7 @@ typedef struct _TEMPORARY_DATA_BUF_MAP
 
 void InitDataBuf();
 unsigned int CheckDataBufHit(unsigned int reqSlotTag);
+unsigned int CheckDataBufHitByLsa(unsigned int logicalSliceAddr);
 unsigned int AllocateDataBuf();
 void UpdateDataBufEntryInfoBlockingReq(unsigned int bufEntry, unsigned int reqSlotTag);
 
@@ -221,4 +222,6 @@ extern P_TEMPORARY_DATA_BUF_MAP tempDataBufMapPtr;
 #define BUF_DATA_ENTRY2ADDR(iEntry)  (DATA_BUFFER_BASE_ADDR + ((iEntry)*BYTES_PER_DATA_REGION_OF_SLICE))
 #define BUF_SPARE_ENTRY2ADDR(iEntry) (SPARE_DATA_BUFFER_BASE_ADDR + ((iEntry)*BYTES_PER_SPARE_REGION_OF_SLICE))
 
+#define BUF_TEMP_ENTRY2ADDR(iEntry) (TEMPORARY_DATA_BUFFER_BASE_ADDR + ((iEntry)*BYTES_PER_DATA_REGION_OF_SLICE))
+
 #endif /* DATA_BUFFER_H_ */
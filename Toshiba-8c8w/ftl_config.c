@@ -69,25 +69,33 @@ void InitFTL()
     InitReqScheduler();    //
     InitNandArray();       // "[ NAND device reset complete. ]"
     InitAddressMap();      // "Press 'X' to re-make the bad block table."
+    InitMapCache();        // the logical slice map stays in DRAM until the host enables HMB
     InitDataBuf();         //
     InitGcVictimMap();     //
+    InitWearLeveling();    //
+    InitStatistics();      //
+    InitWriteThrottle();   // the GC copies are counted from the statistics
 
     /*
      * MB_PER_BLOCK                         == 16384 * 256 / (1024 * 1024) == 4
      * MB_PER_SSD                           == USER_BLOCKS_PER_DIE * USER_DIES * MB_PER_BLOCK == 524288
      * MB_PER_MIN_FREE_BLOCK_SPACE          == USER_DIES * MB_PER_BLOCK
      * MB_PER_OVER_PROVISION_BLOCK_SPACE    == (USER_BLOCKS_PER_DIE * USER_DIES / 10) * MB_PER_BLOCK
+     * MB_PER_OCSSD_PHY_BLOCK_SPACE         == OCSSD_PHY_BLOCKS_PER_DIE * USER_DIES * MB_PER_BLOCK
      * BYTES_PER_NVME_BLOCK                 == 4096
      */
     pr_info("[Total bad blocks size: %d MB ]\r\n", mbPerbadBlockSpace); // calculated in `RemapBadBlock()`
     pr_info("[Total min free block size: %d MB ]\r\n", MB_PER_MIN_FREE_BLOCK_SPACE);
     pr_info("[Total over provision size: %d MB ]\r\n", MB_PER_OVER_PROVISION_BLOCK_SPACE);
+    pr_info("[Total physical address command block size: %d MB ]\r\n", MB_PER_OCSSD_PHY_BLOCK_SPACE);
 
-    storageCapacity_L =
-        (MB_PER_SSD - (MB_PER_MIN_FREE_BLOCK_SPACE + mbPerbadBlockSpace + MB_PER_OVER_PROVISION_BLOCK_SPACE)) *
-        ((1024 * 1024) / BYTES_PER_NVME_BLOCK);
+    storageCapacity_L = (MB_PER_SSD - (MB_PER_MIN_FREE_BLOCK_SPACE + mbPerbadBlockSpace +
+                                       MB_PER_OVER_PROVISION_BLOCK_SPACE + MB_PER_OCSSD_PHY_BLOCK_SPACE)) *
+                        ((1024 * 1024) / BYTES_PER_NVME_BLOCK);
 
     pr_info("[ storage capacity %d MB ]\r\n", storageCapacity_L / ((1024 * 1024) / BYTES_PER_NVME_BLOCK));
+
+    InitNamespace(); // the default namespace spans the whole storage capacity
     pr_info("[ ftl configuration complete. ]\r\n");
 }
 
@@ -248,13 +256,17 @@ void CheckConfigRestriction()
         assert(!"[WARNING] Configuration Error: WAY [WARNING]");
     if (USER_BLOCKS_PER_LUN > MAIN_BLOCKS_PER_LUN)
         assert(!"[WARNING] Configuration Error: BLOCK [WARNING]");
+    if (OCSSD_PHY_BLOCKS_PER_DIE >= USER_BLOCKS_PER_DIE / 2)
+        assert(!"[WARNING] Configuration Error: OCSSD_PHY_BLOCKS_PER_DIE [WARNING]");
     if ((BITS_PER_FLASH_CELL != SLC_MODE))
         assert(!"[WARNING] Configuration Error: BIT_PER_FLASH_CELL [WARNING]");
 
     // the size of some area are variable, make sure there is no overlap
-    if (RESERVED_DATA_BUFFER_BASE_ADDR + 0x00200000 > COMPLETE_FLAG_TABLE_ADDR)
+    if (MAP_CACHE_ENTRY_ADDR(MAP_CACHE_ENTRY_COUNT) > COMPLETE_FLAG_TABLE_ADDR)
         assert(!"[WARNING] Configuration Error: Data buffer size is too large to be allocated to predefined range "
                 "[WARNING]");
+    if ((MAP_SEGMENTS_PER_SSD > 0x10000) || (MAP_CACHE_ENTRY_COUNT >= MAP_CACHE_ENTRY_NONE))
+        assert(!"[WARNING] Configuration Error: Map cache [WARNING]");
     if (TEMPORARY_PAY_LOAD_ADDR + 0x00001000 > DATA_BUFFER_MAP_ADDR)
         assert(!"[WARNING] Configuration Error: Metadata for NAND request completion process is too large to be "
                 "allocated to predefined range [WARNING]");
@@ -157,6 +157,14 @@
 #define MAIN_ROWS_PER_SLC_LUN (ROWS_PER_SLC_BLOCK * MAIN_BLOCKS_PER_LUN)
 #define MAIN_ROWS_PER_MLC_LUN (ROWS_PER_MLC_BLOCK * MAIN_BLOCKS_PER_LUN)
 
+/**
+ * @note Multi-plane operations are not supported. The micro-code of the NAND storage
+ * controller only provides single-plane pSLC program/read commands; the commands like
+ * `T4NSC_CMD_PROGRAM_PAGES` and `T4NSC_CMD_FSP_PAGES` program the xSB pages of the same
+ * word line (check `T4NSC_CMD_FSP_TRANSFER_OPTION_*`), and the indexed transfer commands
+ * only gather the subpages of one page. So the scheduler cannot merge two requests of a
+ * die into one command, and pairing pages on sibling planes in the allocator won't help.
+ */
 #define LUNS_PER_DIE 1 /* number of planes in a die (way) */
 
 #define MAIN_BLOCKS_PER_DIE  (MAIN_BLOCKS_PER_LUN * LUNS_PER_DIE)
@@ -167,6 +175,13 @@
 #define BAD_BLOCK_MARK_BYTE0 0                                   // first byte of data region of the row
 #define BAD_BLOCK_MARK_BYTE1 (BYTES_PER_DATA_REGION_OF_NAND_ROW) // first byte of spare region of the row
 
+/**
+ * @brief The rated program/erase cycles of a block, used for estimating the life used.
+ *
+ * @todo replace with the endurance in the datasheet of the NAND package (pSLC mode).
+ */
+#define BLOCK_RATED_PE_CYCLES 30000
+
 //------------------------------------
 // NAND storage controller specifications
 //------------------------------------
@@ -202,10 +217,12 @@
 #define MLC_MODE 2
 
 //************************************************************************
-#define BITS_PER_FLASH_CELL SLC_MODE // user configurable factor
-#define USER_BLOCKS_PER_LUN 2048     // user configurable factor
-#define USER_CHANNELS       8        // user configurable factor
-#define USER_WAYS           8        // user configurable factor
+#define BITS_PER_FLASH_CELL      SLC_MODE // user configurable factor
+#define USER_BLOCKS_PER_LUN      2048     // user configurable factor
+#define USER_CHANNELS            8        // user configurable factor
+#define USER_WAYS                8        // user configurable factor
+#define SUPPORT_DFTL             0        // user configurable factor, 1 to page the logical slice map on NAND
+#define OCSSD_PHY_BLOCKS_PER_DIE 16       // user configurable factor, 0 to disable the physical address commands
 //************************************************************************
 
 // slice size, the mapping unit of FTL, equal to page size
@@ -231,6 +248,7 @@
 #define SLICES_PER_SSD     (USER_PAGES_PER_SSD * SLICES_PER_PAGE)
 
 #define USER_BLOCKS_PER_DIE     (USER_BLOCKS_PER_LUN * LUNS_PER_DIE)
+#define FTL_BLOCKS_PER_DIE      (USER_BLOCKS_PER_DIE - OCSSD_PHY_BLOCKS_PER_DIE) // the others are never allocated
 #define USER_BLOCKS_PER_CHANNEL (USER_BLOCKS_PER_DIE * USER_WAYS)
 #define USER_BLOCKS_PER_SSD     (USER_BLOCKS_PER_CHANNEL * USER_CHANNELS)
 
@@ -239,6 +257,7 @@
 #define MB_PER_MIN_FREE_BLOCK_SPACE       (USER_DIES * MB_PER_BLOCK)
 #define MB_PER_METADATA_BLOCK_SPACE       (USER_DIES * MB_PER_BLOCK)
 #define MB_PER_OVER_PROVISION_BLOCK_SPACE ((USER_BLOCKS_PER_SSD / 10) * MB_PER_BLOCK)
+#define MB_PER_OCSSD_PHY_BLOCK_SPACE      (USER_DIES * OCSSD_PHY_BLOCKS_PER_DIE * MB_PER_BLOCK)
 
 void InitFTL();
 void InitChCtlReg();
@@ -34,7 +34,8 @@
 //
 // Description:
 //   - select a victim block
-//   - collect valid pages to a free block
+//   - collect valid pages to a free block on the least busy die
+//   - collect a victim block in bounded steps between the host requests
 //   - erase a victim block to make a free block
 //////////////////////////////////////////////////////////////////////////////////
 
@@ -64,94 +65,457 @@ void InitGcVictimMap()
             gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = BLOCK_NONE;
             gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = BLOCK_NONE;
         }
+        gcVictimMapPtr->victimBlock[dieNo] = BLOCK_NONE;
+        gcVictimMapPtr->victimPage[dieNo]  = 0;
     }
+    gcVictimMapPtr->ongoingGcCnt = 0;
+    gcVictimMapPtr->idleGcDie    = 0;
 }
 
-void GarbageCollection(unsigned int dieNo)
+/**
+ * @brief Get the dies that can hold the valid slices of the specified die.
+ *
+ * A slice may only be moved within the die set of its namespace, but the owner of a slice
+ * is unknown until it is read. So the slices of a die are only moved within the die sets of
+ * all the namespaces on the die, which is a contiguous range of dies including the die.
+ *
+ * @sa `NAMESPACE_ENTRY`.
+ *
+ * @param dieNo the die to be collected.
+ * @param firstDie the first die of the range.
+ * @param numOfDie the number of dies of the range.
+ */
+static void GetDieRangeForGcCopy(unsigned int dieNo, unsigned int *firstDie, unsigned int *numOfDie)
+{
+    unsigned int nsid, rangeStart, rangeEnd;
+    NAMESPACE_ENTRY *ns;
+
+    rangeStart = 0;
+    rangeEnd   = USER_DIES;
+
+    for (nsid = 1; nsid <= MAX_NUM_OF_NAMESPACE; nsid++)
+    {
+        ns = NS_ENTRY(nsid);
+        if (!ns->allocated || (dieNo < ns->firstDie) || (dieNo >= ns->firstDie + ns->numOfDie))
+            continue;
+
+        if (rangeStart < ns->firstDie)
+            rangeStart = ns->firstDie;
+        if (rangeEnd > ns->firstDie + ns->numOfDie)
+            rangeEnd = ns->firstDie + ns->numOfDie;
+    }
+
+    *firstDie = rangeStart;
+    *numOfDie = rangeEnd - rangeStart;
+}
+
+/**
+ * @brief Get the number of NAND requests waiting on the specified die.
+ */
+static unsigned int GetDieQueueDepth(unsigned int dieNo)
+{
+    unsigned int chNo  = Vdie2PchTranslation(dieNo);
+    unsigned int wayNo = Vdie2PwayTranslation(dieNo);
+
+    return nandReqQ[chNo][wayNo].reqCnt + blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt;
+}
+
+/**
+ * @brief Select the die to program the next valid slice of the victim block.
+ *
+ * The least busy die of the range is selected, and the one with more free blocks wins the
+ * tie. The victim die itself is always a candidate, but the others must have more than
+ * `GC_COPY_MIN_FREE_BLOCK_COUNT` free blocks, so that the copies won't trigger another GC
+ * soon. The dies are scanned from the one after the previous target, so that the copies
+ * are spread over the idle dies in round-robin.
+ *
+ * @param victimDieNo the die being collected.
+ * @param firstDie the first die of the range, check `GetDieRangeForGcCopy()`.
+ * @param numOfDie the number of dies of the range.
+ * @param prevDieNo the target die of the previous copy.
+ * @return unsigned int the die to program the next valid slice.
+ */
+static unsigned int SelectDieForGcCopy(unsigned int victimDieNo, unsigned int firstDie, unsigned int numOfDie,
+                                       unsigned int prevDieNo)
+{
+    unsigned int iDie, dieNo, queueDepth, freeBlockCnt, targetDie, targetQueueDepth, targetFreeBlockCnt;
+
+    targetDie          = victimDieNo;
+    targetQueueDepth   = GetDieQueueDepth(victimDieNo);
+    targetFreeBlockCnt = virtualDieMapPtr->die[victimDieNo].freeBlockCnt;
+
+    for (iDie = 1; iDie <= numOfDie; iDie++)
+    {
+        dieNo = firstDie + (prevDieNo - firstDie + iDie) % numOfDie;
+        if ((dieNo == victimDieNo) || (gcVictimMapPtr->victimBlock[dieNo] != BLOCK_NONE))
+            continue;
+
+        freeBlockCnt = virtualDieMapPtr->die[dieNo].freeBlockCnt;
+        if (freeBlockCnt <= GC_COPY_MIN_FREE_BLOCK_COUNT)
+            continue;
+
+        queueDepth = GetDieQueueDepth(dieNo);
+        if ((queueDepth < targetQueueDepth) ||
+            ((queueDepth == targetQueueDepth) && (freeBlockCnt > targetFreeBlockCnt)))
+        {
+            targetDie          = dieNo;
+            targetQueueDepth   = queueDepth;
+            targetFreeBlockCnt = freeBlockCnt;
+        }
+    }
+
+    return targetDie;
+}
+
+/**
+ * @brief Check whether the specified die has a block worth collecting.
+ */
+static unsigned int IsGcVictimAvailable(unsigned int dieNo)
+{
+    int invalidSliceCnt;
+
+    for (invalidSliceCnt = SLICES_PER_BLOCK; invalidSliceCnt > 0; invalidSliceCnt--)
+        if (gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock != BLOCK_NONE)
+            return 1;
+
+    return 0;
+}
+
+/**
+ * @brief Get the average valid slices of the next victim blocks of the specified die.
+ *
+ * The victim lists are walked in the order `GetFromGcVictimList()` selects the victims, so
+ * the result is the copy cost of the next collections of the die.
+ *
+ * @param dieNo the die to be checked.
+ * @param victimCnt the max number of victim blocks to be averaged.
+ * @return unsigned int the average valid slices per victim block, or `SLICES_PER_BLOCK`
+ * if the die has no block worth collecting.
+ */
+unsigned int GetGcVictimValidSliceCnt(unsigned int dieNo, unsigned int victimCnt)
+{
+    unsigned int blockNo, foundCnt, validSliceCnt;
+    int invalidSliceCnt;
+
+    foundCnt      = 0;
+    validSliceCnt = 0;
+    for (invalidSliceCnt = SLICES_PER_BLOCK; (invalidSliceCnt > 0) && (foundCnt < victimCnt); invalidSliceCnt--)
+        for (blockNo = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock;
+             (blockNo != BLOCK_NONE) && (foundCnt < victimCnt); blockNo = VBLK_NEXT_IDX(dieNo, blockNo))
+        {
+            validSliceCnt += SLICES_PER_BLOCK - invalidSliceCnt;
+            foundCnt++;
+        }
+
+    return foundCnt ? (validSliceCnt / foundCnt) : SLICES_PER_BLOCK;
+}
+
+/**
+ * @brief Start collecting the specified victim block.
+ *
+ * @param dieNo the die to be collected.
+ * @param victimBlockNo the victim block, which must have been removed from the victim list.
+ */
+void StartGarbageCollection(unsigned int dieNo, unsigned int victimBlockNo)
+{
+    // the map cache may write back translation pages during GC, check `InvalidateOldVsa()`
+    gcVictimMapPtr->victimBlock[dieNo] = victimBlockNo;
+    gcVictimMapPtr->victimPage[dieNo]  = 0;
+    gcVictimMapPtr->ongoingGcCnt++;
+
+    // the victim may still be the current block, which must be replaced even if no copy is on this die
+    if (victimBlockNo == virtualDieMapPtr->die[dieNo].currentBlock)
+    {
+        virtualDieMapPtr->die[dieNo].currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_GC);
+        if (virtualDieMapPtr->die[dieNo].currentBlock == BLOCK_FAIL)
+            assert(!"[WARNING] There is no available block [WARNING]");
+    }
+
+    ssdTelemetry.gcCnt++;
+    ssdTelemetry.die[dieNo].gcCnt++;
+}
+
+/**
+ * @brief Stop collecting the victim block of the specified die before it is erased.
+ *
+ * The slices already copied stay invalid on the victim block, so the block is returned to
+ * the victim list with them, and may be selected again later like any other block.
+ *
+ * @param dieNo the die under GC.
+ */
+void StopGarbageCollection(unsigned int dieNo)
+{
+    unsigned int victimBlockNo = gcVictimMapPtr->victimBlock[dieNo];
+
+    // a block is only in the victim list after some of its slices are invalidated
+    if (VBLK_INVALID_CNT(dieNo, victimBlockNo))
+        PutToGcVictimList(dieNo, victimBlockNo, VBLK_INVALID_CNT(dieNo, victimBlockNo));
+
+    gcVictimMapPtr->victimBlock[dieNo] = BLOCK_NONE;
+    gcVictimMapPtr->ongoingGcCnt--;
+}
+
+/**
+ * @brief Collect at most `GC_COPY_PAGES_PER_STEP` valid slices of the victim block of the
+ * specified die, and erase the victim block once all of its valid slices are moved.
+ *
+ * The collection is resumed from `GC_VICTIM_MAP::victimPage`, so the host requests can be
+ * handled between the steps. A valid slice is invalidated on the victim block once it is
+ * copied, and the slices overwritten by the host meanwhile are simply skipped.
+ *
+ * The valid slices are always read from the victim die, but each of them is programmed to
+ * the least busy die selected by `SelectDieForGcCopy()`, so that the programs of a victim
+ * block are executed on several dies in parallel.
+ *
+ * Each copy uses the temp buffer entry of its target die. So the read of the next slice
+ * only waits for the previous program on the same target die, instead of the previous
+ * program of the victim die.
+ *
+ * The migration of a cold block reclaims almost nothing, so it is parked once the die has
+ * no more than `GC_BACKGROUND_FREE_BLOCK_COUNT` free blocks, and the block with the most
+ * invalid slices is collected instead, check `ParkWearLevelingMigration()`.
+ *
+ * @param dieNo the die under GC, a victim block is selected if there is none.
+ * @return unsigned int 1 if the victim block was erased, otherwise 0.
+ */
+unsigned int GarbageCollectionStep(unsigned int dieNo)
 {
     unsigned int victimBlockNo, pageNo, virtualSliceAddr, logicalSliceAddr, dieNoForGcCopy, reqSlotTag;
+    unsigned int tempDataBufEntry, firstDie, numOfDie, copiedSliceCnt;
+    P_SPARE_DATA_ENTRY spareData;
+
+    if ((virtualDieMapPtr->die[dieNo].freeBlockCnt <= GC_BACKGROUND_FREE_BLOCK_COUNT) &&
+        IsWearLevelingMigration(dieNo, gcVictimMapPtr->victimBlock[dieNo]) && IsGcVictimAvailable(dieNo))
+        ParkWearLevelingMigration(dieNo);
 
-    victimBlockNo  = GetFromGcVictimList(dieNo);
+    if (gcVictimMapPtr->victimBlock[dieNo] == BLOCK_NONE)
+        StartGarbageCollection(dieNo, GetFromGcVictimList(dieNo));
+
+    victimBlockNo  = gcVictimMapPtr->victimBlock[dieNo];
     dieNoForGcCopy = dieNo;
+    copiedSliceCnt = 0;
+    GetDieRangeForGcCopy(dieNo, &firstDie, &numOfDie);
 
-    if (virtualBlockMapPtr->block[dieNo][victimBlockNo].invalidSliceCnt != SLICES_PER_BLOCK)
+    for (pageNo = gcVictimMapPtr->victimPage[dieNo];
+         (pageNo < USER_PAGES_PER_BLOCK) && (VBLK_INVALID_CNT(dieNo, victimBlockNo) != SLICES_PER_BLOCK);
+         pageNo++)
     {
-        for (pageNo = 0; pageNo < USER_PAGES_PER_BLOCK; pageNo++)
+        if (copiedSliceCnt == GC_COPY_PAGES_PER_STEP)
         {
-            virtualSliceAddr = Vorg2VsaTranslation(dieNo, victimBlockNo, pageNo);
-            logicalSliceAddr = virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr;
-
-            if (logicalSliceAddr != LSA_NONE)
-                if (logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr ==
-                    virtualSliceAddr) // valid data
-                {
-                    // read
-                    reqSlotTag = GetFromFreeReqQ();
-
-                    reqPoolPtr->reqPool[reqSlotTag].reqType               = REQ_TYPE_NAND;
-                    reqPoolPtr->reqPool[reqSlotTag].reqCode               = REQ_CODE_READ;
-                    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr      = logicalSliceAddr;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat  = REQ_OPT_DATA_BUF_TEMP_ENTRY;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr       = REQ_OPT_NAND_ADDR_VSA;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc        = REQ_OPT_NAND_ECC_ON;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck =
-                        REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-                    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
-                    UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry,
-                                                          reqSlotTag);
-                    reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
-
-                    SelectLowLevelReqQ(reqSlotTag);
-
-                    // write
-                    reqSlotTag = GetFromFreeReqQ();
-
-                    reqPoolPtr->reqPool[reqSlotTag].reqType               = REQ_TYPE_NAND;
-                    reqPoolPtr->reqPool[reqSlotTag].reqCode               = REQ_CODE_WRITE;
-                    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr      = logicalSliceAddr;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat  = REQ_OPT_DATA_BUF_TEMP_ENTRY;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr       = REQ_OPT_NAND_ADDR_VSA;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc        = REQ_OPT_NAND_ECC_ON;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck =
-                        REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-                    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
-                    UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry,
-                                                          reqSlotTag);
-                    reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr =
-                        FindFreeVirtualSliceForGc(dieNoForGcCopy, victimBlockNo);
-
-                    logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr =
-                        reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr;
-                    virtualSliceMapPtr->virtualSlice[reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr]
-                        .logicalSliceAddr = logicalSliceAddr;
-
-                    SelectLowLevelReqQ(reqSlotTag);
-                }
+            gcVictimMapPtr->victimPage[dieNo] = pageNo;
+            return 0;
         }
+
+        virtualSliceAddr = Vorg2VsaTranslation(dieNo, victimBlockNo, pageNo);
+        if (!IS_VSA_VALID(virtualSliceAddr))
+            continue;
+
+        dieNoForGcCopy   = SelectDieForGcCopy(dieNo, firstDie, numOfDie, dieNoForGcCopy);
+        tempDataBufEntry = AllocateTempDataBuf(dieNoForGcCopy);
+
+        // read
+        reqSlotTag = GetFromFreeReqQ();
+
+        reqPoolPtr->reqPool[reqSlotTag].reqType                       = REQ_TYPE_NAND;
+        reqPoolPtr->reqPool[reqSlotTag].reqCode                       = REQ_CODE_READ;
+        reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr              = LSA_NONE;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr               = REQ_OPT_NAND_ADDR_VSA;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc                = REQ_OPT_NAND_ECC_ON;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning         = REQ_OPT_NAND_ECC_WARNING_OFF;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
+        reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry             = tempDataBufEntry;
+        UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, reqSlotTag);
+        reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+
+        spareData = (P_SPARE_DATA_ENTRY)GenerateSpareDataBufAddr(reqSlotTag);
+        SelectLowLevelReqQ(reqSlotTag);
+
+        /*
+         * The owner of the slice is only known from its spare region, so wait for the
+         * read. The reads of the victim die are executed one by one anyway, and the
+         * previous programs keep running on their target dies meanwhile.
+         */
+        SyncNandReqDone(reqSlotTag);
+        logicalSliceAddr = spareData->logicalSliceAddr;
+        if ((logicalSliceAddr >= SLICES_PER_SSD) && !IS_MAP_SEGMENT_LSA(logicalSliceAddr))
+            assert(!"[WARNING] The spare region of a valid slice has no owner [WARNING]");
+
+        // write
+        reqSlotTag = GetFromFreeReqQ();
+
+        reqPoolPtr->reqPool[reqSlotTag].reqType                       = REQ_TYPE_NAND;
+        reqPoolPtr->reqPool[reqSlotTag].reqCode                       = REQ_CODE_WRITE;
+        reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr              = logicalSliceAddr;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr               = REQ_OPT_NAND_ADDR_VSA;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc                = REQ_OPT_NAND_ECC_ON;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning         = REQ_OPT_NAND_ECC_WARNING_OFF;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+        reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
+        reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry             = tempDataBufEntry;
+        UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, reqSlotTag);
+
+        // the copied slice is invalid on the victim block, so the step can be resumed from anywhere
+        CLR_VSA_VALID(virtualSliceAddr);
+        VBLK_INVALID_CNT(dieNo, victimBlockNo)++;
+
+        // the other die may have run out of free slices for the translation pages written meanwhile
+        virtualSliceAddr = VSA_FAIL;
+        if (dieNoForGcCopy != dieNo)
+            virtualSliceAddr = FindFreeVirtualSliceWithoutGc(dieNoForGcCopy);
+
+        if (virtualSliceAddr != VSA_FAIL)
+            ssdTelemetry.gcCrossDieCopyCnt++;
+        else
+            virtualSliceAddr = FindFreeVirtualSliceForGc(dieNo, victimBlockNo);
+        reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+
+        SetMappedVsa(logicalSliceAddr, virtualSliceAddr);
+        SET_VSA_VALID(virtualSliceAddr);
+
+        SelectLowLevelReqQ(reqSlotTag);
+        ssdStatistics.gcCopyPageCnt++;
+        copiedSliceCnt++;
     }
 
     EraseBlock(dieNo, victimBlockNo);
+    gcVictimMapPtr->victimBlock[dieNo] = BLOCK_NONE;
+    gcVictimMapPtr->ongoingGcCnt--;
+    ssdStatistics.gcEraseCnt++;
+
+    return 1;
+}
+
+/**
+ * @brief Finish the ongoing GC of the specified die, or collect a new victim block at once
+ * if there is none.
+ *
+ * This blocks the caller until a victim block is erased, which may copy a whole block. It
+ * is only needed if the die runs out of free blocks before `IncrementalGarbageCollection()`
+ * catches up.
+ *
+ * @param dieNo the die to be collected.
+ */
+void GarbageCollection(unsigned int dieNo)
+{
+    ssdTelemetry.gcBlockingCnt++;
+
+    while (!GarbageCollectionStep(dieNo))
+        ;
+}
+
+/**
+ * @brief Advance the GC of the specified die by a step before a write is served by it.
+ *
+ * A new victim block is only selected if the free blocks of the die are no more than
+ * `GC_START_FREE_BLOCK_COUNT`. The collection of a victim block is then spread over the
+ * following writes to the die, and each of them only waits for a bounded number of copies.
+ *
+ * The migration of a cold block is left to `IdleGarbageCollection()`. If the die is also
+ * running out of free blocks, the migration is parked by the step, check
+ * `GarbageCollectionStep()`.
+ *
+ * @param dieNo the die to serve the next write.
+ */
+void IncrementalGarbageCollection(unsigned int dieNo)
+{
+    if (virtualDieMapPtr->die[dieNo].freeBlockCnt > GC_START_FREE_BLOCK_COUNT)
+    {
+        if ((gcVictimMapPtr->victimBlock[dieNo] == BLOCK_NONE) ||
+            IsWearLevelingMigration(dieNo, gcVictimMapPtr->victimBlock[dieNo]))
+            return;
+    }
+    else if ((gcVictimMapPtr->victimBlock[dieNo] == BLOCK_NONE) && !IsGcVictimAvailable(dieNo))
+        return;
+
+    GarbageCollectionStep(dieNo);
+}
+
+/**
+ * @brief Start collecting the die with the fewest free blocks, if it has no more than
+ * `GC_BACKGROUND_FREE_BLOCK_COUNT` free blocks.
+ *
+ * @return unsigned int 1 if a victim block is selected, otherwise 0.
+ */
+static unsigned int StartBackgroundGarbageCollection()
+{
+    unsigned int dieNo, targetDie;
+
+    targetDie = DIE_NONE;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+    {
+        // a die migrating a cold block is collected by its next step, check `GarbageCollectionStep()`
+        if ((virtualDieMapPtr->die[dieNo].freeBlockCnt > GC_BACKGROUND_FREE_BLOCK_COUNT) ||
+            (gcVictimMapPtr->victimBlock[dieNo] != BLOCK_NONE))
+            continue;
+        if ((targetDie != DIE_NONE) &&
+            (virtualDieMapPtr->die[dieNo].freeBlockCnt >= virtualDieMapPtr->die[targetDie].freeBlockCnt))
+            continue;
+
+        // a die without any invalid slice, e.g. a die with only bad blocks, can't be collected
+        if (IsGcVictimAvailable(dieNo))
+            targetDie = dieNo;
+    }
+
+    if (targetDie == DIE_NONE)
+        return 0;
+
+    StartGarbageCollection(targetDie, GetFromGcVictimList(targetDie));
+    return 1;
+}
+
+/**
+ * @brief Advance one of the ongoing GCs by a step while there is no host request to handle,
+ * or while the host writes are throttled, check `AdmitHostWrite()`.
+ *
+ * The dies under GC are served in round-robin. If there is no ongoing GC other than the
+ * migration of a cold block, the die with the fewest free blocks is collected in the
+ * background, check `GC_BACKGROUND_FREE_BLOCK_COUNT`. A cold block is only migrated if no
+ * die needs GC, check `IdleWearLeveling()`.
+ */
+void IdleGarbageCollection()
+{
+    unsigned int iDie, dieNo;
+
+    if (gcVictimMapPtr->ongoingGcCnt == (wlMap.migratingDie != DIE_NONE))
+    {
+        if (StartBackgroundGarbageCollection())
+            return;
+        if (!gcVictimMapPtr->ongoingGcCnt)
+        {
+            IdleWearLeveling();
+            return;
+        }
+    }
+
+    for (iDie = 0; iDie < USER_DIES; iDie++)
+    {
+        dieNo                     = gcVictimMapPtr->idleGcDie;
+        gcVictimMapPtr->idleGcDie = (dieNo + 1) % USER_DIES;
+
+        if (gcVictimMapPtr->victimBlock[dieNo] != BLOCK_NONE)
+        {
+            GarbageCollectionStep(dieNo);
+            return;
+        }
+    }
 }
 
 void PutToGcVictimList(unsigned int dieNo, unsigned int blockNo, unsigned int invalidSliceCnt)
 {
     if (gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock != BLOCK_NONE)
     {
-        virtualBlockMapPtr->block[dieNo][blockNo].prevBlock =
-            gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock;
-        virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-        virtualBlockMapPtr->block[dieNo][gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock]
-            .nextBlock                                                 = blockNo;
-        gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = blockNo;
+        VBLK_PREV_IDX(dieNo, blockNo) = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock;
+        VBLK_NEXT_IDX(dieNo, blockNo) = BLOCK_NONE;
+        VBLK_NEXT_IDX(dieNo, gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock) = blockNo;
+        gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock                       = blockNo;
     }
     else
     {
-        virtualBlockMapPtr->block[dieNo][blockNo].prevBlock            = BLOCK_NONE;
-        virtualBlockMapPtr->block[dieNo][blockNo].nextBlock            = BLOCK_NONE;
+        VBLK_PREV_IDX(dieNo, blockNo)                                  = BLOCK_NONE;
+        VBLK_NEXT_IDX(dieNo, blockNo)                                  = BLOCK_NONE;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = blockNo;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = blockNo;
     }
@@ -168,12 +532,11 @@ unsigned int GetFromGcVictimList(unsigned int dieNo)
         {
             evictedBlockNo = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock;
 
-            if (virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock != BLOCK_NONE)
+            if (VBLK_NEXT_IDX(dieNo, evictedBlockNo) != BLOCK_NONE)
             {
-                virtualBlockMapPtr->block[dieNo][virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock]
-                    .prevBlock = BLOCK_NONE;
+                VBLK_PREV_IDX(dieNo, VBLK_NEXT_IDX(dieNo, evictedBlockNo)) = BLOCK_NONE;
                 gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock =
-                    virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock;
+                    VBLK_NEXT_IDX(dieNo, evictedBlockNo);
             }
             else
             {
@@ -192,23 +555,23 @@ void SelectiveGetFromGcVictimList(unsigned int dieNo, unsigned int blockNo)
 {
     unsigned int nextBlock, prevBlock, invalidSliceCnt;
 
-    nextBlock       = virtualBlockMapPtr->block[dieNo][blockNo].nextBlock;
-    prevBlock       = virtualBlockMapPtr->block[dieNo][blockNo].prevBlock;
-    invalidSliceCnt = virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt;
+    nextBlock       = VBLK_NEXT_IDX(dieNo, blockNo);
+    prevBlock       = VBLK_PREV_IDX(dieNo, blockNo);
+    invalidSliceCnt = VBLK_INVALID_CNT(dieNo, blockNo);
 
     if ((nextBlock != BLOCK_NONE) && (prevBlock != BLOCK_NONE))
     {
-        virtualBlockMapPtr->block[dieNo][prevBlock].nextBlock = nextBlock;
-        virtualBlockMapPtr->block[dieNo][nextBlock].prevBlock = prevBlock;
+        VBLK_NEXT_IDX(dieNo, prevBlock) = nextBlock;
+        VBLK_PREV_IDX(dieNo, nextBlock) = prevBlock;
     }
     else if ((nextBlock == BLOCK_NONE) && (prevBlock != BLOCK_NONE))
     {
-        virtualBlockMapPtr->block[dieNo][prevBlock].nextBlock          = BLOCK_NONE;
+        VBLK_NEXT_IDX(dieNo, prevBlock)                                = BLOCK_NONE;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = prevBlock;
     }
     else if ((nextBlock != BLOCK_NONE) && (prevBlock == BLOCK_NONE))
     {
-        virtualBlockMapPtr->block[dieNo][nextBlock].prevBlock          = BLOCK_NONE;
+        VBLK_PREV_IDX(dieNo, nextBlock)                                = BLOCK_NONE;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = nextBlock;
     }
     else
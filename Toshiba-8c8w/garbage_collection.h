@@ -48,6 +48,30 @@
 
 #include "ftl_config.h"
 
+/**
+ * @brief The min number of free blocks of a die to accept the valid slices of other dies,
+ * check `SelectDieForGcCopy()`.
+ */
+#define GC_COPY_MIN_FREE_BLOCK_COUNT 4 // user configurable factor
+
+/**
+ * @brief The GC of a die is spread over the writes to the die, check `IncrementalGarbageCollection()`.
+ *
+ * A victim block is selected once the free blocks of the die are no more than
+ * `GC_START_FREE_BLOCK_COUNT`, and at most `GC_COPY_PAGES_PER_STEP` valid slices are copied
+ * before each write. So a victim block is collected within `SLICES_PER_BLOCK / GC_COPY_PAGES_PER_STEP`
+ * writes, and the free blocks above `RESERVED_FREE_BLOCK_COUNT` must cover these writes and
+ * the copies programmed to the victim die, which take at most two blocks.
+ */
+#define GC_COPY_PAGES_PER_STEP    8 // user configurable factor
+#define GC_START_FREE_BLOCK_COUNT 3 // user configurable factor, must be larger than `RESERVED_FREE_BLOCK_COUNT`
+
+/**
+ * @brief A die with no more than `GC_BACKGROUND_FREE_BLOCK_COUNT` free blocks is collected
+ * while the host is idle, and the host writes are throttled, check `WRITE_THROTTLE`.
+ */
+#define GC_BACKGROUND_FREE_BLOCK_COUNT 16 // user configurable factor, larger than `GC_START_FREE_BLOCK_COUNT`
+
 typedef struct _GC_VICTIM_LIST_ENTRY
 {
     unsigned int headBlock : 16;
@@ -57,10 +81,20 @@ typedef struct _GC_VICTIM_LIST_ENTRY
 typedef struct _GC_VICTIM_MAP
 {
     GC_VICTIM_LIST_ENTRY gcVictimList[USER_DIES][SLICES_PER_BLOCK + 1];
+    unsigned int victimBlock[USER_DIES]; // the block being collected, not in any list, or `BLOCK_NONE`
+    unsigned int victimPage[USER_DIES];  // the page of `victimBlock` to resume the collection
+    unsigned int ongoingGcCnt;           // the number of dies with a `victimBlock`
+    unsigned int idleGcDie;              // the die to be checked first by `IdleGarbageCollection()`
 } GC_VICTIM_MAP, *P_GC_VICTIM_MAP;
 
 void InitGcVictimMap();
+void StartGarbageCollection(unsigned int dieNo, unsigned int victimBlockNo);
+void StopGarbageCollection(unsigned int dieNo);
+unsigned int GarbageCollectionStep(unsigned int dieNo);
 void GarbageCollection(unsigned int dieNo);
+void IncrementalGarbageCollection(unsigned int dieNo);
+void IdleGarbageCollection();
+unsigned int GetGcVictimValidSliceCnt(unsigned int dieNo, unsigned int victimCnt);
 
 void PutToGcVictimList(unsigned int dieNo, unsigned int blockNo, unsigned int invalidSliceCnt);
 unsigned int GetFromGcVictimList(unsigned int dieNo);
@@ -0,0 +1,533 @@
+//////////////////////////////////////////////////////////////////////////////////
+// map_cache.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Map Cache
+// File Name: map_cache.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - page the logical slice map on NAND (DFTL)
+//   - move the paged logical slice map between NAND and the host memory buffer
+//   - keep the sequentially written segments of the DFTL mode compressed
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <assert.h>
+#include <string.h>
+#include "debug.h"
+#include "nvme/nvme_hmb.h"
+#include "memory_map.h"
+
+P_MAP_CACHE mapCachePtr;
+
+#if SUPPORT_DFTL
+/**
+ * @brief Invalidate all the cache entries and link them into the LRU list.
+ *
+ * @warning The dirty entries are discarded, check `FlushMapCacheFromTail()`.
+ */
+static void ResetMapCache()
+{
+    unsigned int iEntry, segment;
+
+    for (iEntry = 0; iEntry < MAP_CACHE_ENTRY_COUNT; iEntry++)
+    {
+        mapCachePtr->entry[iEntry].segment   = MAP_CACHE_ENTRY_NONE;
+        mapCachePtr->entry[iEntry].dirty     = 0;
+        mapCachePtr->entry[iEntry].prevEntry = iEntry - 1;
+        mapCachePtr->entry[iEntry].nextEntry = iEntry + 1;
+    }
+
+    mapCachePtr->entry[0].prevEntry                         = MAP_CACHE_ENTRY_NONE;
+    mapCachePtr->entry[MAP_CACHE_ENTRY_COUNT - 1].nextEntry = MAP_CACHE_ENTRY_NONE;
+    mapCachePtr->headEntry                                  = 0;
+    mapCachePtr->tailEntry                                  = MAP_CACHE_ENTRY_COUNT - 1;
+
+    for (segment = 0; segment < MAP_SEGMENTS_PER_SSD; segment++)
+        mapCachePtr->segmentEntry[segment] = MAP_CACHE_ENTRY_NONE;
+}
+#endif
+
+/**
+ * @brief Initialize the map cache.
+ *
+ * The logical slice map is resident in the device DRAM, unless the DFTL mode is enabled
+ * by `SUPPORT_DFTL`, in which case no translation page exists on NAND yet, and all the
+ * segments are compressed without any extent, i.e. all the logical slices are unmapped.
+ */
+void InitMapCache()
+{
+#if SUPPORT_DFTL
+    unsigned int segment;
+#endif
+
+    mapCachePtr = (P_MAP_CACHE)MAP_CACHE_ADDR;
+
+#if SUPPORT_DFTL
+    ResetMapCache();
+    for (segment = 0; segment < MAP_SEGMENTS_PER_SSD; segment++)
+    {
+        mapCachePtr->segmentVsa[segment]              = VSA_NONE;
+        mapCachePtr->segmentExtent[segment].extentCnt = 0;
+    }
+    mapCachePtr->targetDie = 0;
+    mapCachePtr->mode      = MAP_CACHE_MODE_NAND;
+    xil_printf("[ DFTL: %u translation pages, %u MB cached mapping table ]\r\n",
+               (unsigned int)MAP_SEGMENTS_PER_SSD,
+               (unsigned int)(MAP_CACHE_ENTRY_COUNT * BYTES_PER_MAP_CACHE_ENTRY / (1024 * 1024)));
+#else
+    mapCachePtr->mode = MAP_CACHE_MODE_DRAM;
+#endif
+}
+
+#if SUPPORT_DFTL
+/**
+ * @brief Move the specified entry to the head (MRU) of the LRU list.
+ *
+ * @param iEntry the index of the cache entry.
+ */
+static void TouchMapCacheEntry(unsigned int iEntry)
+{
+    unsigned int prevEntry = mapCachePtr->entry[iEntry].prevEntry;
+    unsigned int nextEntry = mapCachePtr->entry[iEntry].nextEntry;
+
+    if (iEntry == mapCachePtr->headEntry)
+        return;
+
+    // unlink
+    mapCachePtr->entry[prevEntry].nextEntry = nextEntry;
+    if (nextEntry != MAP_CACHE_ENTRY_NONE)
+        mapCachePtr->entry[nextEntry].prevEntry = prevEntry;
+    else
+        mapCachePtr->tailEntry = prevEntry;
+
+    // insert to head
+    mapCachePtr->entry[iEntry].prevEntry                 = MAP_CACHE_ENTRY_NONE;
+    mapCachePtr->entry[iEntry].nextEntry                 = mapCachePtr->headEntry;
+    mapCachePtr->entry[mapCachePtr->headEntry].prevEntry = iEntry;
+    mapCachePtr->headEntry                               = iEntry;
+}
+
+/**
+ * @brief Issue a NAND request to read or write the translation page of a map segment.
+ *
+ * The cache entry is used as the data buffer of the request directly, so the entry must
+ * not be reused before the request is done, check `SyncNandReqDone()`.
+ *
+ * @param reqCode `REQ_CODE_READ` or `REQ_CODE_WRITE`.
+ * @param segment the index of the map segment.
+ * @param iEntry the index of the cache entry.
+ * @return unsigned int the request pool entry index of the issued request.
+ */
+static unsigned int IssueMapSegmentReq(unsigned int reqCode, unsigned int segment, unsigned int iEntry)
+{
+    unsigned int reqSlotTag;
+
+    reqSlotTag = GetFromFreeReqQ();
+
+    reqPoolPtr->reqPool[reqSlotTag].reqType                       = REQ_TYPE_NAND;
+    reqPoolPtr->reqPool[reqSlotTag].reqCode                       = reqCode;
+    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr              = MAP_SEGMENT_LSA(segment);
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_ADDR;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr               = REQ_OPT_NAND_ADDR_VSA;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc                = REQ_OPT_NAND_ECC_ON;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning         = REQ_OPT_NAND_ECC_WARNING_OFF;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
+    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.addr              = MAP_CACHE_ENTRY_ADDR(iEntry);
+    reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr     = mapCachePtr->segmentVsa[segment];
+
+    SelectLowLevelReqQ(reqSlotTag);
+
+    return reqSlotTag;
+}
+
+/**
+ * @brief Allocate a free virtual slice for a translation page.
+ *
+ * The translation pages are spread over the dies in round-robin. To avoid recursive GC,
+ * the dies that need GC to provide a free slice are skipped. The dies under GC are also
+ * avoided, since their free slices are needed by the valid slices of the victim blocks,
+ * but they are still used if all the other dies are full, like the host writes to them.
+ *
+ * @return unsigned int the virtual slice address for the translation page.
+ */
+static unsigned int FindFreeVirtualSliceForMapSegment()
+{
+    unsigned int iDie, dieNo, virtualSliceAddr;
+
+    for (iDie = 0; iDie < USER_DIES; iDie++)
+    {
+        dieNo                  = mapCachePtr->targetDie;
+        mapCachePtr->targetDie = (dieNo + 1) % USER_DIES;
+
+        if (gcVictimMapPtr->victimBlock[dieNo] != BLOCK_NONE)
+            continue;
+
+        virtualSliceAddr = FindFreeVirtualSliceWithoutGc(dieNo);
+        if (virtualSliceAddr != VSA_FAIL)
+            return virtualSliceAddr;
+    }
+
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+    {
+        virtualSliceAddr = FindFreeVirtualSliceWithoutGc(dieNo);
+        if (virtualSliceAddr != VSA_FAIL)
+            return virtualSliceAddr;
+    }
+
+    assert(!"[WARNING] There is no available block for translation pages [WARNING]");
+    return VSA_FAIL;
+}
+
+/**
+ * @brief Write the specified entry to a new translation page.
+ *
+ * The old translation page is invalidated like an overwritten user slice, and the global
+ * translation directory is updated before the request is issued.
+ *
+ * @param iEntry the index of the cache entry.
+ * @return unsigned int the request pool entry index of the write request.
+ */
+static unsigned int WriteMapSegment(unsigned int iEntry)
+{
+    unsigned int segment = mapCachePtr->entry[iEntry].segment;
+    unsigned int virtualSliceAddr;
+
+    InvalidateOldVsa(MAP_SEGMENT_LSA(segment));
+
+    virtualSliceAddr                 = FindFreeVirtualSliceForMapSegment();
+    mapCachePtr->segmentVsa[segment] = virtualSliceAddr;
+    SET_VSA_VALID(virtualSliceAddr);
+
+    return IssueMapSegmentReq(REQ_CODE_WRITE, segment, iEntry);
+}
+
+/**
+ * @brief Write back the dirty LRU entry.
+ *
+ * In the DFTL mode, up to `MAP_CACHE_FLUSH_BATCH` dirty entries in the LRU half of the list
+ * are written back together, so the programs are spread over the dies and overlapped, and
+ * the following evictions are more likely to find clean entries. Then the function waits
+ * for all of them since the entries are the buffers of the requests.
+ *
+ * A dirty entry that can be compressed is not written back at all. Its old translation
+ * page is invalidated, and the entry is released since the extents take over the segment.
+ *
+ * The HMB is written synchronously, so only the LRU entry is written back in HMB mode, or
+ * compressed like the DFTL mode.
+ */
+static void FlushMapCacheFromTail()
+{
+    unsigned int reqSlotTag[MAP_CACHE_FLUSH_BATCH];
+    unsigned int iEntry, segment, scanCnt, flushCnt, iReq;
+
+    iEntry   = mapCachePtr->tailEntry;
+    flushCnt = 0;
+    for (scanCnt = 0; (scanCnt < MAP_CACHE_ENTRY_COUNT / 2) && (flushCnt < MAP_CACHE_FLUSH_BATCH); scanCnt++)
+    {
+        segment = mapCachePtr->entry[iEntry].segment;
+        if ((segment != MAP_CACHE_ENTRY_NONE) && mapCachePtr->entry[iEntry].dirty)
+        {
+            if (PackMapExtent(&mapCachePtr->segmentExtent[segment], segment * SLICES_PER_MAP_SEGMENT,
+                              (P_LOGICAL_SLICE_ENTRY)MAP_CACHE_ENTRY_ADDR(iEntry)))
+            {
+                InvalidateOldVsa(MAP_SEGMENT_LSA(segment));
+                mapCachePtr->segmentEntry[segment] = MAP_CACHE_ENTRY_NONE;
+                mapCachePtr->entry[iEntry].segment = MAP_CACHE_ENTRY_NONE;
+                ssdTelemetry.mapExtentPackCnt++;
+            }
+            else if (mapCachePtr->mode == MAP_CACHE_MODE_HMB)
+            {
+                write_nvme_hmb(segment * BYTES_PER_MAP_SEGMENT, MAP_CACHE_ENTRY_ADDR(iEntry),
+                               BYTES_PER_MAP_SEGMENT);
+                ssdTelemetry.mapCacheFlushCnt++;
+            }
+            else
+            {
+                reqSlotTag[flushCnt++] = WriteMapSegment(iEntry);
+                ssdTelemetry.mapCacheFlushCnt++;
+            }
+            mapCachePtr->entry[iEntry].dirty = 0;
+        }
+        if (mapCachePtr->mode == MAP_CACHE_MODE_HMB)
+            break;
+        iEntry = mapCachePtr->entry[iEntry].prevEntry;
+    }
+
+    for (iReq = 0; iReq < flushCnt; iReq++)
+        SyncNandReqDone(reqSlotTag[iReq]);
+}
+
+/**
+ * @brief Read the specified map segment from its backing store into a cache entry.
+ *
+ * @param segment the index of the map segment.
+ * @param iEntry the index of the cache entry.
+ */
+static void FetchMapSegment(unsigned int segment, unsigned int iEntry)
+{
+    if (mapCachePtr->mode == MAP_CACHE_MODE_HMB)
+        read_nvme_hmb(segment * BYTES_PER_MAP_SEGMENT, MAP_CACHE_ENTRY_ADDR(iEntry), BYTES_PER_MAP_SEGMENT);
+    else if (mapCachePtr->segmentVsa[segment] == VSA_NONE)
+        memset((void *)MAP_CACHE_ENTRY_ADDR(iEntry), 0xFF, BYTES_PER_MAP_SEGMENT); // all `VSA_NONE`
+    else
+        SyncNandReqDone(IssueMapSegmentReq(REQ_CODE_READ, segment, iEntry));
+}
+
+/**
+ * @brief Release the LRU entry for reuse, write it back first if it is dirty.
+ *
+ * @return unsigned int the index of the released cache entry, still the LRU entry.
+ */
+static unsigned int EvictMapCacheEntry()
+{
+    unsigned int iEntry = mapCachePtr->tailEntry;
+
+    if (mapCachePtr->entry[iEntry].dirty)
+        FlushMapCacheFromTail();
+    if (mapCachePtr->entry[iEntry].segment != MAP_CACHE_ENTRY_NONE)
+        mapCachePtr->segmentEntry[mapCachePtr->entry[iEntry].segment] = MAP_CACHE_ENTRY_NONE;
+    mapCachePtr->entry[iEntry].segment = MAP_CACHE_ENTRY_NONE;
+
+    return iEntry;
+}
+
+/**
+ * @brief Get the cache entry of the specified map segment, fetch it on a miss.
+ *
+ * On a miss, the LRU entry is written back if it is dirty and reused for the segment.
+ * The returned entry becomes the MRU entry.
+ *
+ * @param segment the index of the map segment.
+ * @return unsigned int the index of the cache entry that holds the segment.
+ */
+static unsigned int LoadMapSegment(unsigned int segment)
+{
+    unsigned int iEntry = mapCachePtr->segmentEntry[segment];
+    XTime startTime, endTime;
+
+    if (iEntry != MAP_CACHE_ENTRY_NONE)
+    {
+        ssdTelemetry.mapCacheHitCnt++;
+        TouchMapCacheEntry(iEntry);
+        return iEntry;
+    }
+
+    ssdTelemetry.mapCacheMissCnt++;
+    XTime_GetTime(&startTime);
+
+    iEntry = EvictMapCacheEntry();
+    FetchMapSegment(segment, iEntry);
+    mapCachePtr->entry[iEntry].segment = segment;
+    mapCachePtr->segmentEntry[segment] = iEntry;
+    TouchMapCacheEntry(iEntry);
+
+    XTime_GetTime(&endTime);
+    ssdTelemetry.mapCacheFetchTime += endTime - startTime;
+
+    return iEntry;
+}
+
+/**
+ * @brief Expand a compressed segment to per-slice entries in a cache entry.
+ *
+ * The compressed segment has no translation page, so the entry is dirty until the segment
+ * is written back or compressed again. The returned entry becomes the MRU entry.
+ *
+ * @param segment the index of the compressed map segment.
+ * @return unsigned int the index of the cache entry that holds the segment.
+ */
+static unsigned int ExpandMapSegment(unsigned int segment)
+{
+    unsigned int iEntry = EvictMapCacheEntry();
+
+    UnpackMapExtent(&mapCachePtr->segmentExtent[segment], (P_LOGICAL_SLICE_ENTRY)MAP_CACHE_ENTRY_ADDR(iEntry));
+    mapCachePtr->segmentExtent[segment].extentCnt = MAP_EXTENT_CNT_EXPANDED;
+
+    mapCachePtr->entry[iEntry].segment = segment;
+    mapCachePtr->entry[iEntry].dirty   = 1;
+    mapCachePtr->segmentEntry[segment] = iEntry;
+    TouchMapCacheEntry(iEntry);
+    ssdTelemetry.mapExtentExpandCnt++;
+
+    return iEntry;
+}
+#endif
+
+/**
+ * @brief Get the mapped virtual slice of the specified logical slice.
+ *
+ * @param logicalSliceAddr the logical slice address, must be less than `SLICES_PER_SSD`,
+ * or the address of a translation page, check `MAP_SEGMENT_LSA()`.
+ * @return unsigned int the virtual slice address, or `VSA_NONE` if not mapped.
+ */
+unsigned int GetMappedVsa(unsigned int logicalSliceAddr)
+{
+#if SUPPORT_DFTL
+    P_LOGICAL_SLICE_ENTRY segmentData;
+    unsigned int segment, iEntry;
+
+    if (IS_MAP_SEGMENT_LSA(logicalSliceAddr))
+        return mapCachePtr->segmentVsa[logicalSliceAddr - SLICES_PER_SSD];
+
+    segment = logicalSliceAddr / SLICES_PER_MAP_SEGMENT;
+    if (mapCachePtr->segmentExtent[segment].extentCnt != MAP_EXTENT_CNT_EXPANDED)
+    {
+        ssdTelemetry.mapExtentHitCnt++;
+        return LookupMapExtent(&mapCachePtr->segmentExtent[segment], logicalSliceAddr);
+    }
+
+    iEntry      = LoadMapSegment(segment);
+    segmentData = (P_LOGICAL_SLICE_ENTRY)MAP_CACHE_ENTRY_ADDR(iEntry);
+
+    return segmentData[logicalSliceAddr % SLICES_PER_MAP_SEGMENT].virtualSliceAddr;
+#else
+    return logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
+#endif
+}
+
+/**
+ * @brief Update the mapped virtual slice of the specified logical slice.
+ *
+ * In the DFTL mode, a compressed segment is expanded if the update cannot be represented
+ * within `MAP_EXTENTS_PER_SEGMENT` extents.
+ *
+ * @param logicalSliceAddr the logical slice address, must be less than `SLICES_PER_SSD`,
+ * or the address of a translation page, check `MAP_SEGMENT_LSA()`.
+ * @param virtualSliceAddr the new virtual slice address, or `VSA_NONE` to unmap.
+ */
+void SetMappedVsa(unsigned int logicalSliceAddr, unsigned int virtualSliceAddr)
+{
+#if SUPPORT_DFTL
+    P_LOGICAL_SLICE_ENTRY segmentData;
+    unsigned int segment, iEntry;
+
+    if (IS_MAP_SEGMENT_LSA(logicalSliceAddr))
+    {
+        mapCachePtr->segmentVsa[logicalSliceAddr - SLICES_PER_SSD] = virtualSliceAddr;
+        return;
+    }
+
+    segment = logicalSliceAddr / SLICES_PER_MAP_SEGMENT;
+    if (mapCachePtr->segmentExtent[segment].extentCnt != MAP_EXTENT_CNT_EXPANDED)
+    {
+        if (UpdateMapExtent(&mapCachePtr->segmentExtent[segment], logicalSliceAddr, virtualSliceAddr))
+            return;
+        iEntry = ExpandMapSegment(segment);
+    }
+    else
+        iEntry = LoadMapSegment(segment);
+
+    segmentData = (P_LOGICAL_SLICE_ENTRY)MAP_CACHE_ENTRY_ADDR(iEntry);
+
+    segmentData[logicalSliceAddr % SLICES_PER_MAP_SEGMENT].virtualSliceAddr = virtualSliceAddr;
+    mapCachePtr->entry[iEntry].dirty                                        = 1;
+#else
+    logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = virtualSliceAddr;
+#endif
+}
+
+/**
+ * @brief Replace the translation pages of the DFTL mode with the HMB.
+ *
+ * Every expanded segment is copied to its location in the HMB, from its cache entry if it
+ * is cached, or from its translation page otherwise, and the translation page is
+ * invalidated for the GC. The compressed segments stay in their extents, and the cached
+ * entries become clean copies of the HMB.
+ */
+void MoveMapToHmb()
+{
+#if SUPPORT_DFTL
+    unsigned int segment, iEntry, bounceEntry;
+
+    if (mapCachePtr->mode != MAP_CACHE_MODE_NAND)
+        return;
+
+    // the LRU entry is used as the bounce buffer, so it must not hold any segment
+    bounceEntry = EvictMapCacheEntry();
+
+    for (segment = 0; segment < MAP_SEGMENTS_PER_SSD; segment++)
+    {
+        if (mapCachePtr->segmentExtent[segment].extentCnt != MAP_EXTENT_CNT_EXPANDED)
+            continue;
+
+        iEntry = mapCachePtr->segmentEntry[segment];
+        if (iEntry == MAP_CACHE_ENTRY_NONE)
+        {
+            iEntry = bounceEntry;
+            FetchMapSegment(segment, iEntry);
+        }
+
+        write_nvme_hmb(segment * BYTES_PER_MAP_SEGMENT, MAP_CACHE_ENTRY_ADDR(iEntry), BYTES_PER_MAP_SEGMENT);
+        mapCachePtr->entry[iEntry].dirty = 0;
+        InvalidateOldVsa(MAP_SEGMENT_LSA(segment));
+    }
+
+    mapCachePtr->mode = MAP_CACHE_MODE_HMB;
+#endif
+}
+
+/**
+ * @brief Write the segments in the HMB back to translation pages before the HMB is released.
+ *
+ * The backing store is switched to NAND first, so the cached segments just become dirty,
+ * and the others are read from the HMB into dirty entries, whose evictions write them to
+ * translation pages in batches, or compress them, check `FlushMapCacheFromTail()`.
+ */
+void MoveMapToNand()
+{
+#if SUPPORT_DFTL
+    unsigned int segment, iEntry;
+
+    if (mapCachePtr->mode != MAP_CACHE_MODE_HMB)
+        return;
+
+    mapCachePtr->mode = MAP_CACHE_MODE_NAND;
+
+    for (segment = 0; segment < MAP_SEGMENTS_PER_SSD; segment++)
+    {
+        if (mapCachePtr->segmentExtent[segment].extentCnt != MAP_EXTENT_CNT_EXPANDED)
+            continue;
+
+        iEntry = mapCachePtr->segmentEntry[segment];
+        if (iEntry == MAP_CACHE_ENTRY_NONE)
+        {
+            iEntry = EvictMapCacheEntry();
+            read_nvme_hmb(segment * BYTES_PER_MAP_SEGMENT, MAP_CACHE_ENTRY_ADDR(iEntry), BYTES_PER_MAP_SEGMENT);
+            mapCachePtr->entry[iEntry].segment = segment;
+            mapCachePtr->segmentEntry[segment] = iEntry;
+            TouchMapCacheEntry(iEntry);
+        }
+        mapCachePtr->entry[iEntry].dirty = 1;
+    }
+#endif
+}
@@ -0,0 +1,146 @@
+//////////////////////////////////////////////////////////////////////////////////
+// map_cache.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Map Cache
+// File Name: map_cache.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define the segment cache of the logical slice map
+//   - define the accessors of the logical slice map
+//   - define the global translation directory of the demand-paged map (DFTL)
+//   - define the extent-compressed segments of the demand-paged map
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MAP_CACHE_H_
+#define MAP_CACHE_H_
+
+#include "ftl_config.h"
+#include "address_translation.h"
+#include "map_extent.h"
+
+/**
+ * @brief The logical slice map is cached and transferred in segments of a slice, so that a
+ * segment is exactly a translation page in the DFTL mode. A segment is split into 4KB
+ * direct DMAs when transferred with the HMB, check `read_nvme_hmb()`.
+ */
+#define BYTES_PER_MAP_SEGMENT  BYTES_PER_DATA_REGION_OF_SLICE
+#define SLICES_PER_MAP_SEGMENT (BYTES_PER_MAP_SEGMENT / sizeof(LOGICAL_SLICE_ENTRY))
+#define MAP_SEGMENTS_PER_SSD   (SLICES_PER_SSD / SLICES_PER_MAP_SEGMENT)
+#define MAP_SEGMENTS_PER_DIE   ((MAP_SEGMENTS_PER_SSD + USER_DIES - 1) / USER_DIES)
+
+// the spare region follows the data region like a NAND request buffer, check `GenerateSpareDataBufAddr()`
+#define BYTES_PER_MAP_CACHE_ENTRY (BYTES_PER_MAP_SEGMENT + BYTES_PER_SPARE_REGION_OF_SLICE)
+
+// the hit rate and the throughput against the cache size are modeled by `tools/map_cache_sim.c`
+#if SUPPORT_DFTL
+#define MAP_CACHE_ENTRY_COUNT 1024 // user configurable factor, 16MB of the device DRAM covers 64GB of random data
+#else
+#define MAP_CACHE_ENTRY_COUNT 0 // the resident logical slice map is never cached
+#endif
+#define MAP_CACHE_FLUSH_BATCH 8 // the max number of dirty entries written back together
+
+#define MAP_CACHE_ENTRY_NONE 0xffff
+
+#define MAP_CACHE_MODE_DRAM 0 // the whole logical slice map is in the device DRAM
+#define MAP_CACHE_MODE_HMB  1 // the paged logical slice map is in the HMB instead of NAND, cached in the DRAM
+#define MAP_CACHE_MODE_NAND 2 // the logical slice map is paged on NAND (DFTL), cached in the device DRAM
+
+/**
+ * @brief The translation pages are tracked in the virtual slice map like the user data, with
+ * a logical slice address beyond the logical space, so the GC can move them like the user
+ * data, and `GetMappedVsa()` returns their locations from the translation directory.
+ */
+#define MAP_SEGMENT_LSA(segment) (SLICES_PER_SSD + (segment))
+#define IS_MAP_SEGMENT_LSA(lsa)  (((lsa) >= SLICES_PER_SSD) && ((lsa) < SLICES_PER_SSD + MAP_SEGMENTS_PER_SSD))
+
+/**
+ * @brief A cached segment of the logical slice map.
+ *
+ * The entries are linked in LRU order like the data buffer, the least recently used entry
+ * is evicted on a miss, and written back to its backing store if it is dirty.
+ */
+typedef struct _MAP_CACHE_ENTRY
+{
+    unsigned int segment : 16; // the index of the cached map segment
+    unsigned int dirty : 1;
+    unsigned int reserved0 : 15;
+    unsigned int prevEntry : 16;
+    unsigned int nextEntry : 16;
+} MAP_CACHE_ENTRY, *P_MAP_CACHE_ENTRY;
+
+/**
+ * @brief The segment cache in front of the logical slice map in the HMB or on NAND.
+ *
+ * Every map segment has a fixed location `segment * BYTES_PER_MAP_SEGMENT` in the HMB, and
+ * `segmentEntry` records which cache entry holds the segment, so a lookup never searches.
+ *
+ * In the DFTL mode, `segmentVsa` is the global translation directory, which records the
+ * virtual slice of the latest translation page of each segment. A segment that has never
+ * been written back is not mapped, and all of its logical slices are unmapped.
+ *
+ * While the host provides the HMB, the HMB replaces the translation pages, check
+ * `MoveMapToHmb()`. Only the DFTL mode uses the HMB, since the resident map of the other
+ * mode has nothing to gain from it.
+ *
+ * Also in the DFTL mode, a segment written sequentially is kept compressed as extents in
+ * `segmentExtent`, which are always resident, so the segment needs neither a translation
+ * page nor a cache entry. A segment is expanded to a dirty cache entry when it becomes too
+ * fragmented, and compressed again when it is written back, check `FlushMapCacheFromTail()`.
+ *
+ * Without `SUPPORT_DFTL`, the logical slice map is always resident in the device DRAM, so
+ * neither the entries nor the per-segment tables are allocated.
+ */
+typedef struct _MAP_CACHE
+{
+#if SUPPORT_DFTL
+    MAP_CACHE_ENTRY entry[MAP_CACHE_ENTRY_COUNT];
+    unsigned short segmentEntry[MAP_SEGMENTS_PER_SSD]; // `MAP_CACHE_ENTRY_NONE` if not cached
+    unsigned int segmentVsa[MAP_SEGMENTS_PER_SSD];     // `VSA_NONE` if not written to NAND
+    MAP_EXTENT_LIST segmentExtent[MAP_SEGMENTS_PER_SSD];
+    unsigned int headEntry;                            // the most recently used entry
+    unsigned int tailEntry;                            // the least recently used entry
+    unsigned int targetDie;                            // the die to serve the next translation page
+#endif
+    unsigned int mode; // `MAP_CACHE_MODE_*`
+} MAP_CACHE, *P_MAP_CACHE;
+
+void InitMapCache();
+unsigned int GetMappedVsa(unsigned int logicalSliceAddr);
+void SetMappedVsa(unsigned int logicalSliceAddr, unsigned int virtualSliceAddr);
+void MoveMapToHmb();
+void MoveMapToNand();
+
+extern P_MAP_CACHE mapCachePtr;
+
+#define MAP_CACHE_ENTRY_ADDR(iEntry) (MAP_CACHE_BASE_ADDR + (iEntry) * BYTES_PER_MAP_CACHE_ENTRY)
+
+#endif /* MAP_CACHE_H_ */
@@ -0,0 +1,280 @@
+//////////////////////////////////////////////////////////////////////////////////
+// map_extent.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Map Extent
+// File Name: map_extent.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - look up and update the extent-compressed map segments
+//   - convert a map segment between extents and per-slice entries
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "map_cache.h"
+#include "namespace.h"
+
+/**
+ * @brief Get the virtual slice of the k-th logical slice of the specified extent.
+ *
+ * @param extent the target extent.
+ * @param k the index of the logical slice in the extent, may be equal to the length of the
+ * extent to predict the virtual slice of the next logical slice.
+ * @return unsigned int the virtual slice address.
+ */
+static unsigned int GetExtentVsa(P_MAP_EXTENT extent, unsigned int k)
+{
+    unsigned int pos = extent->phase + k;
+
+    return extent->startVsa - extent->phase + pos % extent->width + (pos / extent->width) * USER_DIES;
+}
+
+/**
+ * @brief Initialize a single-slice extent, striped over the die set of its namespace.
+ *
+ * If the virtual slice is not on the die set (e.g. moved by the GC of a shared die), the
+ * extent is treated as a run on a single die.
+ *
+ * @param extent the extent to be initialized.
+ * @param logicalSliceAddr the logical slice address.
+ * @param virtualSliceAddr the mapped virtual slice address.
+ */
+static void InitExtent(P_MAP_EXTENT extent, unsigned int logicalSliceAddr, unsigned int virtualSliceAddr)
+{
+    unsigned int nsid, dieNo;
+    NAMESPACE_ENTRY *ns;
+
+    extent->startVsa  = virtualSliceAddr;
+    extent->offset    = logicalSliceAddr % SLICES_PER_MAP_SEGMENT;
+    extent->length    = 1;
+    extent->width     = 1;
+    extent->phase     = 0;
+    extent->reserved0 = 0;
+
+    nsid = GetNamespaceId(logicalSliceAddr);
+    if (nsid == NSID_NONE)
+        return;
+
+    ns    = NS_ENTRY(nsid);
+    dieNo = Vsa2VdieTranslation(virtualSliceAddr);
+    if ((dieNo >= ns->firstDie) && (dieNo < ns->firstDie + ns->numOfDie))
+    {
+        extent->width = ns->numOfDie;
+        extent->phase = dieNo - ns->firstDie;
+    }
+}
+
+/**
+ * @brief Check whether the second extent continues the first one.
+ *
+ * @return unsigned int 1 if the two extents can be merged into the first one, otherwise 0.
+ */
+static unsigned int IsExtentContinued(P_MAP_EXTENT first, P_MAP_EXTENT second)
+{
+    return (first->offset + first->length == second->offset) && (first->width == second->width) &&
+           ((first->phase + first->length) % first->width == second->phase) &&
+           (GetExtentVsa(first, first->length) == second->startVsa);
+}
+
+/**
+ * @brief Get the mapped virtual slice of the specified logical slice from the extents.
+ *
+ * @param extentList the extents of the segment, must be compressed.
+ * @param logicalSliceAddr the logical slice address.
+ * @return unsigned int the virtual slice address, or `VSA_NONE` if not mapped.
+ */
+unsigned int LookupMapExtent(P_MAP_EXTENT_LIST extentList, unsigned int logicalSliceAddr)
+{
+    unsigned int offset = logicalSliceAddr % SLICES_PER_MAP_SEGMENT;
+    unsigned int iExtent;
+    P_MAP_EXTENT extent;
+
+    for (iExtent = 0; iExtent < extentList->extentCnt; iExtent++)
+    {
+        extent = &extentList->extent[iExtent];
+        if (offset < extent->offset)
+            break;
+        if (offset < extent->offset + extent->length)
+            return GetExtentVsa(extent, offset - extent->offset);
+    }
+
+    return VSA_NONE;
+}
+
+/**
+ * @brief Update the mapped virtual slice of the specified logical slice in the extents.
+ *
+ * The logical slice is first cut out of the extent covering it, which may split the extent
+ * into two. Then the new location is appended to the extent ending right before it if the
+ * location is the predicted one, otherwise a new extent is inserted, and the extent right
+ * after it is merged if possible.
+ *
+ * @param extentList the extents of the segment, must be compressed.
+ * @param logicalSliceAddr the logical slice address.
+ * @param virtualSliceAddr the new virtual slice address, or `VSA_NONE` to unmap.
+ * @return unsigned int 1 if updated, or 0 if the segment needs more than
+ * `MAP_EXTENTS_PER_SEGMENT` extents, in which case the extents are not modified.
+ */
+unsigned int UpdateMapExtent(P_MAP_EXTENT_LIST extentList, unsigned int logicalSliceAddr,
+                             unsigned int virtualSliceAddr)
+{
+    MAP_EXTENT extent[MAP_EXTENTS_PER_SEGMENT + 2];
+    unsigned int offset = logicalSliceAddr % SLICES_PER_MAP_SEGMENT;
+    unsigned int iExtent, extentCnt, k, iNew;
+    P_MAP_EXTENT cur;
+
+    // cut the logical slice out
+    extentCnt = 0;
+    for (iExtent = 0; iExtent < extentList->extentCnt; iExtent++)
+    {
+        cur = &extentList->extent[iExtent];
+        if ((offset < cur->offset) || (offset >= cur->offset + cur->length))
+        {
+            extent[extentCnt++] = *cur;
+            continue;
+        }
+
+        k = offset - cur->offset;
+        if (k > 0)
+        {
+            extent[extentCnt]        = *cur;
+            extent[extentCnt].length = k;
+            extentCnt++;
+        }
+        if (k + 1 < cur->length)
+        {
+            extent[extentCnt]          = *cur;
+            extent[extentCnt].startVsa = GetExtentVsa(cur, k + 1);
+            extent[extentCnt].offset   = offset + 1;
+            extent[extentCnt].length   = cur->length - k - 1;
+            extent[extentCnt].phase    = (cur->phase + k + 1) % cur->width;
+            extentCnt++;
+        }
+    }
+
+    if (virtualSliceAddr != VSA_NONE)
+    {
+        for (iNew = 0; (iNew < extentCnt) && (extent[iNew].offset < offset); iNew++)
+            ;
+
+        if ((iNew > 0) && (extent[iNew - 1].offset + extent[iNew - 1].length == offset) &&
+            (GetExtentVsa(&extent[iNew - 1], extent[iNew - 1].length) == virtualSliceAddr))
+        {
+            iNew--;
+            extent[iNew].length++;
+        }
+        else
+        {
+            memmove(&extent[iNew + 1], &extent[iNew], (extentCnt - iNew) * sizeof(MAP_EXTENT));
+            InitExtent(&extent[iNew], logicalSliceAddr, virtualSliceAddr);
+            extentCnt++;
+        }
+
+        if ((iNew + 1 < extentCnt) && IsExtentContinued(&extent[iNew], &extent[iNew + 1]))
+        {
+            extent[iNew].length += extent[iNew + 1].length;
+            memmove(&extent[iNew + 1], &extent[iNew + 2], (extentCnt - iNew - 2) * sizeof(MAP_EXTENT));
+            extentCnt--;
+        }
+    }
+
+    if (extentCnt > MAP_EXTENTS_PER_SEGMENT)
+        return 0;
+
+    memcpy(extentList->extent, extent, extentCnt * sizeof(MAP_EXTENT));
+    extentList->extentCnt = extentCnt;
+
+    return 1;
+}
+
+/**
+ * @brief Compress the per-slice entries of a segment into extents.
+ *
+ * @param extentList the extents to be built, not modified on failure.
+ * @param firstLsa the first logical slice address of the segment.
+ * @param segmentData the per-slice entries of the segment.
+ * @return unsigned int 1 if compressed, or 0 if more than `MAP_EXTENTS_PER_SEGMENT` extents
+ * are needed.
+ */
+unsigned int PackMapExtent(P_MAP_EXTENT_LIST extentList, unsigned int firstLsa, P_LOGICAL_SLICE_ENTRY segmentData)
+{
+    MAP_EXTENT extent[MAP_EXTENTS_PER_SEGMENT];
+    unsigned int offset, virtualSliceAddr, extentCnt;
+    P_MAP_EXTENT last;
+
+    extentCnt = 0;
+    for (offset = 0; offset < SLICES_PER_MAP_SEGMENT; offset++)
+    {
+        virtualSliceAddr = segmentData[offset].virtualSliceAddr;
+        if (virtualSliceAddr == VSA_NONE)
+            continue;
+
+        if (extentCnt > 0)
+        {
+            last = &extent[extentCnt - 1];
+            if ((last->offset + last->length == offset) && (GetExtentVsa(last, last->length) == virtualSliceAddr))
+            {
+                last->length++;
+                continue;
+            }
+        }
+
+        if (extentCnt == MAP_EXTENTS_PER_SEGMENT)
+            return 0;
+        InitExtent(&extent[extentCnt++], firstLsa + offset, virtualSliceAddr);
+    }
+
+    memcpy(extentList->extent, extent, extentCnt * sizeof(MAP_EXTENT));
+    extentList->extentCnt = extentCnt;
+
+    return 1;
+}
+
+/**
+ * @brief Expand the extents of a segment into per-slice entries.
+ *
+ * @param extentList the extents of the segment, must be compressed.
+ * @param segmentData the per-slice entries to be filled.
+ */
+void UnpackMapExtent(P_MAP_EXTENT_LIST extentList, P_LOGICAL_SLICE_ENTRY segmentData)
+{
+    unsigned int iExtent, k;
+    P_MAP_EXTENT extent;
+
+    memset(segmentData, 0xFF, BYTES_PER_MAP_SEGMENT); // all `VSA_NONE`
+
+    for (iExtent = 0; iExtent < extentList->extentCnt; iExtent++)
+    {
+        extent = &extentList->extent[iExtent];
+        for (k = 0; k < extent->length; k++)
+            segmentData[extent->offset + k].virtualSliceAddr = GetExtentVsa(extent, k);
+    }
+}
@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////////
+// map_extent.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Map Extent
+// File Name: map_extent.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define the extent-compressed representation of a map segment
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MAP_EXTENT_H_
+#define MAP_EXTENT_H_
+
+#include "ftl_config.h"
+#include "address_translation.h"
+
+#define MAP_EXTENTS_PER_SEGMENT 8    // user configurable factor, the max extents of a compressed segment
+#define MAP_EXTENT_CNT_EXPANDED 0xff // the segment is kept in per-slice entries
+
+/**
+ * @brief A run of logical slices whose virtual slices follow the die striping.
+ *
+ * The sequential writes of a namespace are spread over its die set in round-robin, check
+ * `FindDieForFreeSliceAllocation()`, so the k-th logical slice of a run lands on the next
+ * die of the stripe, and on the next page once the stripe wraps. Since the virtual slices
+ * of the same page are grouped together, check `Vorg2VsaTranslation()`, the location of
+ * any slice of the run is derived from its first slice, check `GetExtentVsa()`.
+ *
+ * A run over a single die (`width` 1) is simply a run of consecutive pages.
+ */
+typedef struct _MAP_EXTENT
+{
+    unsigned int startVsa;    // the virtual slice of the first logical slice
+    unsigned short offset;    // the offset of the first logical slice in the segment
+    unsigned short length;    // the number of logical slices
+    unsigned char width;      // the number of dies the run is striped over
+    unsigned char phase;      // the position of the first logical slice in the stripe
+    unsigned short reserved0;
+} MAP_EXTENT, *P_MAP_EXTENT;
+
+/**
+ * @brief The extents of a map segment, sorted by offset and never overlapped.
+ *
+ * The logical slices not covered by any extent are unmapped. A lookup scans at most
+ * `MAP_EXTENTS_PER_SEGMENT` extents, so a segment that needs more extents is expanded to
+ * per-slice entries instead, check `UpdateMapExtent()`.
+ */
+typedef struct _MAP_EXTENT_LIST
+{
+    unsigned int extentCnt; // `MAP_EXTENT_CNT_EXPANDED` if the segment is not compressed
+    MAP_EXTENT extent[MAP_EXTENTS_PER_SEGMENT];
+} MAP_EXTENT_LIST, *P_MAP_EXTENT_LIST;
+
+unsigned int LookupMapExtent(P_MAP_EXTENT_LIST extentList, unsigned int logicalSliceAddr);
+unsigned int UpdateMapExtent(P_MAP_EXTENT_LIST extentList, unsigned int logicalSliceAddr,
+                             unsigned int virtualSliceAddr);
+unsigned int PackMapExtent(P_MAP_EXTENT_LIST extentList, unsigned int firstLsa, P_LOGICAL_SLICE_ENTRY segmentData);
+void UnpackMapExtent(P_MAP_EXTENT_LIST extentList, P_LOGICAL_SLICE_ENTRY segmentData);
+
+#endif /* MAP_EXTENT_H_ */
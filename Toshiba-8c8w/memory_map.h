@@ -53,6 +53,11 @@
 #include "request_schedule.h"
 #include "request_transform.h"
 #include "garbage_collection.h"
+#include "statistics.h"
+#include "namespace.h"
+#include "map_cache.h"
+#include "wear_leveling.h"
+#include "write_throttle.h"
 
 #define DRAM_START_ADDR 0x00100000
 
@@ -85,6 +90,8 @@
 #define RESERVED_DATA_BUFFER_BASE_ADDR                                                                            \
     (TEMPORARY_SPARE_DATA_BUFFER_BASE_ADDR +                                                                      \
      AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_SPARE_REGION_OF_SLICE)
+// for the cached segments of the logical slice map in the DFTL mode, empty otherwise
+#define MAP_CACHE_BASE_ADDR (RESERVED_DATA_BUFFER_BASE_ADDR + 0x00200000)
 // for nand request completion
 #define COMPLETE_FLAG_TABLE_ADDR 0x17000000
 #define STATUS_REPORT_TABLE_ADDR (COMPLETE_FLAG_TABLE_ADDR + sizeof(COMPLETE_FLAG_TABLE))
@@ -97,8 +104,17 @@
 #define TEMPORARY_DATA_BUFFER_MAP_ADDR (DATA_BUFFFER_HASH_TABLE_ADDR + sizeof(DATA_BUF_HASH_TABLE))
 // for map tables
 #define LOGICAL_SLICE_MAP_ADDR        (TEMPORARY_DATA_BUFFER_MAP_ADDR + sizeof(TEMPORARY_DATA_BUF_MAP))
-#define VIRTUAL_SLICE_MAP_ADDR        (LOGICAL_SLICE_MAP_ADDR + sizeof(LOGICAL_SLICE_MAP))
-#define VIRTUAL_BLOCK_MAP_ADDR        (VIRTUAL_SLICE_MAP_ADDR + sizeof(VIRTUAL_SLICE_MAP))
+#if SUPPORT_DFTL && defined(HMB_SIMULATION)
+// the simulated HMB holds the paged logical slice map, it is only accessed by `memcpy()`
+#define HMB_SIM_BUFFER_ADDR  LOGICAL_SLICE_MAP_ADDR
+#define VALID_SLICE_MAP_ADDR (HMB_SIM_BUFFER_ADDR + sizeof(LOGICAL_SLICE_MAP))
+#elif SUPPORT_DFTL
+// the logical slice map is paged on NAND or in the HMB, no space is allocated for it
+#define VALID_SLICE_MAP_ADDR LOGICAL_SLICE_MAP_ADDR
+#else
+#define VALID_SLICE_MAP_ADDR (LOGICAL_SLICE_MAP_ADDR + sizeof(LOGICAL_SLICE_MAP))
+#endif
+#define VIRTUAL_BLOCK_MAP_ADDR        (VALID_SLICE_MAP_ADDR + sizeof(VALID_SLICE_MAP))
 #define PHY_BLOCK_MAP_ADDR            (VIRTUAL_BLOCK_MAP_ADDR + sizeof(VIRTUAL_BLOCK_MAP))
 #define BAD_BLOCK_TABLE_INFO_MAP_ADDR (PHY_BLOCK_MAP_ADDR + sizeof(PHY_BLOCK_MAP))
 #define VIRTUAL_DIE_MAP_ADDR          (BAD_BLOCK_TABLE_INFO_MAP_ADDR + sizeof(BAD_BLOCK_TABLE_INFO_MAP))
@@ -113,8 +129,10 @@
 #define DIE_STATE_TABLE_ADDR    (ROW_ADDR_DEPENDENCY_TABLE_ADDR + sizeof(ROW_ADDR_DEPENDENCY_TABLE))
 #define RETRY_LIMIT_TABLE_ADDR  (DIE_STATE_TABLE_ADDR + sizeof(DIE_STATE_TABLE))
 #define WAY_PRIORITY_TABLE_ADDR (RETRY_LIMIT_TABLE_ADDR + sizeof(RETRY_LIMIT_TABLE))
+// for map cache
+#define MAP_CACHE_ADDR (WAY_PRIORITY_TABLE_ADDR + sizeof(WAY_PRIORITY_TABLE))
 
-#define FTL_MANAGEMENT_END_ADDR ((WAY_PRIORITY_TABLE_ADDR + sizeof(WAY_PRIORITY_TABLE)) - 1)
+#define FTL_MANAGEMENT_END_ADDR ((MAP_CACHE_ADDR + sizeof(MAP_CACHE)) - 1)
 
 #define RESERVED1_START_ADDR (FTL_MANAGEMENT_END_ADDR + 1)
 #define RESERVED1_END_ADDR   0x3FFFFFFF
@@ -0,0 +1,334 @@
+//////////////////////////////////////////////////////////////////////////////////
+// namespace.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Namespace Manager
+// File Name: namespace.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - manage the LSA range, the over-provisioning space and the die set of each namespace
+//   - create the default namespace that spans the whole storage
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <string.h>
+#include "debug.h"
+#include "xil_printf.h"
+#include "memory_map.h"
+
+NAMESPACE_MAP nsMap;
+
+/**
+ * @brief Count the usable slices of each die and create the default namespace.
+ *
+ * The bad blocks and one free block (reserved for GC) of each die are not usable. The
+ * default namespace spans all the dies with the capacity `storageCapacity_L`, and all the
+ * remaining usable slices are reserved as its over-provisioning space, so it behaves the
+ * same as the single namespace before. The host should delete it before creating its own
+ * namespaces, check `handle_namespace_management()`.
+ *
+ * @note This function should be called after `storageCapacity_L` is determined.
+ */
+void InitNamespace()
+{
+    unsigned int dieNo, blockNo, usableBlockCnt, minDieSlice, numOfSlice, opPercent, nsid;
+
+    memset(&nsMap, 0, sizeof(NAMESPACE_MAP));
+
+    minDieSlice = SLICES_PER_SSD;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+    {
+        usableBlockCnt = 0;
+        for (blockNo = 0; blockNo < FTL_BLOCKS_PER_DIE; blockNo++)
+            if (!VBLK_BAD(dieNo, blockNo))
+                usableBlockCnt++;
+
+        // one free block should be reserved for GC
+        nsMap.dieSlice[dieNo] = (usableBlockCnt > 1) ? (usableBlockCnt - 1) * SLICES_PER_BLOCK : 0;
+
+#if SUPPORT_DFTL
+        // the valid translation pages are spread over the dies, check `FindFreeVirtualSliceForMapSegment()`
+        nsMap.dieSlice[dieNo] -= (nsMap.dieSlice[dieNo] > MAP_SEGMENTS_PER_DIE) ? MAP_SEGMENTS_PER_DIE
+                                                                                : nsMap.dieSlice[dieNo];
+#endif
+        if (minDieSlice > nsMap.dieSlice[dieNo])
+            minDieSlice = nsMap.dieSlice[dieNo];
+    }
+
+    numOfSlice = storageCapacity_L / NVME_BLOCKS_PER_SLICE;
+    opPercent  = (minDieSlice * USER_DIES - numOfSlice) * 100 / numOfSlice;
+
+    nsid = CreateNamespace(numOfSlice, opPercent, 0, USER_DIES);
+    if (nsid != DEFAULT_NS_ID)
+        assert(!"[WARNING] Failed to create the default namespace [WARNING]");
+    NS_ENTRY(nsid)->attached = 1;
+
+    xil_printf("[ namespace %d: %d MB, over-provisioning %d%% ]\r\n", nsid,
+               numOfSlice / ((1024 * 1024) / BYTES_PER_DATA_REGION_OF_SLICE), opPercent);
+}
+
+/**
+ * @brief Check whether the LSA range overlaps with any allocated namespace.
+ *
+ * @param startLsa the first logical slice of the range.
+ * @param numOfSlice the number of slices of the range.
+ * @return unsigned int 1 if the range is free, otherwise 0.
+ */
+static unsigned int isLsaRangeFree(unsigned int startLsa, unsigned int numOfSlice)
+{
+    unsigned int nsid;
+    NAMESPACE_ENTRY *ns;
+
+    if (startLsa + numOfSlice > SLICES_PER_SSD)
+        return 0;
+
+    for (nsid = 1; nsid <= MAX_NUM_OF_NAMESPACE; nsid++)
+    {
+        ns = NS_ENTRY(nsid);
+        if (ns->allocated && (startLsa < ns->startLsa + ns->numOfSlice) && (ns->startLsa < startLsa + numOfSlice))
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Find a free LSA range for a new namespace.
+ *
+ * The candidates are the beginning of the logical slice map and the end of each allocated
+ * namespace, the first one that fits is selected.
+ *
+ * @param numOfSlice the capacity of the new namespace in slices.
+ * @return unsigned int the first logical slice of the range, or `LSA_NONE` if not found.
+ */
+static unsigned int findFreeLsaRange(unsigned int numOfSlice)
+{
+    unsigned int nsid;
+
+    if (isLsaRangeFree(0, numOfSlice))
+        return 0;
+
+    for (nsid = 1; nsid <= MAX_NUM_OF_NAMESPACE; nsid++)
+        if (NS_ENTRY(nsid)->allocated && isLsaRangeFree(NS_ENTRY(nsid)->startLsa + NS_ENTRY(nsid)->numOfSlice,
+                                                        numOfSlice))
+            return NS_ENTRY(nsid)->startLsa + NS_ENTRY(nsid)->numOfSlice;
+
+    return LSA_NONE;
+}
+
+/**
+ * @brief Get the number of slices committed on each die of the die set of a namespace.
+ *
+ * @param ns the target namespace.
+ * @return unsigned int the committed slices on each die, including the OP space.
+ */
+static unsigned int getCommittedSlicePerDie(NAMESPACE_ENTRY *ns)
+{
+    return (ns->numOfSlice + ns->opSlice + ns->numOfDie - 1) / ns->numOfDie;
+}
+
+/**
+ * @brief Allocate a new namespace, the new namespace is detached.
+ *
+ * The capacity and the over-provisioning space are committed evenly on the given die set,
+ * and the namespace is created only if all of its dies have enough uncommitted slices.
+ *
+ * @param numOfSlice the capacity of the new namespace in slices.
+ * @param opPercent the over-provisioning space in percentage of the capacity.
+ * @param firstDie the first die of the die set.
+ * @param numOfDie the number of dies of the die set, 0 for all the dies.
+ * @return unsigned int the NSID of the new namespace, or `NSID_NONE` if failed.
+ */
+unsigned int CreateNamespace(unsigned int numOfSlice, unsigned int opPercent, unsigned int firstDie,
+                             unsigned int numOfDie)
+{
+    unsigned int nsid, dieNo, startLsa, slicePerDie;
+    NAMESPACE_ENTRY *ns;
+
+    if (numOfDie == 0)
+    {
+        firstDie = 0;
+        numOfDie = USER_DIES;
+    }
+
+    if ((numOfSlice == 0) || (opPercent > 0xff) || (firstDie >= USER_DIES) || (numOfDie > USER_DIES - firstDie))
+        return NSID_NONE;
+
+    for (nsid = 1; nsid <= MAX_NUM_OF_NAMESPACE; nsid++)
+        if (!NS_ENTRY(nsid)->allocated)
+            break;
+    if (nsid > MAX_NUM_OF_NAMESPACE)
+        return NSID_NONE;
+
+    ns             = NS_ENTRY(nsid);
+    ns->numOfSlice = numOfSlice;
+    ns->opPercent  = opPercent;
+    ns->opSlice    = (unsigned int)((unsigned long long)numOfSlice * opPercent / 100);
+    ns->firstDie   = firstDie;
+    ns->numOfDie   = numOfDie;
+    ns->targetDie  = firstDie;
+
+    slicePerDie = getCommittedSlicePerDie(ns);
+    for (dieNo = firstDie; dieNo < firstDie + numOfDie; dieNo++)
+        if (nsMap.dieCommittedSlice[dieNo] + slicePerDie > nsMap.dieSlice[dieNo])
+            return NSID_NONE;
+
+    startLsa = findFreeLsaRange(numOfSlice);
+    if (startLsa == LSA_NONE)
+        return NSID_NONE;
+
+    for (dieNo = firstDie; dieNo < firstDie + numOfDie; dieNo++)
+        nsMap.dieCommittedSlice[dieNo] += slicePerDie;
+
+    ns->startLsa  = startLsa;
+    ns->attached  = 0;
+    ns->allocated = 1;
+
+    return nsid;
+}
+
+/**
+ * @brief Delete the specified namespace and release its capacity.
+ *
+ * All the pending requests are completed first, then the cached slices of the namespace
+ * are dropped from the data buffer without being written back, and all the logical slices
+ * of the namespace are unmapped, so the new namespaces will not see the old data.
+ *
+ * @param nsid the NSID of an allocated namespace.
+ */
+void DeleteNamespace(unsigned int nsid)
+{
+    unsigned int bufEntry, lsa, dieNo, slicePerDie;
+    NAMESPACE_ENTRY *ns;
+
+    if (!IsNamespaceAllocated(nsid))
+        assert(!"[WARNING] Try to delete an unallocated namespace [WARNING]");
+
+    ns = NS_ENTRY(nsid);
+
+    SyncAllLowLevelReqDone();
+
+    for (bufEntry = 0; bufEntry < AVAILABLE_DATA_BUFFER_ENTRY_COUNT; bufEntry++)
+    {
+        lsa = dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr;
+        if ((lsa != LSA_NONE) && (lsa >= ns->startLsa) && (lsa < ns->startLsa + ns->numOfSlice))
+        {
+            dataBufMapPtr->dataBuf[bufEntry].dirty = DATA_BUF_CLEAN;
+            SelectiveGetFromDataBufHashList(bufEntry);
+            dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr = LSA_NONE;
+        }
+    }
+
+    for (lsa = ns->startLsa; lsa < ns->startLsa + ns->numOfSlice; lsa++)
+        AddrTransUnmap(lsa);
+
+    slicePerDie = getCommittedSlicePerDie(ns);
+    for (dieNo = ns->firstDie; dieNo < ns->firstDie + ns->numOfDie; dieNo++)
+        nsMap.dieCommittedSlice[dieNo] -= slicePerDie;
+
+    memset(ns, 0, sizeof(NAMESPACE_ENTRY));
+}
+
+unsigned int IsNamespaceAllocated(unsigned int nsid)
+{
+    return (nsid != NSID_NONE) && (nsid <= MAX_NUM_OF_NAMESPACE) && NS_ENTRY(nsid)->allocated;
+}
+
+unsigned int IsNamespaceAttached(unsigned int nsid)
+{
+    return IsNamespaceAllocated(nsid) && NS_ENTRY(nsid)->attached;
+}
+
+/**
+ * @brief Get the namespace that owns the specified logical slice.
+ *
+ * @param logicalSliceAddr the target logical slice.
+ * @return unsigned int the NSID, or `NSID_NONE` if the slice belongs to no namespace.
+ */
+unsigned int GetNamespaceId(unsigned int logicalSliceAddr)
+{
+    unsigned int nsid;
+    NAMESPACE_ENTRY *ns;
+
+    for (nsid = 1; nsid <= MAX_NUM_OF_NAMESPACE; nsid++)
+    {
+        ns = NS_ENTRY(nsid);
+        if (ns->allocated && (logicalSliceAddr >= ns->startLsa) &&
+            (logicalSliceAddr < ns->startLsa + ns->numOfSlice))
+            return nsid;
+    }
+
+    return NSID_NONE;
+}
+
+/**
+ * @brief Get the capacity of the specified namespace in NVMe blocks.
+ */
+unsigned int GetNamespaceCapacity(unsigned int nsid)
+{
+    return NS_ENTRY(nsid)->numOfSlice * NVME_BLOCKS_PER_SLICE;
+}
+
+/**
+ * @brief Get the LBA in the logical slice map of the first NVMe block of the namespace.
+ */
+unsigned int GetNamespaceStartLba(unsigned int nsid)
+{
+    return NS_ENTRY(nsid)->startLsa * NVME_BLOCKS_PER_SLICE;
+}
+
+/**
+ * @brief Get the usable capacity of all the dies in NVMe blocks.
+ */
+unsigned int GetTotalCapacity()
+{
+    unsigned int dieNo, numOfSlice;
+
+    numOfSlice = 0;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        numOfSlice += nsMap.dieSlice[dieNo];
+
+    return numOfSlice * NVME_BLOCKS_PER_SLICE;
+}
+
+/**
+ * @brief Get the uncommitted capacity of all the dies in NVMe blocks.
+ */
+unsigned int GetUnallocatedCapacity()
+{
+    unsigned int dieNo, numOfSlice;
+
+    numOfSlice = 0;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        numOfSlice += nsMap.dieSlice[dieNo] - nsMap.dieCommittedSlice[dieNo];
+
+    return numOfSlice * NVME_BLOCKS_PER_SLICE;
+}
@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////////////////
+// namespace.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Namespace Manager
+// File Name: namespace.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define the namespace table and the per-die capacity accounting
+//   - define the functions for creating, deleting and looking up namespaces
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NAMESPACE_H_
+#define NAMESPACE_H_
+
+#include "ftl_config.h"
+
+#define MAX_NUM_OF_NAMESPACE 8 // NN, the namespace IDs are 1 ~ NN
+
+#define NSID_NONE 0
+
+#define DEFAULT_NS_ID 1
+
+/**
+ * @brief The info of a namespace.
+ *
+ * Each namespace owns a contiguous range of logical slices in the logical slice map, so
+ * the LBA of a namespace is translated into the LSA space by simply adding `startLsa`.
+ *
+ * The slices of a namespace are only allocated on its die set, which is a contiguous range
+ * of dies, and the GC of a die only moves the slices within the die sets of the namespaces
+ * on that die. So the namespaces with disjoint die sets never share a block, and the GC
+ * triggered by one of them never runs on the dies of the others.
+ *
+ * @note The dies are numbered channel first, check `Pcw2VdieTranslation()`, so a die set
+ * of `USER_CHANNELS` dies still spreads over all the channels.
+ */
+typedef struct _NAMESPACE_ENTRY
+{
+    unsigned int allocated : 1;
+    unsigned int attached : 1;
+    unsigned int opPercent : 8;  // the over-provisioning space in percentage of the capacity
+    unsigned int reserved0 : 22;
+    unsigned int startLsa;       // the first logical slice of this namespace
+    unsigned int numOfSlice;     // the capacity in slices
+    unsigned int opSlice;        // the over-provisioning slices reserved for this namespace
+    unsigned short firstDie;     // the first die of the die set
+    unsigned short numOfDie;     // the number of dies of the die set
+    unsigned int targetDie;      // the die to serve the next write, check `FindDieForFreeSliceAllocation()`
+} NAMESPACE_ENTRY;
+
+/**
+ * @brief The namespace table and the capacity accounting of each die.
+ *
+ * The capacity and the over-provisioning space of a namespace are committed evenly on the
+ * dies of its die set, and a namespace can only be created if none of its dies is over
+ * committed. So the over-provisioning space of a namespace is never consumed by the data
+ * of the others, even if they share some dies.
+ */
+typedef struct _NAMESPACE_MAP
+{
+    NAMESPACE_ENTRY ns[MAX_NUM_OF_NAMESPACE]; // indexed by NSID - 1
+    unsigned int dieSlice[USER_DIES];         // the usable slices of each die
+    unsigned int dieCommittedSlice[USER_DIES]; // the slices committed to the namespaces on each die
+} NAMESPACE_MAP;
+
+void InitNamespace();
+unsigned int CreateNamespace(unsigned int numOfSlice, unsigned int opPercent, unsigned int firstDie,
+                             unsigned int numOfDie);
+void DeleteNamespace(unsigned int nsid);
+unsigned int IsNamespaceAllocated(unsigned int nsid);
+unsigned int IsNamespaceAttached(unsigned int nsid);
+unsigned int GetNamespaceId(unsigned int logicalSliceAddr);
+unsigned int GetNamespaceCapacity(unsigned int nsid);
+unsigned int GetNamespaceStartLba(unsigned int nsid);
+unsigned int GetTotalCapacity();
+unsigned int GetUnallocatedCapacity();
+
+extern NAMESPACE_MAP nsMap;
+
+#define NS_ENTRY(nsid) (&nsMap.ns[(nsid)-1])
+
+#endif /* NAMESPACE_H_ */
@@ -243,20 +243,27 @@ unsigned int get_nvme_cmd(unsigned short *qID, unsigned short *cmdSlotTag, unsig
 
     if (nvmeReg.cmdValid == 1)
     {
-        unsigned int addr;
-        unsigned int idx;
         *qID        = nvmeReg.qID;
         *cmdSlotTag = nvmeReg.cmdSlotTag;
         *cmdSeqNum  = nvmeReg.cmdSeqNum;
         // xil_printf("nvmeReg.cmdSlotTag = 0x%X\r\n", nvmeReg.cmdSlotTag);
-        addr = NVME_CMD_SRAM_ADDR + (nvmeReg.cmdSlotTag * 64);
-        for (idx = 0; idx < 16; idx++)
-            *(cmdDword + idx) = IO_READ32(addr + (idx * 4));
+        get_nvme_cmd_dword(nvmeReg.cmdSlotTag, cmdDword);
     }
 
     return (unsigned int)nvmeReg.cmdValid;
 }
 
+void get_nvme_cmd_dword(unsigned int cmdSlotTag, unsigned int *cmdDword)
+{
+    unsigned int addr;
+    unsigned int idx;
+
+    // the command stays in the command SRAM until its slot is released
+    addr = NVME_CMD_SRAM_ADDR + (cmdSlotTag * 64);
+    for (idx = 0; idx < 16; idx++)
+        *(cmdDword + idx) = IO_READ32(addr + (idx * 4));
+}
+
 void set_auto_nvme_cpl(unsigned int cmdSlotTag, unsigned int specific, unsigned int statusFieldWord)
 {
     NVME_CPL_FIFO_REG nvmeReg;
@@ -388,7 +395,7 @@ void set_auto_tx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigne
     HOST_DMA_CMD_FIFO_REG hostDmaReg;
     unsigned char tempTail;
 
-    ASSERT(cmd4KBOffset < 256);
+    ASSERT(cmd4KBOffset < MAX_NUM_OF_NLB);
 
     g_hostDmaStatus.fifoHead.dword = IO_READ32(HOST_DMA_FIFO_CNT_REG_ADDR);
     while ((g_hostDmaStatus.fifoTail.autoDmaTx + 1) % 256 == g_hostDmaStatus.fifoHead.autoDmaTx)
@@ -422,7 +429,7 @@ void set_auto_rx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigne
     HOST_DMA_CMD_FIFO_REG hostDmaReg;
     unsigned char tempTail;
 
-    ASSERT(cmd4KBOffset < 256);
+    ASSERT(cmd4KBOffset < MAX_NUM_OF_NLB);
 
     g_hostDmaStatus.fifoHead.dword = IO_READ32(HOST_DMA_FIFO_CNT_REG_ADDR);
     while ((g_hostDmaStatus.fifoTail.autoDmaRx + 1) % 256 == g_hostDmaStatus.fifoHead.autoDmaRx)
@@ -355,6 +355,8 @@ void set_nvme_admin_queue(unsigned int sqValid, unsigned int cqValid, unsigned i
 unsigned int get_nvme_cmd(unsigned short *qID, unsigned short *cmdSlotTag, unsigned int *cmdSeqNum,
                           unsigned int *cmdDword);
 
+void get_nvme_cmd_dword(unsigned int cmdSlotTag, unsigned int *cmdDword);
+
 void set_auto_nvme_cpl(unsigned int cmdSlotTag, unsigned int specific, unsigned int statusFieldWord);
 
 void set_nvme_slot_release(unsigned int cmdSlotTag);
@@ -54,12 +54,24 @@
 #define MAX_NUM_OF_IO_SQ 8
 #define MAX_NUM_OF_IO_CQ 8
 
+#define MAX_NUM_OF_IRQ_VECTOR 8 // the IV of I/O CQ is limited to 3 bits by the controller
+
 #define ADMIN_CMD_DRAM_DATA_BUFFER 0x00200000
+#define IO_CMD_DRAM_DATA_BUFFER    0x00201000 // for the data structures of I/O commands, e.g. Copy ranges
 
 #define STORAGE_CAPACITY_L 0x00000000 // not used
 #define STORAGE_CAPACITY_H 0x00000000
 
-#define MAX_NUM_OF_NLB (512 * 1024 / 4096)
+/**
+ * The Maximum Data Transfer Size is 2^MDTS pages of CAP.MPSMIN (4KB), which is limited by
+ * the 9 bits `cmd4KBOffset` of the host DMA, check `HOST_DMA_CMD_FIFO_REG`.
+ */
+#define MAX_DATA_TRANSFER_SIZE_EXP 9
+#define MAX_NUM_OF_NLB             ((4096 << MAX_DATA_TRANSFER_SIZE_EXP) / 4096)
+
+#define COPY_MAX_SOURCE_RANGES 128  // MSRC + 1, the source range entries of a Copy command fit in 4KB
+#define COPY_MAX_RANGE_LENGTH  256  // MSSRL, in NVMe blocks
+#define COPY_MAX_LENGTH        1024 // MCL, in NVMe blocks
 
 /*Opcodes for Admin Commands */
 #define ADMIN_DELETE_IO_SQ               0x00
@@ -72,20 +84,35 @@
 #define ADMIN_SET_FEATURES               0x09
 #define ADMIN_GET_FEATURES               0x0A
 #define ADMIN_ASYNCHRONOUS_EVENT_REQUEST 0x0C
+#define ADMIN_NAMESPACE_MANAGEMENT       0x0D
 #define ADMIN_FIRMWARE_ACTIVATE          0x10
 #define ADMIN_FIRMWARE_IMAGE_DOWNLOAD    0x11
+#define ADMIN_NAMESPACE_ATTACHMENT       0x15
 #define ADMIN_FORMAT_NVM                 0x80
 #define ADMIN_DOORBELL_BUFFER_CONFIG     0x7C
 #define ADMIN_SECURITY_SEND              0x81
 #define ADMIN_SECURITY_RECEIVE           0x82
+#define ADMIN_OCSSD_GEOMETRY             0xE2 /* vendor specific, report the physical geometry */
 
 /*Opcodes for IO Commands */
 #define IO_NVM_FLUSH               0x00
 #define IO_NVM_WRITE               0x01
 #define IO_NVM_READ                0x02
 #define IO_NVM_WRITE_UNCORRECTABLE 0x04 /* Not acceptable yet */
-#define IO_NVM_COMPARE             0x05 /* Not acceptable yet */
+#define IO_NVM_COMPARE             0x05
+#define IO_NVM_WRITE_ZEROES        0x08
 #define IO_NVM_DATASET_MANAGEMENT  0x09 /* Not acceptable yet */
+#define IO_NVM_COPY                0x19
+
+/* vendor specific, physical (channel, way, block, page) addressing */
+#define IO_OCSSD_PHY_ERASE 0x90
+#define IO_OCSSD_PHY_WRITE 0x91
+#define IO_OCSSD_PHY_READ  0x92
+
+/* Fused Operation (FUSE) field of the command dword 0 */
+#define NVME_FUSE_NORMAL 0x0
+#define NVME_FUSE_FIRST  0x1 // the first command (Compare) of a fused operation
+#define NVME_FUSE_SECOND 0x2 // the second command (Write) of a fused operation
 
 /*Status Code Type */
 #define SCT_GENERIC_COMMAND_STATUS          0
@@ -163,6 +190,7 @@
 #define SC_CONFLICTING_ATTRIBUTES             0x80 // Dataset Management, Read, Write
 #define SC_INVALID_PROTECTION_INFORMATION     0x81 // Compare, Read, Write, Write Zeroes
 #define SC_ATTEMPTED_WRITE_TO_READ_ONLY_RANGE 0x82 // Dataset Management, Write, Write Uncorrectable, Write Zeroes
+#define SC_COMMAND_SIZE_LIMIT_EXCEEDED        0x83 // Copy
 
 /*Status Code - Media and Data Integrity Error Values, NVM Command Set */
 #define SC_WRITE_FAULT                            0x80
@@ -188,9 +216,17 @@
 #define WRITE_ATOMICITY                  0x0A
 #define ASYNCHRONOUS_EVENT_CONFIGURATION 0x0B
 #define Power_State_Transition           0x0C
+#define HOST_MEMORY_BUFFER               0x0D
 #define Timestamp                        0x0E
 #define SOFTWARE_PROGRESS_MARKER         0x80
 
+/* Submission Queue Priority (QPRIO of Create I/O Submission Queue) */
+
+#define NVME_SQ_PRIORITY_URGENT 0x0
+#define NVME_SQ_PRIORITY_HIGH   0x1
+#define NVME_SQ_PRIORITY_MEDIUM 0x2
+#define NVME_SQ_PRIORITY_LOW    0x3
+
 #define NVME_TASK_IDLE       0x0
 #define NVME_TASK_WAIT_CC_EN 0x1
 #define NVME_TASK_RUNNING    0x2
@@ -400,6 +436,77 @@ typedef struct _ADMIN_SET_FEATURES_NUMBER_OF_QUEUES_DW11
     };
 } ADMIN_SET_FEATURES_NUMBER_OF_QUEUES_DW11;
 
+typedef struct _ADMIN_SET_FEATURES_ARBITRATION_DW11
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned char AB : 3; // arbitration burst, 2^AB commands, 111b for no limit
+            unsigned char reserved0 : 5;
+            unsigned char LPW; // low priority weight (zero-based)
+            unsigned char MPW; // medium priority weight (zero-based)
+            unsigned char HPW; // high priority weight (zero-based)
+        };
+    };
+} ADMIN_SET_FEATURES_ARBITRATION_DW11;
+
+typedef struct _ADMIN_SET_FEATURES_INTERRUPT_COALESCING_DW11
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned char THR;  // aggregation threshold (zero-based)
+            unsigned char TIME; // aggregation time in 100 microsecond
+            unsigned short reserved0;
+        };
+    };
+} ADMIN_SET_FEATURES_INTERRUPT_COALESCING_DW11;
+
+typedef struct _ADMIN_SET_FEATURES_INTERRUPT_VECTOR_CONFIGURATION_DW11
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned short IV;     // interrupt vector
+            unsigned short CD : 1; // coalescing disable
+            unsigned short reserved0 : 15;
+        };
+    };
+} ADMIN_SET_FEATURES_INTERRUPT_VECTOR_CONFIGURATION_DW11;
+
+typedef struct _ADMIN_SET_FEATURES_HOST_MEMORY_BUFFER_DW11
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned int EHM : 1; // enable host memory
+            unsigned int MR : 1;  // memory return, the host returns the buffer used previously
+            unsigned int reserved0 : 30;
+        };
+    };
+} ADMIN_SET_FEATURES_HOST_MEMORY_BUFFER_DW11;
+
+/**
+ * @brief An entry of the Host Memory Buffer Descriptor List.
+ *
+ * HMDLLA/HMDLUA (dword 13/14) of Set Features points to the list, and HMDLEC (dword 15) is
+ * the number of entries.
+ */
+typedef struct _NVME_HMB_DESCRIPTOR_ENTRY
+{
+    unsigned int BADD[2]; // the buffer address, aligned to the memory page size
+    unsigned int BSIZE;   // the buffer size in memory pages
+    unsigned int reserved0;
+} NVME_HMB_DESCRIPTOR_ENTRY;
+
 /* Get Features Command */
 typedef struct _ADMIN_GET_FEATURES_DW10
 {
@@ -510,12 +617,68 @@ typedef struct _ADMIN_IDENTIFY_COMMAND_DW10
         unsigned int dword;
         struct
         {
-            unsigned int CNS : 1;
-            unsigned int reserved0 : 31;
+            unsigned int CNS : 8;
+            unsigned int reserved0 : 8;
+            unsigned int CNTID : 16;
         };
     };
 } ADMIN_IDENTIFY_COMMAND_DW10;
 
+/* Identify - Controller or Namespace Structure */
+
+#define IDENTIFY_CNS_NAMESPACE                0x00
+#define IDENTIFY_CNS_CONTROLLER               0x01
+#define IDENTIFY_CNS_ACTIVE_NAMESPACE_LIST    0x02
+#define IDENTIFY_CNS_ALLOCATED_NAMESPACE_LIST 0x10
+#define IDENTIFY_CNS_ALLOCATED_NAMESPACE      0x11
+#define IDENTIFY_CNS_ATTACHED_CONTROLLER_LIST 0x12
+#define IDENTIFY_CNS_CONTROLLER_LIST          0x13
+
+/**
+ * @brief The controller list used by Identify and Namespace Attachment.
+ */
+typedef struct _ADMIN_CONTROLLER_LIST
+{
+    unsigned short NUMID; // the number of identifiers in the list
+    unsigned short ID[2047];
+} ADMIN_CONTROLLER_LIST;
+
+/* Namespace Management Command */
+typedef struct _ADMIN_NAMESPACE_MANAGEMENT_DW10
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned int SEL : 4;
+            unsigned int reserved0 : 28;
+        };
+    };
+} ADMIN_NAMESPACE_MANAGEMENT_DW10;
+
+#define NAMESPACE_MANAGEMENT_SEL_CREATE 0x0
+#define NAMESPACE_MANAGEMENT_SEL_DELETE 0x1
+
+/* Namespace Attachment Command */
+typedef struct _ADMIN_NAMESPACE_ATTACHMENT_DW10
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned int SEL : 4;
+            unsigned int reserved0 : 28;
+        };
+    };
+} ADMIN_NAMESPACE_ATTACHMENT_DW10;
+
+#define NAMESPACE_ATTACHMENT_SEL_ATTACH 0x0
+#define NAMESPACE_ATTACHMENT_SEL_DETACH 0x1
+
+#define NVME_NSID_ALL 0xFFFFFFFF
+
 /* Get Log Page Command */
 typedef struct _ADMIN_GET_LOG_PAGE_DW10
 {
@@ -525,13 +688,116 @@ typedef struct _ADMIN_GET_LOG_PAGE_DW10
         struct
         {
             unsigned char LID;
-            unsigned char reserved0;
+            unsigned char LSP : 4;
+            unsigned char reserved0 : 3;
+            unsigned char RAE : 1;
             unsigned short NUMD : 12;
             unsigned short reserved1 : 4;
         };
     };
 } ADMIN_GET_LOG_PAGE_DW10;
 
+/* Get Log Page - Log Page Identifiers */
+
+#define LOG_PAGE_ERROR_INFORMATION        0x01
+#define LOG_PAGE_SMART_HEALTH_INFORMATION 0x02
+#define LOG_PAGE_FIRMWARE_SLOT            0x03
+#define LOG_PAGE_VENDOR_SMART_EXTENSION   0xC0 // vendor specific, check `NVME_VENDOR_SMART_EXTENSION_LOG`
+#define LOG_PAGE_VENDOR_TELEMETRY         0xC1 // vendor specific, check `SSD_TELEMETRY`
+
+/* Get Log Page - Log Specific Field of the vendor telemetry log page */
+
+#define LOG_PAGE_TELEMETRY_LSP_RESET 0x1 // clear the counters after they are read
+
+/**
+ * @brief The SMART / Health Information log page (LID 02h).
+ *
+ * The 128 bits counters are little-endian, only the lower 64 bits are used.
+ *
+ * @sa `get_smart_health_log()`.
+ */
+typedef struct _NVME_SMART_HEALTH_LOG
+{
+    union
+    {
+        unsigned char criticalWarningByte;
+        struct
+        {
+            unsigned char availableSpareBelowThreshold : 1;
+            unsigned char temperatureExceedThreshold : 1;
+            unsigned char reliabilityDegraded : 1;
+            unsigned char readOnlyMode : 1;
+            unsigned char volatileMemoryBackupFailed : 1;
+            unsigned char reserved0 : 3;
+        } criticalWarning;
+    };
+    unsigned short compositeTemperature; // in Kelvin
+    unsigned char availableSpare;        // in percentage
+    unsigned char availableSpareThreshold;
+    unsigned char percentageUsed;
+    unsigned char reserved1[26];
+    unsigned long long dataUnitsRead[2]; // in thousands of 512 bytes, rounded up
+    unsigned long long dataUnitsWritten[2];
+    unsigned long long hostReadCommands[2];
+    unsigned long long hostWriteCommands[2];
+    unsigned long long controllerBusyTime[2];
+    unsigned long long powerCycles[2];
+    unsigned long long powerOnHours[2];
+    unsigned long long unsafeShutdowns[2];
+    unsigned long long mediaErrors[2];
+    unsigned long long numOfErrorInfoLogEntries[2];
+    unsigned int warningCompositeTemperatureTime;
+    unsigned int criticalCompositeTemperatureTime;
+    unsigned short temperatureSensor[8];
+    unsigned char reserved2[296];
+} NVME_SMART_HEALTH_LOG;
+
+/**
+ * @brief The vendor specific extension of the SMART / Health Information log page (LID C0h).
+ *
+ * Report the NAND write counters, so the write amplification can be monitored, and the
+ * erase counts of the user blocks, so the wear spread can be monitored.
+ *
+ * @sa `get_vendor_smart_ext_log()`.
+ */
+typedef struct _NVME_VENDOR_SMART_EXTENSION_LOG
+{
+    unsigned long long nandPagesWritten; // including the GC copies and metadata
+    unsigned long long gcPagesCopied;
+    unsigned long long hostSectorsWritten; // in 512 bytes
+    unsigned int bytesPerNandPage;
+    unsigned int writeAmplification; // in percentage, e.g., 150 for 1.5
+    unsigned int minEraseCnt;
+    unsigned int maxEraseCnt;
+    unsigned int avgEraseCnt;
+    unsigned int reserved0;
+    unsigned long long wlMigratedBlocks; // the cold blocks migrated by the static wear leveling
+    unsigned char reserved1[456];
+} NVME_VENDOR_SMART_EXTENSION_LOG;
+
+/**
+ * @brief The data structure returned by the vendor specific admin command `ADMIN_OCSSD_GEOMETRY`.
+ *
+ * Describe the physical address space accepted by the `IO_OCSSD_PHY_*` commands, all the
+ * numbers are non zero-based values.
+ *
+ * @sa `IO_OCSSD_PHY_COMMAND_DW10`, `identify_ocssd_geometry()`.
+ */
+typedef struct _ADMIN_OCSSD_GEOMETRY_DATA
+{
+    unsigned char version;
+    unsigned char reserved0;
+    unsigned short numOfChannels;
+    unsigned short waysPerChannel;
+    unsigned short lunsPerWay;
+    unsigned int blocksPerLun;
+    unsigned int pagesPerBlock;
+    unsigned int bytesPerPage;
+    unsigned int bytesPerSpare;
+    unsigned int bytesPerNvmeBlock;
+    unsigned char reserved1[4068];
+} ADMIN_OCSSD_GEOMETRY_DATA;
+
 /* Identify - Power State Descriptor Data Structure */
 typedef struct _ADMIN_IDENTIFY_POWER_STATE_DESCRIPTOR
 {
@@ -580,7 +846,8 @@ typedef struct _ADMIN_IDENTIFY_CONTROLLER
         unsigned short supportsSecuritySendSecurityReceive : 1;
         unsigned short supportsFormatNVM : 1;
         unsigned short supportsFirmwareActivateFirmwareDownload : 1;
-        unsigned short reserved0 : 13;
+        unsigned short supportsNamespaceManagement : 1;
+        unsigned short reserved0 : 12;
     } OACS;
 
     unsigned char ACL;
@@ -609,7 +876,20 @@ typedef struct _ADMIN_IDENTIFY_CONTROLLER
     unsigned char APSTA : 1;
     unsigned char reserved2 : 7;
 
-    unsigned char reserved3[246];
+    unsigned char reserved3[6];
+
+    unsigned int HMPRE; // the preferred size of the HMB in 4KB
+    unsigned int HMMIN; // the min size of the HMB in 4KB
+
+    unsigned int TNVMCAP[4]; // the total NVM capacity in bytes
+    unsigned int UNVMCAP[4]; // the capacity not allocated to any namespace in bytes
+
+    unsigned char reserved10[20];
+
+    unsigned int HMMINDS;  // the min size of a HMB descriptor entry in 4KB, 0 for no limit
+    unsigned short HMMAXD; // the max number of HMB descriptor entries
+
+    unsigned char reserved11[174];
 
     struct
     {
@@ -631,7 +911,10 @@ typedef struct _ADMIN_IDENTIFY_CONTROLLER
         unsigned short supportsCompare : 1;
         unsigned short supportsWriteUncorrectable : 1;
         unsigned short supportsDataSetManagement : 1;
-        unsigned short reserved0 : 13;
+        unsigned short supportsWriteZeroes : 1;
+        unsigned short reserved0 : 4;
+        unsigned short supportsCopy : 1;
+        unsigned short reserved1 : 7;
     } ONCS;
 
     struct
@@ -664,7 +947,7 @@ typedef struct _ADMIN_IDENTIFY_CONTROLLER
 
     unsigned short ACWU;
 
-    unsigned char reserved7[2];
+    unsigned short OCFS; // the supported source range entry formats of Copy
 
     struct
     {
@@ -755,13 +1038,34 @@ typedef struct _ADMIN_IDENTIFY_NAMESPACE
         unsigned char reserved0 : 2;
     } RESCAP;
 
-    unsigned char reserved0[88];
+    unsigned char FPI;
+
+    struct
+    {
+        unsigned char readBehavior : 3; // the value read from a deallocated logical block
+        unsigned char supportsDeallocateInWriteZeroes : 1;
+        unsigned char guardFieldIsCrc : 1;
+        unsigned char reserved0 : 3;
+    } DLFEAT;
+
+    unsigned char reserved0[40];
+
+    unsigned short MSSRL; // the max number of blocks of a source range of Copy
+    unsigned int MCL;     // the max number of blocks copied by a Copy command
+    unsigned char MSRC;   // the max number of source ranges of Copy, 0's based
+
+    unsigned char reserved2[39];
     unsigned char EUI64[8];
 
     ADMIN_IDENTIFY_FORMAT_DATA LBAFx[16];
 
     unsigned char reserved1[192];
-    unsigned char VS[3712];
+
+    unsigned char OPP;   // vendor specific, the over-provisioning space in percentage of NSZE
+    unsigned char reserved3;
+    unsigned short FDIE; // vendor specific, the first die of the die set
+    unsigned short NDIE; // vendor specific, the number of dies of the die set, 0 for all the dies
+    unsigned char VS[3706];
 
 } ADMIN_IDENTIFY_NAMESPACE;
 
@@ -837,6 +1141,62 @@ typedef struct _IO_WRITE_COMMAND_DW15
     };
 } IO_WRITE_COMMAND_DW15;
 
+/* IO Copy Command */
+typedef struct _IO_COPY_COMMAND_DW12
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned int NR : 8; // Num of source ranges, 0's based
+            unsigned int DF : 4; // Descriptor Format of the source ranges
+            unsigned int PRINFOR : 4;
+            unsigned int reserved0 : 4;
+            unsigned int DTYPE : 4;
+            unsigned int reserved1 : 1;
+            unsigned int STCW : 1;
+            unsigned int PRINFOW : 4;
+            unsigned int FUA : 1;
+            unsigned int LR : 1;
+        };
+    };
+} IO_COPY_COMMAND_DW12;
+
+#define COPY_DESCRIPTOR_FORMAT_0 0x0
+
+/**
+ * @brief The Source Range Entry of Copy, Descriptor Format 0h.
+ */
+typedef struct _IO_COPY_SOURCE_RANGE_ENTRY
+{
+    unsigned char reserved0[8];
+    unsigned int SLBA[2];
+    unsigned short NLB; // 0's based
+    unsigned char reserved1[6];
+    unsigned int EILBRT;
+    unsigned short ELBAT;
+    unsigned short ELBATM;
+} IO_COPY_SOURCE_RANGE_ENTRY;
+
+/* IO Write Zeroes Command */
+typedef struct _IO_WRITE_ZEROES_COMMAND_DW12
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned short NLB;
+            unsigned short reserved0 : 9;
+            unsigned short DEAC : 1; // deallocate the logical blocks
+            unsigned short PRINFO : 4;
+            unsigned short FUA : 1;
+            unsigned short LR : 1;
+        };
+    };
+} IO_WRITE_ZEROES_COMMAND_DW12;
+
 /* IO Read Command */
 typedef struct _IO_READ_COMMAND_DW12
 {
@@ -891,6 +1251,45 @@ typedef struct _IO_READ_COMMAND_DW15
 } IO_READ_COMMAND_DW15;
 
 /* IO Dataset Management Command */
+/* Vendor Specific Physical Address Commands */
+
+/**
+ * For the `IO_OCSSD_PHY_*` commands, CDW[10,11] were used for the physical address of the
+ * first page to be accessed, and CDW[12] has the same format as read/write commands, but
+ * the NLB must cover whole pages (`NVME_BLOCKS_PER_SLICE` NVMe blocks per page).
+ *
+ * @note The block number is the block index in the `OCSSD_PHY_BLOCKS_PER_DIE` blocks of the
+ * target die reserved for these commands, which are never used by the FTL. The bad blocks are
+ * already remapped by the device.
+ */
+typedef struct _IO_OCSSD_PHY_COMMAND_DW10
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned int CH : 4;
+            unsigned int WAY : 4;
+            unsigned int BLK : 16;
+            unsigned int reserved0 : 8;
+        };
+    };
+} IO_OCSSD_PHY_COMMAND_DW10;
+
+typedef struct _IO_OCSSD_PHY_COMMAND_DW11
+{
+    union
+    {
+        unsigned int dword;
+        struct
+        {
+            unsigned int PG : 16;
+            unsigned int reserved0 : 16;
+        };
+    };
+} IO_OCSSD_PHY_COMMAND_DW11;
+
 typedef struct _IO_DATASET_MANAGEMENT_COMMAND_DW10
 {
     unsigned int NR : 8;
@@ -941,6 +1340,8 @@ typedef struct _NVME_IO_SQ_STATUS
     unsigned short qSzie;
     unsigned int pcieBaseAddrL;
     unsigned int pcieBaseAddrH;
+    unsigned char qPrio; // one of `NVME_SQ_PRIORITY_*`
+    unsigned char reserved0[3];
 } NVME_IO_SQ_STATUS;
 
 typedef struct _NVME_IO_CQ_STATUS
@@ -961,6 +1362,8 @@ typedef struct _NVME_STATUS
     NVME_ADMIN_QUEUE_STATUS adminQueueInfo;
     unsigned short numOfIOSubmissionQueuesAllocated; // non zero-based value
     unsigned short numOfIOCompletionQueuesAllocated; // non zero-based value
+    unsigned int arbitration;                        // dword11 of the Arbitration feature
+    unsigned int irqCoalescing;                      // dword11 of the Interrupt Coalescing feature
     NVME_IO_SQ_STATUS ioSqInfo[MAX_NUM_OF_IO_SQ];
     NVME_IO_CQ_STATUS ioCqInfo[MAX_NUM_OF_IO_CQ];
 } NVME_CONTEXT;
@@ -53,6 +53,12 @@
 #include "host_lld.h"
 #include "nvme_identify.h"
 #include "nvme_admin_cmd.h"
+#include "nvme_log_page.h"
+#include "nvme_hmb.h"
+#include "nvme_arbitration.h"
+
+#include "../request_transform.h"
+#include "../namespace.h"
 
 extern NVME_CONTEXT g_nvmeTask;
 
@@ -103,14 +109,41 @@ void handle_set_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
     }
     case INTERRUPT_COALESCING:
     {
+        /*
+         * THR and TIME are accepted but have no effect on this hardware, they are only reported
+         * back by Get Features. The host IP raises an interrupt for every posted completion, so
+         * holding the completions can not merge the interrupts, and would only add latency.
+         */
+        g_nvmeTask.irqCoalescing = nvmeAdminCmd->dword11;
+        nvmeCPL->dword[0]        = 0x0;
+        nvmeCPL->specific        = 0x0;
+        break;
+    }
+    case INTERRUPT_VECTOR_CONFIGURATION:
+    {
+        ADMIN_SET_FEATURES_INTERRUPT_VECTOR_CONFIGURATION_DW11 ivConfig;
+
+        ivConfig.dword    = nvmeAdminCmd->dword11;
         nvmeCPL->dword[0] = 0x0;
         nvmeCPL->specific = 0x0;
+
+        // CD is accepted but has no effect, no vector is ever coalesced, check INTERRUPT_COALESCING
+        if (ivConfig.IV >= MAX_NUM_OF_IRQ_VECTOR)
+        {
+            NVME_COMPLETION cpl;
+
+            cpl.dword[0]       = 0x0;
+            cpl.statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+            nvmeCPL->dword[0]  = cpl.dword[0];
+        }
         break;
     }
     case ARBITRATION:
     {
-        nvmeCPL->dword[0] = 0x0;
-        nvmeCPL->specific = 0x0;
+        xil_printf("Set Arbitration: %X\r\n", nvmeAdminCmd->dword11);
+        g_nvmeTask.arbitration = nvmeAdminCmd->dword11;
+        nvmeCPL->dword[0]      = 0x0;
+        nvmeCPL->specific      = 0x0;
         break;
     }
     case ASYNCHRONOUS_EVENT_CONFIGURATION:
@@ -122,6 +155,11 @@ void handle_set_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
     case VOLATILE_WRITE_CACHE:
     {
         xil_printf("Set VWC: %X\r\n", nvmeAdminCmd->dword11);
+
+        // the buffered data must be persistent once the write cache is disabled
+        if (g_nvmeTask.cacheEn && !(nvmeAdminCmd->dword11 & 0x1))
+            FlushDataBuf();
+
         g_nvmeTask.cacheEn = (nvmeAdminCmd->dword11 & 0x1);
         nvmeCPL->dword[0]  = 0x0;
         nvmeCPL->specific  = 0x0;
@@ -139,6 +177,11 @@ void handle_set_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
         nvmeCPL->specific = 0x0;
         break;
     }
+    case HOST_MEMORY_BUFFER:
+    {
+        handle_set_nvme_hmb(nvmeAdminCmd, nvmeCPL);
+        break;
+    }
     default:
     {
         xil_printf("Not Support FID (Set): %X\r\n", features.FID);
@@ -168,6 +211,30 @@ void handle_get_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
         nvmeCPL->specific  = 0x0;
         break;
     }
+    case ARBITRATION:
+    {
+        nvmeCPL->dword[0] = 0x0;
+        nvmeCPL->specific = g_nvmeTask.arbitration;
+        break;
+    }
+    case INTERRUPT_COALESCING:
+    {
+        nvmeCPL->dword[0] = 0x0;
+        nvmeCPL->specific = g_nvmeTask.irqCoalescing;
+        break;
+    }
+    case INTERRUPT_VECTOR_CONFIGURATION:
+    {
+        ADMIN_SET_FEATURES_INTERRUPT_VECTOR_CONFIGURATION_DW11 ivConfig;
+
+        // the completions of every vector are posted without coalescing
+        ivConfig.dword = nvmeAdminCmd->dword11;
+        ivConfig.CD    = 1;
+
+        nvmeCPL->dword[0] = 0x0;
+        nvmeCPL->specific = ivConfig.dword;
+        break;
+    }
     case TEMPERATURE_THRESHOLD:
     {
         nvmeCPL->dword[0] = 0x0;
@@ -200,6 +267,13 @@ void handle_get_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
         nvmeCPL->specific = 0x0;
         break;
     }
+    case HOST_MEMORY_BUFFER:
+    {
+        // the Host Memory Buffer Attributes data structure is not returned
+        nvmeCPL->dword[0] = 0x0;
+        nvmeCPL->specific = is_nvme_hmb_enabled();
+        break;
+    }
     default:
     {
         xil_printf("Not Support FID (Get): %X\r\n", features.FID);
@@ -236,6 +310,7 @@ void handle_create_io_sq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
     ioSqStatus->valid         = 1;
     ioSqStatus->qSzie         = sqInfo10.QSIZE;
     ioSqStatus->cqVector      = sqInfo11.CQID;
+    ioSqStatus->qPrio         = sqInfo11.QPRIO;
     ioSqStatus->pcieBaseAddrL = nvmeAdminCmd->PRP1[0];
     ioSqStatus->pcieBaseAddrH = nvmeAdminCmd->PRP1[1];
 
@@ -259,8 +334,12 @@ void handle_delete_io_sq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
     ioSqIdx    = (unsigned int)sqInfo10.QID - 1;
     ioSqStatus = g_nvmeTask.ioSqInfo + ioSqIdx;
 
+    // the fetched commands of the SQ must not run in a SQ created later with the same QID
+    abort_nvme_arb_sq(ioSqIdx);
+
     ioSqStatus->valid         = 0;
     ioSqStatus->cqVector      = 0;
+    ioSqStatus->qPrio         = 0;
     ioSqStatus->qSzie         = 0;
     ioSqStatus->pcieBaseAddrL = 0;
     ioSqStatus->pcieBaseAddrH = 0;
@@ -328,35 +407,124 @@ void handle_delete_io_cq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
     nvmeCPL->specific = 0x0;
 }
 
+/**
+ * @brief Fill the namespace list of the Identify command.
+ *
+ * @param pBuffer the DRAM address of the buffer to be filled.
+ * @param nsid only the NSIDs greater than this one are listed.
+ * @param activeOnly 1 for listing the attached namespaces only.
+ */
+static void identify_namespace_list(unsigned int pBuffer, unsigned int nsid, unsigned int activeOnly)
+{
+    unsigned int *nsList;
+    unsigned int nsCnt;
+
+    nsList = (unsigned int *)pBuffer;
+    memset(nsList, 0, 4096);
+
+    nsCnt = 0;
+    for (nsid = nsid + 1; nsid <= MAX_NUM_OF_NAMESPACE; nsid++)
+        if (activeOnly ? IsNamespaceAttached(nsid) : IsNamespaceAllocated(nsid))
+            nsList[nsCnt++] = nsid;
+}
+
+/**
+ * @brief Fill the controller list of the Identify command.
+ *
+ * There is only one controller, so the list is either empty or contains only the CNTLID
+ * reported by `identify_controller()`.
+ *
+ * @param pBuffer the DRAM address of the buffer to be filled.
+ * @param listed 1 if the controller should be listed.
+ */
+static void identify_controller_list(unsigned int pBuffer, unsigned int listed)
+{
+    ADMIN_CONTROLLER_LIST *cntlList;
+
+    cntlList = (ADMIN_CONTROLLER_LIST *)pBuffer;
+    memset(cntlList, 0, sizeof(ADMIN_CONTROLLER_LIST));
+
+    if (listed)
+    {
+        cntlList->NUMID = 1;
+        cntlList->ID[0] = NVME_CONTROLLER_ID;
+    }
+}
+
+/**
+ * @brief Transfer the requested identify data structure to host.
+ *
+ * The unallocated or inactive namespaces are reported as all zeros, and the invalid NSIDs
+ * are completed with `SC_INVALID_NAMESPACE_OR_FORMAT`.
+ *
+ * @param nvmeAdminCmd a pointer points to the instance of given NVMe command.
+ * @param nvmeCPL a pointer points to the completion entry to be posted.
+ */
 void handle_identify(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
 {
     ADMIN_IDENTIFY_COMMAND_DW10 identifyInfo;
     unsigned int pIdentifyData = ADMIN_CMD_DRAM_DATA_BUFFER;
     unsigned int prp[2];
     unsigned int prpLen;
+    unsigned int nsid;
 
     identifyInfo.dword = nvmeAdminCmd->dword10;
+    nsid               = nvmeAdminCmd->NSID;
 
-    if (identifyInfo.CNS == 1)
-    {
-        if ((nvmeAdminCmd->PRP1[0] & 0x3) != 0 || (nvmeAdminCmd->PRP2[0] & 0x3) != 0)
-            xil_printf("CI: %X, %X, %X, %X\r\n", nvmeAdminCmd->PRP1[1], nvmeAdminCmd->PRP1[0],
-                       nvmeAdminCmd->PRP2[1], nvmeAdminCmd->PRP2[0]);
+    nvmeCPL->dword[0] = 0;
+    nvmeCPL->specific = 0x0;
 
-        ASSERT((nvmeAdminCmd->PRP1[0] & 0x3) == 0 && (nvmeAdminCmd->PRP2[0] & 0x3) == 0);
-        identify_controller(pIdentifyData);
-    }
-    else if (identifyInfo.CNS == 0)
+    if ((nvmeAdminCmd->PRP1[0] & 0x3) != 0 || (nvmeAdminCmd->PRP2[0] & 0x3) != 0)
+        xil_printf("I%X: %X, %X, %X, %X\r\n", identifyInfo.CNS, nvmeAdminCmd->PRP1[1], nvmeAdminCmd->PRP1[0],
+                   nvmeAdminCmd->PRP2[1], nvmeAdminCmd->PRP2[0]);
+    ASSERT((nvmeAdminCmd->PRP1[0] & 0x3) == 0 && (nvmeAdminCmd->PRP2[0] & 0x3) == 0);
+
+    switch (identifyInfo.CNS)
     {
-        if ((nvmeAdminCmd->PRP1[0] & 0x3) != 0 || (nvmeAdminCmd->PRP2[0] & 0x3) != 0)
-            xil_printf("NI: %X, %X, %X, %X\r\n", nvmeAdminCmd->PRP1[1], nvmeAdminCmd->PRP1[0],
-                       nvmeAdminCmd->PRP2[1], nvmeAdminCmd->PRP2[0]);
-        // ASSERT(nvmeAdminCmd->NSID == 1);
-        ASSERT((nvmeAdminCmd->PRP1[0] & 0x3) == 0 && (nvmeAdminCmd->PRP2[0] & 0x3) == 0);
-        identify_namespace(pIdentifyData);
+    case IDENTIFY_CNS_CONTROLLER:
+        identify_controller(pIdentifyData);
+        break;
+    case IDENTIFY_CNS_NAMESPACE:
+    case IDENTIFY_CNS_ALLOCATED_NAMESPACE:
+        if ((identifyInfo.CNS == IDENTIFY_CNS_NAMESPACE) && (nsid == NVME_NSID_ALL))
+        {
+            identify_namespace(pIdentifyData, nsid); // the capabilities common to all namespaces
+            break;
+        }
+
+        if ((nsid == NSID_NONE) || (nsid > MAX_NUM_OF_NAMESPACE))
+        {
+            nvmeCPL->statusField.SC = SC_INVALID_NAMESPACE_OR_FORMAT;
+            return;
+        }
+
+        if ((identifyInfo.CNS == IDENTIFY_CNS_NAMESPACE) ? IsNamespaceAttached(nsid) : IsNamespaceAllocated(nsid))
+            identify_namespace(pIdentifyData, nsid);
+        else
+            memset((void *)pIdentifyData, 0, sizeof(ADMIN_IDENTIFY_NAMESPACE));
+        break;
+    case IDENTIFY_CNS_ACTIVE_NAMESPACE_LIST:
+    case IDENTIFY_CNS_ALLOCATED_NAMESPACE_LIST:
+        if (nsid >= 0xFFFFFFFE)
+        {
+            nvmeCPL->statusField.SC = SC_INVALID_NAMESPACE_OR_FORMAT;
+            return;
+        }
+
+        identify_namespace_list(pIdentifyData, nsid, identifyInfo.CNS == IDENTIFY_CNS_ACTIVE_NAMESPACE_LIST);
+        break;
+    case IDENTIFY_CNS_ATTACHED_CONTROLLER_LIST:
+        identify_controller_list(pIdentifyData,
+                                 IsNamespaceAttached(nsid) && (identifyInfo.CNTID <= NVME_CONTROLLER_ID));
+        break;
+    case IDENTIFY_CNS_CONTROLLER_LIST:
+        identify_controller_list(pIdentifyData, identifyInfo.CNTID <= NVME_CONTROLLER_ID);
+        break;
+    default:
+        xil_printf("Not Support Identify CNS: %X\r\n", identifyInfo.CNS);
+        nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+        return;
     }
-    else
-        ASSERT(0);
 
     prp[0] = nvmeAdminCmd->PRP1[0];
     prp[1] = nvmeAdminCmd->PRP1[1];
@@ -377,39 +545,291 @@ void handle_identify(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
     }
 
     check_direct_tx_dma_done();
+}
+
+/**
+ * @brief Receive the 4KB data structure of an admin command from host.
+ *
+ * @param nvmeAdminCmd a pointer points to the instance of given NVMe command.
+ * @param pData the DRAM address of the buffer to receive the data.
+ */
+static void receive_admin_cmd_data(NVME_ADMIN_COMMAND *nvmeAdminCmd, unsigned int pData)
+{
+    unsigned int prp[2];
+    unsigned int prpLen;
+
+    ASSERT((nvmeAdminCmd->PRP1[0] & 0x3) == 0 && (nvmeAdminCmd->PRP2[0] & 0x3) == 0);
+
+    prp[0] = nvmeAdminCmd->PRP1[0];
+    prp[1] = nvmeAdminCmd->PRP1[1];
+
+    prpLen = 0x1000 - (prp[0] & 0xFFF);
+    set_direct_rx_dma(pData, prp[1], prp[0], prpLen);
+    if (prpLen != 0x1000)
+    {
+        pData  = pData + prpLen;
+        prpLen = 0x1000 - prpLen;
+        prp[0] = nvmeAdminCmd->PRP2[0];
+        prp[1] = nvmeAdminCmd->PRP2[1];
+
+        set_direct_rx_dma(pData, prp[1], prp[0], prpLen);
+    }
+
+    check_direct_rx_dma_done();
+}
+
+/**
+ * @brief Create or delete namespaces.
+ *
+ * For creating a namespace, the host sends the Identify Namespace data structure, only the
+ * NSZE, NCAP, FLBAS and the vendor specific fields (OPP, FDIE, NDIE) are used. The NSZE is
+ * rounded up to slices, and the NSID of the new namespace is returned in the dword 0 of the
+ * completion entry. The new namespace should be attached before using it.
+ *
+ * @sa `CreateNamespace()`, `DeleteNamespace()`, `handle_namespace_attachment()`.
+ *
+ * @param nvmeAdminCmd a pointer points to the instance of given NVMe command.
+ * @param nvmeCPL a pointer points to the completion entry to be posted.
+ */
+void handle_namespace_management(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
+{
+    ADMIN_NAMESPACE_MANAGEMENT_DW10 nsMgmtInfo;
+    ADMIN_IDENTIFY_NAMESPACE *nsData;
+    unsigned int nsid, numOfSlice;
+
+    nsMgmtInfo.dword = nvmeAdminCmd->dword10;
+    nsid             = nvmeAdminCmd->NSID;
+
     nvmeCPL->dword[0] = 0;
     nvmeCPL->specific = 0x0;
+
+    if (nsMgmtInfo.SEL == NAMESPACE_MANAGEMENT_SEL_CREATE)
+    {
+        nsData = (ADMIN_IDENTIFY_NAMESPACE *)ADMIN_CMD_DRAM_DATA_BUFFER;
+        receive_admin_cmd_data(nvmeAdminCmd, ADMIN_CMD_DRAM_DATA_BUFFER);
+
+        // thin provisioning and other LBA formats are not supported
+        if (nsData->NSZE[1] || (nsData->NSZE[0] == 0) || (nsData->NCAP[0] != nsData->NSZE[0]) ||
+            (nsData->NCAP[1] != nsData->NSZE[1]) || (nsData->FLBAS.supportedCombination != 0) ||
+            (nsData->FDIE >= USER_DIES) || (nsData->NDIE > USER_DIES - nsData->FDIE))
+        {
+            nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+            return;
+        }
+
+        for (nsid = 1; nsid <= MAX_NUM_OF_NAMESPACE; nsid++)
+            if (!IsNamespaceAllocated(nsid))
+                break;
+        if (nsid > MAX_NUM_OF_NAMESPACE)
+        {
+            nvmeCPL->statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+            nvmeCPL->statusField.SC  = SC_NAMESPACE_IDENTIFIER_UNAVAILABLE;
+            return;
+        }
+
+        numOfSlice = nsData->NSZE[0] / NVME_BLOCKS_PER_SLICE + (nsData->NSZE[0] % NVME_BLOCKS_PER_SLICE != 0);
+        nsid       = CreateNamespace(numOfSlice, nsData->OPP, nsData->FDIE, nsData->NDIE);
+        if (nsid == NSID_NONE)
+        {
+            nvmeCPL->statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+            nvmeCPL->statusField.SC  = SC_NAMESPACE_INSUFFICIENT_CAPACITY;
+            return;
+        }
+
+        nvmeCPL->specific = nsid;
+    }
+    else if (nsMgmtInfo.SEL == NAMESPACE_MANAGEMENT_SEL_DELETE)
+    {
+        if (nsid == NVME_NSID_ALL)
+        {
+            for (nsid = 1; nsid <= MAX_NUM_OF_NAMESPACE; nsid++)
+                if (IsNamespaceAllocated(nsid))
+                    DeleteNamespace(nsid);
+        }
+        else if (IsNamespaceAllocated(nsid))
+            DeleteNamespace(nsid);
+        else
+            nvmeCPL->statusField.SC = SC_INVALID_NAMESPACE_OR_FORMAT;
+    }
+    else
+        nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
 }
 
-void handle_get_log_page(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
+/**
+ * @brief Attach or detach a namespace to or from the controller.
+ *
+ * There is only one controller, so the controller list must contain only the CNTLID
+ * reported by `identify_controller()`. The I/O commands to a detached namespace are
+ * completed with `SC_INVALID_NAMESPACE_OR_FORMAT`.
+ *
+ * @param nvmeAdminCmd a pointer points to the instance of given NVMe command.
+ * @param nvmeCPL a pointer points to the completion entry to be posted.
+ */
+void handle_namespace_attachment(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
 {
-    // ADMIN_GET_LOG_PAGE_DW10 getLogPageInfo;
+    ADMIN_NAMESPACE_ATTACHMENT_DW10 nsAttachInfo;
+    ADMIN_CONTROLLER_LIST *cntlList;
+    unsigned int nsid;
+
+    nsAttachInfo.dword = nvmeAdminCmd->dword10;
+    nsid               = nvmeAdminCmd->NSID;
+
+    nvmeCPL->dword[0] = 0;
+    nvmeCPL->specific = 0x0;
 
-    // unsigned int prp1[2];
-    // unsigned int prp2[2];
-    // unsigned int prpLen;
+    if (!IsNamespaceAllocated(nsid))
+    {
+        nvmeCPL->statusField.SC = SC_INVALID_NAMESPACE_OR_FORMAT;
+        return;
+    }
 
-    // getLogPageInfo.dword = nvmeAdminCmd->dword10;
+    cntlList = (ADMIN_CONTROLLER_LIST *)ADMIN_CMD_DRAM_DATA_BUFFER;
+    receive_admin_cmd_data(nvmeAdminCmd, ADMIN_CMD_DRAM_DATA_BUFFER);
 
-    // prp1[0] = nvmeAdminCmd->PRP1[0];
-    // prp1[1] = nvmeAdminCmd->PRP1[1];
-    // prpLen = 0x1000 - (prp1[0] & 0xFFF);
+    if ((cntlList->NUMID != 1) || (cntlList->ID[0] != NVME_CONTROLLER_ID))
+    {
+        nvmeCPL->statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+        nvmeCPL->statusField.SC  = SC_CONTROLLER_LIST_INVALID;
+        return;
+    }
 
-    // prp2[0] = nvmeAdminCmd->PRP2[0];
-    // prp2[1] = nvmeAdminCmd->PRP2[1];
+    if (nsAttachInfo.SEL == NAMESPACE_ATTACHMENT_SEL_ATTACH)
+    {
+        if (IsNamespaceAttached(nsid))
+        {
+            nvmeCPL->statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+            nvmeCPL->statusField.SC  = SC_NAMESPACE_ALREADY_ATTACHED;
+        }
+        else
+            NS_ENTRY(nsid)->attached = 1;
+    }
+    else if (nsAttachInfo.SEL == NAMESPACE_ATTACHMENT_SEL_DETACH)
+    {
+        if (!IsNamespaceAttached(nsid))
+        {
+            nvmeCPL->statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+            nvmeCPL->statusField.SC  = SC_NAMESPACE_NOT_ATTACHED;
+        }
+        else
+            NS_ENTRY(nsid)->attached = 0;
+    }
+    else
+        nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+}
+
+/**
+ * @brief Handle the vendor specific admin command for reporting the physical geometry.
+ *
+ * The geometry is sent to host in the same way as `handle_identify()`, check the struct
+ * `ADMIN_OCSSD_GEOMETRY_DATA` for the reported fields.
+ *
+ * @param nvmeAdminCmd the admin command to be handled.
+ * @param nvmeCPL the completion entry to be filled.
+ */
+void handle_ocssd_geometry(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
+{
+    unsigned int pGeometryData = ADMIN_CMD_DRAM_DATA_BUFFER;
+    unsigned int prp[2];
+    unsigned int prpLen;
+
+    ASSERT((nvmeAdminCmd->PRP1[0] & 0x3) == 0 && (nvmeAdminCmd->PRP2[0] & 0x3) == 0);
+    identify_ocssd_geometry(pGeometryData);
+
+    prp[0] = nvmeAdminCmd->PRP1[0];
+    prp[1] = nvmeAdminCmd->PRP1[1];
+
+    prpLen = 0x1000 - (prp[0] & 0xFFF);
+    set_direct_tx_dma(pGeometryData, prp[1], prp[0], prpLen);
+    if (prpLen != 0x1000)
+    {
+        pGeometryData = pGeometryData + prpLen;
+        prpLen        = 0x1000 - prpLen;
+        prp[0]        = nvmeAdminCmd->PRP2[0];
+        prp[1]        = nvmeAdminCmd->PRP2[1];
+
+        set_direct_tx_dma(pGeometryData, prp[1], prp[0], prpLen);
+    }
 
-    // xil_printf("ADMIN GET LOG PAGE\n");
+    check_direct_tx_dma_done();
+    nvmeCPL->dword[0] = 0;
+    nvmeCPL->specific = 0x0;
+}
 
-    // LID
-    // Mandatory//1-Error information, 2-SMART/Health information, 3-Firmware Slot information
-    // Optional//4-ChangedNamespaceList, 5-Command Effects Log
-    // xil_printf("LID: 0x%X, NUMD: 0x%X \r\n", getLogPageInfo.LID, getLogPageInfo.NUMD);
+/**
+ * @brief Transfer the requested log page to host.
+ *
+ * Only the number of dwords requested by NUMD are transferred, the rest of the log page is
+ * discarded. The unsupported log pages are completed with `SC_INVALID_LOG_PAGE`.
+ *
+ * @note The Error Information and Firmware Slot Information log pages are mandatory, but
+ * no error entries or firmware slots are recorded, so they are reported as all zeros.
+ *
+ * @sa `nvme_log_page.h`
+ *
+ * @param nvmeAdminCmd a pointer points to the instance of given NVMe command.
+ * @param nvmeCPL a pointer points to the completion entry to be posted.
+ */
+void handle_get_log_page(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
+{
+    ADMIN_GET_LOG_PAGE_DW10 getLogPageInfo;
+    unsigned int pLogPageData = ADMIN_CMD_DRAM_DATA_BUFFER;
+    unsigned int logPageLen;
+    unsigned int prp[2];
+    unsigned int prpLen;
 
-    // xil_printf("PRP1[63:32] = 0x%X, PRP1[31:0] = 0x%X", prp1[1], prp1[0]);
-    // xil_printf("PRP2[63:32] = 0x%X, PRP2[31:0] = 0x%X", prp2[1], prp2[0]);
+    getLogPageInfo.dword = nvmeAdminCmd->dword10;
 
     nvmeCPL->dword[0] = 0;
-    nvmeCPL->specific = 0x9; // invalid log page
+    nvmeCPL->specific = 0x0;
+
+    switch (getLogPageInfo.LID)
+    {
+    case LOG_PAGE_ERROR_INFORMATION:
+    case LOG_PAGE_FIRMWARE_SLOT:
+        logPageLen = 512;
+        memset((void *)pLogPageData, 0, logPageLen);
+        break;
+    case LOG_PAGE_SMART_HEALTH_INFORMATION:
+        logPageLen = get_smart_health_log(pLogPageData);
+        break;
+    case LOG_PAGE_VENDOR_SMART_EXTENSION:
+        logPageLen = get_vendor_smart_ext_log(pLogPageData);
+        break;
+    case LOG_PAGE_VENDOR_TELEMETRY:
+        logPageLen = get_vendor_telemetry_log(pLogPageData, getLogPageInfo.LSP & LOG_PAGE_TELEMETRY_LSP_RESET);
+        break;
+    default:
+        xil_printf("Not Support Log Page LID: %X\r\n", getLogPageInfo.LID);
+        nvmeCPL->statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+        nvmeCPL->statusField.SC  = SC_INVALID_LOG_PAGE;
+        return;
+    }
+
+    // NUMD is zero-based
+    if (((unsigned int)getLogPageInfo.NUMD + 1) * 4 < logPageLen)
+        logPageLen = ((unsigned int)getLogPageInfo.NUMD + 1) * 4;
+
+    ASSERT((nvmeAdminCmd->PRP1[0] & 0x3) == 0 && (nvmeAdminCmd->PRP2[0] & 0x3) == 0);
+
+    prp[0] = nvmeAdminCmd->PRP1[0];
+    prp[1] = nvmeAdminCmd->PRP1[1];
+
+    prpLen = 0x1000 - (prp[0] & 0xFFF);
+    if (prpLen > logPageLen)
+        prpLen = logPageLen;
+
+    set_direct_tx_dma(pLogPageData, prp[1], prp[0], prpLen);
+    if (prpLen != logPageLen)
+    {
+        pLogPageData = pLogPageData + prpLen;
+        prpLen       = logPageLen - prpLen;
+        prp[0]       = nvmeAdminCmd->PRP2[0];
+        prp[1]       = nvmeAdminCmd->PRP2[1];
+
+        set_direct_tx_dma(pLogPageData, prp[1], prp[0], prpLen);
+    }
+
+    check_direct_tx_dma_done();
 }
 
 void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd)
@@ -489,6 +909,21 @@ void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd)
         handle_get_log_page(nvmeAdminCmd, &nvmeCPL);
         break;
     }
+    case ADMIN_NAMESPACE_MANAGEMENT:
+    {
+        handle_namespace_management(nvmeAdminCmd, &nvmeCPL);
+        break;
+    }
+    case ADMIN_NAMESPACE_ATTACHMENT:
+    {
+        handle_namespace_attachment(nvmeAdminCmd, &nvmeCPL);
+        break;
+    }
+    case ADMIN_OCSSD_GEOMETRY:
+    {
+        handle_ocssd_geometry(nvmeAdminCmd, &nvmeCPL);
+        break;
+    }
     case ADMIN_SECURITY_RECEIVE:
     {
         needCpl          = 0;
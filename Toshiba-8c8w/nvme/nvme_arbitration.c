@@ -0,0 +1,346 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_arbitration.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Command Arbiter
+// File Name: nvme_arbitration.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - arbitrates the fetched NVMe I/O commands among submission queues
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include "debug.h"
+
+#include "nvme.h"
+#include "host_lld.h"
+#include "nvme_admin_cmd.h"
+#include "nvme_io_cmd.h"
+#include "nvme_arbitration.h"
+
+extern NVME_CONTEXT g_nvmeTask;
+
+NVME_ARB_CONTEXT g_nvmeArb;
+
+/**
+ * @brief Reset the arbiter, all the waiting commands are dropped.
+ *
+ * @note Should be called when the controller is enabled, since the command slots of the
+ * NVMe controller are reset with the controller.
+ */
+void init_nvme_arbitration()
+{
+    unsigned int sqIdx, prio;
+
+    for (sqIdx = 0; sqIdx < MAX_NUM_OF_IO_SQ; sqIdx++)
+    {
+        g_nvmeArb.sqFifo[sqIdx].head = 0;
+        g_nvmeArb.sqFifo[sqIdx].tail = 0;
+        g_nvmeArb.sqFifo[sqIdx].cnt  = 0;
+    }
+
+    for (prio = 0; prio < 4; prio++)
+    {
+        g_nvmeArb.credit[prio]    = 0;
+        g_nvmeArb.curSq[prio]     = 0;
+        g_nvmeArb.burstLeft[prio] = 0;
+    }
+
+    g_nvmeArb.fusedSq     = NVME_ARB_SQ_NONE;
+    g_nvmeArb.prevFusedSq = NVME_ARB_SQ_NONE;
+    g_nvmeArb.fusedTime   = 0;
+}
+
+/**
+ * @brief Move all the commands in the command FIFO of the NVMe controller to the arbiter.
+ *
+ * The NVMe controller presents the fetched commands in a single FIFO regardless of their
+ * submission queues, so we have to drain the FIFO to see the commands of all the queues
+ * before doing arbitration.
+ *
+ * The admin commands are handled right away, since the admin queue has the highest strict
+ * priority. The I/O commands are appended to the FIFO of their submission queue and will
+ * be selected by `arbitrate_nvme_io_cmd()`.
+ *
+ * @return unsigned int the number of fetched commands.
+ */
+unsigned int fetch_nvme_cmd()
+{
+    NVME_COMMAND nvmeCmd;
+    NVME_ARB_SQ_FIFO *sqFifo;
+    unsigned int fetchCnt;
+
+    fetchCnt = 0;
+    while (get_nvme_cmd(&nvmeCmd.qID, &nvmeCmd.cmdSlotTag, &nvmeCmd.cmdSeqNum, nvmeCmd.cmdDword))
+    {
+        fetchCnt++;
+
+        if (nvmeCmd.qID == 0)
+        {
+            handle_nvme_admin_cmd(&nvmeCmd);
+            continue;
+        }
+
+        // the SQ may be deleted by an admin command fetched before this command
+        if (!g_nvmeTask.ioSqInfo[nvmeCmd.qID - 1].valid)
+        {
+            abort_nvme_cmd_of_deleted_sq(nvmeCmd.cmdSlotTag);
+            continue;
+        }
+
+        sqFifo = &g_nvmeArb.sqFifo[nvmeCmd.qID - 1];
+        ASSERT(sqFifo->cnt < NVME_ARB_SQ_FIFO_DEPTH);
+
+        sqFifo->cmdSlotTag[sqFifo->tail] = nvmeCmd.cmdSlotTag;
+        sqFifo->tail                     = (sqFifo->tail + 1) % NVME_ARB_SQ_FIFO_DEPTH;
+        sqFifo->cnt++;
+    }
+
+    return fetchCnt;
+}
+
+/**
+ * @brief Complete the given I/O command with Command Aborted due to SQ Deletion.
+ *
+ * @param cmdSlotTag the slot tag of an I/O command that was never handled.
+ */
+void abort_nvme_cmd_of_deleted_sq(unsigned int cmdSlotTag)
+{
+    NVME_COMPLETION nvmeCPL;
+
+    nvmeCPL.dword[0]       = 0;
+    nvmeCPL.specific       = 0x0;
+    nvmeCPL.statusField.SC = SC_COMMAND_ABORTED_DUE_TO_SQ_DELETION;
+
+    set_auto_nvme_cpl(cmdSlotTag, nvmeCPL.specific, nvmeCPL.statusFieldWord);
+}
+
+/**
+ * @brief Drop all the waiting commands of the given SQ, which is being deleted.
+ *
+ * The fetched commands of the SQ that were not selected yet are completed with the status
+ * Command Aborted due to SQ Deletion, so they will never run at the priority of a SQ created
+ * later with the same QID. An unfinished fused operation of the SQ is aborted as well.
+ *
+ * @note The commands that were already selected are completed as usual.
+ *
+ * @param sqIdx the index of the deleted SQ.
+ */
+void abort_nvme_arb_sq(unsigned int sqIdx)
+{
+    NVME_ARB_SQ_FIFO *sqFifo;
+
+    sqFifo = &g_nvmeArb.sqFifo[sqIdx];
+    while (sqFifo->cnt)
+    {
+        abort_nvme_cmd_of_deleted_sq(sqFifo->cmdSlotTag[sqFifo->head]);
+
+        sqFifo->head = (sqFifo->head + 1) % NVME_ARB_SQ_FIFO_DEPTH;
+        sqFifo->cnt--;
+    }
+    sqFifo->head = 0;
+    sqFifo->tail = 0;
+
+    if (g_nvmeArb.fusedSq == sqIdx)
+    {
+        abort_nvme_fused_cmd(SC_COMMAND_ABORTED_DUE_TO_SQ_DELETION);
+        g_nvmeArb.fusedSq = NVME_ARB_SQ_NONE;
+    }
+    if (g_nvmeArb.prevFusedSq == sqIdx)
+        g_nvmeArb.prevFusedSq = NVME_ARB_SQ_NONE;
+}
+
+/**
+ * @brief Select a SQ of the specified priority class in round robin manner.
+ *
+ * The current SQ of the class will be selected again until it sent `2^AB` commands in a
+ * row (Arbitration Burst) or it has no waiting command.
+ *
+ * @param prio the priority class, one of `NVME_SQ_PRIORITY_*`.
+ * @return unsigned int the index of selected SQ, or `NVME_ARB_SQ_NONE` if no SQ of this
+ * class has waiting commands.
+ */
+unsigned int select_nvme_arb_sq(unsigned int prio)
+{
+    ADMIN_SET_FEATURES_ARBITRATION_DW11 arbitration;
+    unsigned int sqIdx, cnt;
+
+    sqIdx = g_nvmeArb.curSq[prio];
+    if (g_nvmeArb.burstLeft[prio] && g_nvmeArb.sqFifo[sqIdx].cnt && (g_nvmeTask.ioSqInfo[sqIdx].qPrio == prio))
+    {
+        g_nvmeArb.burstLeft[prio]--;
+        return sqIdx;
+    }
+
+    for (cnt = 1; cnt <= MAX_NUM_OF_IO_SQ; cnt++)
+    {
+        sqIdx = (g_nvmeArb.curSq[prio] + cnt) % MAX_NUM_OF_IO_SQ;
+        if (g_nvmeArb.sqFifo[sqIdx].cnt && (g_nvmeTask.ioSqInfo[sqIdx].qPrio == prio))
+        {
+            arbitration.dword = g_nvmeTask.arbitration;
+
+            g_nvmeArb.curSq[prio] = sqIdx;
+            if (arbitration.AB == NVME_ARB_BURST_NO_LIMIT)
+                g_nvmeArb.burstLeft[prio] = 0xffffffff;
+            else
+                g_nvmeArb.burstLeft[prio] = (1 << arbitration.AB) - 1;
+
+            return sqIdx;
+        }
+    }
+
+    return NVME_ARB_SQ_NONE;
+}
+
+/**
+ * @brief Select the next I/O command to be executed.
+ *
+ * Implements the Weighted Round Robin with Urgent Priority Class arbitration mechanism of
+ * the NVMe specification, the priority class of a SQ is the QPRIO specified when the SQ
+ * was created:
+ *
+ * - the urgent class has strict priority over the other I/O classes
+ * - the high, medium and low classes share the remaining bandwidth, in each round they
+ *   can send at most HPW+1, MPW+1 and LPW+1 commands respectively
+ * - the SQs in the same class are served in round robin manner
+ *
+ * A new round starts when none of the classes that still have credits has any waiting
+ * command, so the idle classes will not block the busy ones.
+ *
+ * @note If the host uses the same QPRIO for all the I/O SQs, this degenerates to the plain
+ * round robin arbitration.
+ *
+ * @note Once the first command of a fused operation is selected, the next command must be
+ * selected from the same SQ, even if it is not fetched yet. So no other command can access
+ * the LBAs between the Compare and the Write of a fused operation. If the next command is
+ * not fetched within `NVME_ARB_FUSED_TIMEOUT`, the first command is aborted with the
+ * Missing Fused Command status, and the other SQs are served again.
+ *
+ * @param nvmeCmd the buffer for the selected command.
+ * @return unsigned int 1 if a command is selected, otherwise 0.
+ */
+unsigned int arbitrate_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
+{
+    ADMIN_SET_FEATURES_ARBITRATION_DW11 arbitration;
+    NVME_ARB_SQ_FIFO *sqFifo;
+    NVME_IO_COMMAND *nvmeIOCmd;
+    unsigned int sqIdx, prio, round;
+    XTime curTime;
+
+    if ((g_nvmeArb.fusedSq != NVME_ARB_SQ_NONE) && (g_nvmeArb.sqFifo[g_nvmeArb.fusedSq].cnt == 0))
+    {
+        // wait for the second command of the fused operation, but not forever
+        XTime_GetTime(&curTime);
+        if (curTime - g_nvmeArb.fusedTime < NVME_ARB_FUSED_TIMEOUT)
+            return 0;
+
+        abort_nvme_fused_cmd(SC_COMMAND_ABORTED_DUE_TO_MISSING_FUSED_COMMAND);
+        g_nvmeArb.fusedSq = NVME_ARB_SQ_NONE;
+    }
+
+    if (g_nvmeArb.fusedSq != NVME_ARB_SQ_NONE)
+        sqIdx = g_nvmeArb.fusedSq;
+    else
+        sqIdx = select_nvme_arb_sq(NVME_SQ_PRIORITY_URGENT);
+
+    for (round = 0; (sqIdx == NVME_ARB_SQ_NONE) && (round < 2); round++)
+    {
+        for (prio = NVME_SQ_PRIORITY_HIGH; prio <= NVME_SQ_PRIORITY_LOW; prio++)
+            if (g_nvmeArb.credit[prio])
+            {
+                sqIdx = select_nvme_arb_sq(prio);
+                if (sqIdx != NVME_ARB_SQ_NONE)
+                {
+                    g_nvmeArb.credit[prio]--;
+                    break;
+                }
+            }
+
+        if (sqIdx == NVME_ARB_SQ_NONE)
+        {
+            // start a new round
+            arbitration.dword = g_nvmeTask.arbitration;
+
+            g_nvmeArb.credit[NVME_SQ_PRIORITY_HIGH]   = arbitration.HPW + 1;
+            g_nvmeArb.credit[NVME_SQ_PRIORITY_MEDIUM] = arbitration.MPW + 1;
+            g_nvmeArb.credit[NVME_SQ_PRIORITY_LOW]    = arbitration.LPW + 1;
+        }
+    }
+
+    if (sqIdx == NVME_ARB_SQ_NONE)
+        return 0;
+
+    sqFifo = &g_nvmeArb.sqFifo[sqIdx];
+
+    nvmeCmd->qID        = sqIdx + 1;
+    nvmeCmd->cmdSlotTag = sqFifo->cmdSlotTag[sqFifo->head];
+    nvmeCmd->cmdSeqNum  = 0;
+    get_nvme_cmd_dword(nvmeCmd->cmdSlotTag, nvmeCmd->cmdDword);
+
+    sqFifo->head = (sqFifo->head + 1) % NVME_ARB_SQ_FIFO_DEPTH;
+    sqFifo->cnt--;
+
+    nvmeIOCmd             = (NVME_IO_COMMAND *)nvmeCmd->cmdDword;
+    g_nvmeArb.prevFusedSq = g_nvmeArb.fusedSq;
+    if (nvmeIOCmd->FUSE == NVME_FUSE_FIRST)
+    {
+        g_nvmeArb.fusedSq = sqIdx;
+        XTime_GetTime(&g_nvmeArb.fusedTime);
+    }
+    else
+        g_nvmeArb.fusedSq = NVME_ARB_SQ_NONE;
+
+    return 1;
+}
+
+/**
+ * @brief Return the last selected I/O command to the head of its SQ.
+ *
+ * The command will be selected again in the later arbitration, while the commands of the
+ * other SQs may be selected before it, so a deferred command doesn't block the other SQs.
+ *
+ * @note Must be called before selecting the next command.
+ *
+ * @param nvmeCmd the command returned by the last `arbitrate_nvme_io_cmd()`.
+ */
+void defer_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
+{
+    NVME_ARB_SQ_FIFO *sqFifo;
+
+    sqFifo = &g_nvmeArb.sqFifo[nvmeCmd->qID - 1];
+    ASSERT(sqFifo->cnt < NVME_ARB_SQ_FIFO_DEPTH);
+
+    sqFifo->head                     = (sqFifo->head + NVME_ARB_SQ_FIFO_DEPTH - 1) % NVME_ARB_SQ_FIFO_DEPTH;
+    sqFifo->cmdSlotTag[sqFifo->head] = nvmeCmd->cmdSlotTag;
+    sqFifo->cnt++;
+
+    g_nvmeArb.fusedSq = g_nvmeArb.prevFusedSq;
+}
@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_arbitration.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Command Arbiter
+// File Name: nvme_arbitration.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - declares the data structures and functions of the I/O command arbiter
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NVME_ARBITRATION_H_
+#define __NVME_ARBITRATION_H_
+
+#include "xtime_l.h"
+#include "nvme.h"
+
+/**
+ * @brief The max number of fetched I/O commands of a SQ waiting for arbitration.
+ *
+ * The size of I/O submission queue is limited to 256 entries by `handle_create_io_sq()`,
+ * so the commands of a SQ can never overflow its FIFO.
+ */
+#define NVME_ARB_SQ_FIFO_DEPTH 256
+
+#define NVME_ARB_BURST_NO_LIMIT 0x7 // the value of Arbitration Burst for no limit
+#define NVME_ARB_SQ_NONE        0xffff
+
+/**
+ * @brief How long the arbiter waits for the second command of a fused operation, in XTime
+ * counts. The fused operation is aborted once it expires, so a host that never submits the
+ * second command can't block the other SQs, check `arbitrate_nvme_io_cmd()`.
+ */
+#define NVME_ARB_FUSED_TIMEOUT (COUNTS_PER_SECOND / 1000) // user configurable factor, 1ms
+
+/**
+ * @brief The fetched I/O commands of a SQ that are waiting for arbitration.
+ *
+ * @note Only the slot tags are recorded, the commands stay in the command SRAM of the
+ * NVMe controller until they are completed, check `get_nvme_cmd_dword()`.
+ */
+typedef struct _NVME_ARB_SQ_FIFO
+{
+    unsigned short cmdSlotTag[NVME_ARB_SQ_FIFO_DEPTH];
+    unsigned short head;
+    unsigned short tail;
+    unsigned short cnt;
+    unsigned short reserved0;
+} NVME_ARB_SQ_FIFO;
+
+/**
+ * @brief The state of the Weighted Round Robin with Urgent Priority Class arbitration.
+ *
+ * The members except `sqFifo` are indexed by the priority class `NVME_SQ_PRIORITY_*`.
+ */
+typedef struct _NVME_ARB_CONTEXT
+{
+    NVME_ARB_SQ_FIFO sqFifo[MAX_NUM_OF_IO_SQ];
+    unsigned int credit[4];    // remaining commands of the WRR class in current round
+    unsigned int curSq[4];     // the SQ being served in the class
+    unsigned int burstLeft[4]; // remaining commands of `curSq` in current burst
+    unsigned int fusedSq;      // the SQ whose fused operation is not finished, or `NVME_ARB_SQ_NONE`
+    unsigned int prevFusedSq;  // `fusedSq` before the last command was selected
+    XTime fusedTime;           // when the first command of the fused operation was selected
+} NVME_ARB_CONTEXT;
+
+void init_nvme_arbitration();
+
+unsigned int fetch_nvme_cmd();
+
+void abort_nvme_cmd_of_deleted_sq(unsigned int cmdSlotTag);
+
+void abort_nvme_arb_sq(unsigned int sqIdx);
+
+unsigned int select_nvme_arb_sq(unsigned int prio);
+
+unsigned int arbitrate_nvme_io_cmd(NVME_COMMAND *nvmeCmd);
+
+void defer_nvme_io_cmd(NVME_COMMAND *nvmeCmd);
+
+#endif //__NVME_ARBITRATION_H_
@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_completion.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Completion Manager
+// File Name: nvme_completion.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - tracks the completions of NVMe commands posted by firmware
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include "debug.h"
+
+#include "nvme.h"
+#include "host_lld.h"
+#include "nvme_completion.h"
+
+#include "../statistics.h"
+
+NVME_CMD_CPL_ENTRY g_nvmeCmdCpl[NVME_CMD_SLOT_COUNT];
+
+/**
+ * @brief Reset the completion info of the command in the given slot.
+ *
+ * If `manualCpl` is set, the caller holds the completion until it calls the function
+ * `release_nvme_cmd_cpl()`, so the completion will not be posted while the requests of
+ * this command are still being created.
+ *
+ * @param cmdSlotTag the slot tag of the NVMe command.
+ * @param manualCpl whether the completion should be posted by firmware.
+ */
+void start_nvme_cmd_cpl(unsigned int cmdSlotTag, unsigned int manualCpl)
+{
+    g_nvmeCmdCpl[cmdSlotTag].pendingReqCnt   = manualCpl ? 1 : 0;
+    g_nvmeCmdCpl[cmdSlotTag].statusFieldWord = 0;
+    g_nvmeCmdCpl[cmdSlotTag].manualCpl       = manualCpl;
+    g_nvmeCmdCpl[cmdSlotTag].writeThrough    = 0;
+    g_nvmeCmdCpl[cmdSlotTag].statType        = NVME_CPL_STAT_NONE;
+}
+
+unsigned int is_nvme_cmd_manual_cpl(unsigned int cmdSlotTag)
+{
+    return g_nvmeCmdCpl[cmdSlotTag].manualCpl;
+}
+
+/**
+ * @brief Make the completion of the command wait for the NAND program of its data.
+ *
+ * Since the NAND requests will hold the completion, the completion must be posted by
+ * firmware. So the command is switched to manual completion if it wasn't.
+ *
+ * @warning Must be called before the requests of this command are created, otherwise the
+ * holds of the created requests will be lost.
+ *
+ * @param cmdSlotTag the slot tag of the NVMe command.
+ */
+void set_nvme_cmd_write_through(unsigned int cmdSlotTag)
+{
+    if (!g_nvmeCmdCpl[cmdSlotTag].manualCpl)
+    {
+        g_nvmeCmdCpl[cmdSlotTag].pendingReqCnt = 1;
+        g_nvmeCmdCpl[cmdSlotTag].manualCpl     = 1;
+    }
+
+    g_nvmeCmdCpl[cmdSlotTag].writeThrough = 1;
+}
+
+unsigned int is_nvme_cmd_write_through(unsigned int cmdSlotTag)
+{
+    return g_nvmeCmdCpl[cmdSlotTag].writeThrough;
+}
+
+static void update_nvme_cmd_stat(unsigned int statType, unsigned int nlb)
+{
+    if (statType == NVME_CPL_STAT_READ)
+    {
+        ssdStatistics.hostReadCmdCnt++;
+        ssdStatistics.hostReadSectorCnt += (nlb + 1) * (BYTES_PER_NVME_BLOCK / BYTES_PER_SECTOR);
+    }
+    else if (statType == NVME_CPL_STAT_WRITE)
+    {
+        ssdStatistics.hostWriteCmdCnt++;
+        ssdStatistics.hostWriteSectorCnt += (nlb + 1) * (BYTES_PER_NVME_BLOCK / BYTES_PER_SECTOR);
+    }
+}
+
+/**
+ * @brief Count the command in the SMART host counters once it is completed successfully.
+ *
+ * A command with auto completion is counted right away, since the NVMe controller always
+ * posts it without error after its host DMA. A command with manual completion is counted
+ * by `release_nvme_cmd_cpl()` only if no error was reported, e.g., a write-through write
+ * whose NAND program failed is not counted.
+ *
+ * @note Must be called before the last hold of the completion is released.
+ *
+ * @param cmdSlotTag the slot tag of the NVMe command.
+ * @param statType the host counters to be updated, `NVME_CPL_STAT_*`.
+ * @param nlb the number of logical blocks of the command, 0's based.
+ */
+void count_nvme_cmd_cpl(unsigned int cmdSlotTag, unsigned int statType, unsigned int nlb)
+{
+    if (!g_nvmeCmdCpl[cmdSlotTag].manualCpl)
+    {
+        update_nvme_cmd_stat(statType, nlb);
+        return;
+    }
+
+    g_nvmeCmdCpl[cmdSlotTag].statType = statType;
+    g_nvmeCmdCpl[cmdSlotTag].statNlb  = nlb;
+}
+
+/**
+ * @brief Report an error for the command, only the first error will be kept.
+ */
+void set_nvme_cmd_cpl_status(unsigned int cmdSlotTag, unsigned int statusFieldWord)
+{
+    if (g_nvmeCmdCpl[cmdSlotTag].statusFieldWord == 0)
+        g_nvmeCmdCpl[cmdSlotTag].statusFieldWord = statusFieldWord;
+}
+
+unsigned int get_nvme_cmd_cpl_status(unsigned int cmdSlotTag)
+{
+    return g_nvmeCmdCpl[cmdSlotTag].statusFieldWord;
+}
+
+/**
+ * @brief Prevent the completion of the command from being posted until the corresponding
+ * `release_nvme_cmd_cpl()` is called.
+ *
+ * @note Nothing to do if the completion is posted by the NVMe controller.
+ */
+void hold_nvme_cmd_cpl(unsigned int cmdSlotTag)
+{
+    if (g_nvmeCmdCpl[cmdSlotTag].manualCpl)
+        g_nvmeCmdCpl[cmdSlotTag].pendingReqCnt++;
+}
+
+/**
+ * @brief Release a hold of the completion, and post the completion if it is the last one.
+ *
+ * @param cmdSlotTag the slot tag of the NVMe command.
+ */
+void release_nvme_cmd_cpl(unsigned int cmdSlotTag)
+{
+    if (!g_nvmeCmdCpl[cmdSlotTag].manualCpl)
+        return;
+
+    ASSERT(g_nvmeCmdCpl[cmdSlotTag].pendingReqCnt);
+    if (--g_nvmeCmdCpl[cmdSlotTag].pendingReqCnt)
+        return;
+
+    if (g_nvmeCmdCpl[cmdSlotTag].statusFieldWord == 0)
+        update_nvme_cmd_stat(g_nvmeCmdCpl[cmdSlotTag].statType, g_nvmeCmdCpl[cmdSlotTag].statNlb);
+
+    set_auto_nvme_cpl(cmdSlotTag, 0, g_nvmeCmdCpl[cmdSlotTag].statusFieldWord);
+}
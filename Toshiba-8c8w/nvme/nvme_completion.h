@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_completion.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Completion Manager
+// File Name: nvme_completion.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - declares the functions for tracking the NVMe completions posted by firmware
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NVME_COMPLETION_H_
+#define __NVME_COMPLETION_H_
+
+#include "nvme.h"
+#include "host_lld.h"
+
+#define NVME_CMD_SLOT_COUNT (1 << P_SLOT_TAG_WIDTH)
+
+/**
+ * @brief The completion info of a NVMe command, indexed by the command slot tag.
+ *
+ * By default, the NVMe controller will post the completion of an I/O command once all its
+ * host DMA are done (auto completion). But if `manualCpl` is set, the completion is posted
+ * by firmware after all the requests holding this command are done, check the functions
+ * `hold_nvme_cmd_cpl()` and `release_nvme_cmd_cpl()`.
+ *
+ * If `writeThrough` is set, the written slices of this command are programmed right after
+ * they are received, and the NAND requests also hold the completion until the program is
+ * done, check `ReqTransSliceToLowLevel()`.
+ *
+ * The SMART host counters of a command with manual completion are updated when it is
+ * completed without error, check `count_nvme_cmd_cpl()`.
+ */
+typedef struct _NVME_CMD_CPL_ENTRY
+{
+    unsigned int pendingReqCnt : 16;   // the number of requests holding the completion
+    unsigned int statusFieldWord : 16; // the status to be reported
+    unsigned int manualCpl : 1;        // 1 if the completion is posted by firmware
+    unsigned int writeThrough : 1;     // 1 if the completion should wait for NAND program
+    unsigned int statType : 2;         // the host counters to be updated, `NVME_CPL_STAT_*`
+    unsigned int reserved0 : 12;
+    unsigned int statNlb : 16;         // the number of logical blocks of this command, 0's based
+} NVME_CMD_CPL_ENTRY;
+
+#define NVME_CPL_STAT_NONE  0 // not counted in the host counters
+#define NVME_CPL_STAT_READ  1 // counted as a host read command
+#define NVME_CPL_STAT_WRITE 2 // counted as a host write command
+
+void start_nvme_cmd_cpl(unsigned int cmdSlotTag, unsigned int manualCpl);
+
+unsigned int is_nvme_cmd_manual_cpl(unsigned int cmdSlotTag);
+
+void set_nvme_cmd_write_through(unsigned int cmdSlotTag);
+
+void count_nvme_cmd_cpl(unsigned int cmdSlotTag, unsigned int statType, unsigned int nlb);
+
+unsigned int is_nvme_cmd_write_through(unsigned int cmdSlotTag);
+
+void set_nvme_cmd_cpl_status(unsigned int cmdSlotTag, unsigned int statusFieldWord);
+
+unsigned int get_nvme_cmd_cpl_status(unsigned int cmdSlotTag);
+
+void hold_nvme_cmd_cpl(unsigned int cmdSlotTag);
+
+void release_nvme_cmd_cpl(unsigned int cmdSlotTag);
+
+#endif //__NVME_COMPLETION_H_
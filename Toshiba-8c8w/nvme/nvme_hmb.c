@@ -0,0 +1,331 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_hmb.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Host Memory Buffer
+// File Name: nvme_hmb.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - handle the Set Features (Host Memory Buffer) command
+//   - transfer data between the device memory and the host memory buffer
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "debug.h"
+#include "io_access.h"
+
+#include "nvme.h"
+#include "host_lld.h"
+#include "nvme_hmb.h"
+#include "../memory_map.h"
+
+NVME_HMB_CONTEXT g_nvmeHmb;
+
+#ifdef HMB_SIMULATION
+// the simulated HMB takes the place of the resident map, check `HMB_SIM_BUFFER_ADDR`
+static unsigned char *const hmbSimBuffer = (unsigned char *)HMB_SIM_BUFFER_ADDR;
+
+/**
+ * @brief Delay the caller to model the latency of a HMB access.
+ */
+static void wait_nvme_hmb_sim_latency()
+{
+    XTime startTime, curTime;
+
+    XTime_GetTime(&startTime);
+    do
+        XTime_GetTime(&curTime);
+    while (curTime - startTime < HMB_SIM_ACCESS_LATENCY);
+}
+#endif
+
+/**
+ * @brief Reset the HMB context when the controller is enabled.
+ *
+ * The HMB is always disabled after a controller reset. However, if `HMB_SIMULATION` is
+ * defined, the simulated HMB with the minimum size is enabled immediately, so the map
+ * cache works even if the host driver never enables the HMB.
+ */
+void init_nvme_hmb()
+{
+    memset(&g_nvmeHmb, 0, sizeof(NVME_HMB_CONTEXT));
+
+#if defined(HMB_SIMULATION) && SUPPORT_DFTL
+    ASSERT((unsigned long long)HMB_MIN_PAGE_COUNT * BYTES_PER_HMB_PAGE <= sizeof(LOGICAL_SLICE_MAP));
+
+    g_nvmeHmb.numOfPage = HMB_MIN_PAGE_COUNT;
+    g_nvmeHmb.enabled   = 1;
+    MoveMapToHmb();
+#endif
+}
+
+#if !defined(HMB_SIMULATION) && SUPPORT_DFTL
+/**
+ * @brief Copy the Host Memory Buffer Descriptor List from the host.
+ *
+ * The list is physically contiguous and may cross a memory page boundary, so it is split
+ * into two direct DMAs like the PRP entries of the admin commands.
+ *
+ * @param pcieAddrH the upper 32 bits of the list address (HMDLUA).
+ * @param pcieAddrL the lower 32 bits of the list address (HMDLLA).
+ * @param numOfDesc the number of entries in the list (HMDLEC).
+ */
+static void fetch_nvme_hmb_desc_list(unsigned int pcieAddrH, unsigned int pcieAddrL, unsigned int numOfDesc)
+{
+    unsigned int devAddr = ADMIN_CMD_DRAM_DATA_BUFFER;
+    unsigned int len     = numOfDesc * sizeof(NVME_HMB_DESCRIPTOR_ENTRY);
+    unsigned int dmaLen;
+
+    dmaLen = 0x1000 - (pcieAddrL & 0xFFF);
+    if (dmaLen > len)
+        dmaLen = len;
+
+    set_direct_rx_dma(devAddr, pcieAddrH, pcieAddrL, dmaLen);
+    if (dmaLen != len)
+        set_direct_rx_dma(devAddr + dmaLen, pcieAddrH + (pcieAddrL + dmaLen < pcieAddrL), pcieAddrL + dmaLen,
+                          len - dmaLen);
+    check_direct_rx_dma_done();
+
+    memcpy(g_nvmeHmb.desc, (void *)devAddr, len);
+}
+#endif
+
+/**
+ * @brief Enable or disable the host memory buffer.
+ *
+ * When the HMB is enabled, the descriptor list is copied to the device and the whole
+ * logical slice map is moved from the translation pages to the HMB, so the HMB must be
+ * large enough for the whole map (`HMMIN`). When the HMB is disabled, the map is written
+ * back to NAND before the command completes, since the host may release the buffer after
+ * that.
+ *
+ * @note The HMB is only requested in DFTL mode, otherwise `HMPRE` and `HMMIN` are reported
+ * as 0 and enabling the HMB is rejected.
+ *
+ * @param nvmeAdminCmd the Set Features command.
+ * @param nvmeCPL the completion entry to be updated.
+ */
+void handle_set_nvme_hmb(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
+{
+    ADMIN_SET_FEATURES_HOST_MEMORY_BUFFER_DW11 hmbConfig;
+#if SUPPORT_DFTL
+    unsigned int numOfPage, numOfDesc, totalPage;
+#endif
+
+    hmbConfig.dword   = nvmeAdminCmd->dword11;
+    nvmeCPL->dword[0] = 0x0;
+    nvmeCPL->specific = 0x0;
+
+    if (!hmbConfig.EHM)
+    {
+        disable_nvme_hmb();
+        return;
+    }
+
+#if !SUPPORT_DFTL
+    nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+#else
+    numOfPage = nvmeAdminCmd->dword12; // HSIZE
+    numOfDesc = nvmeAdminCmd->dword15; // HMDLEC
+
+    // the HMB can not be resized while it is in use
+    if (g_nvmeHmb.enabled)
+    {
+        nvmeCPL->statusField.SC = SC_COMMAND_SEQUENCE_ERROR;
+        return;
+    }
+
+    if ((numOfPage < HMB_MIN_PAGE_COUNT) || (numOfDesc == 0) || (numOfDesc > HMB_MAX_DESC_ENTRY_COUNT) ||
+        (nvmeAdminCmd->dword13 & 0xF))
+    {
+        nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+        return;
+    }
+
+#ifndef HMB_SIMULATION
+    unsigned int iDesc;
+
+    fetch_nvme_hmb_desc_list(nvmeAdminCmd->dword14, nvmeAdminCmd->dword13, numOfDesc);
+
+    totalPage = 0;
+    for (iDesc = 0; iDesc < numOfDesc; iDesc++)
+    {
+        // the upper bits of the PCIe address are limited by the host DMA engine
+        if ((g_nvmeHmb.desc[iDesc].BADD[0] & (BYTES_PER_HMB_PAGE - 1)) ||
+            (g_nvmeHmb.desc[iDesc].BADD[1] >= 0x10000) || (g_nvmeHmb.desc[iDesc].BSIZE == 0))
+        {
+            nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+            return;
+        }
+        totalPage += g_nvmeHmb.desc[iDesc].BSIZE;
+    }
+
+    if (totalPage < HMB_MIN_PAGE_COUNT)
+    {
+        nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+        return;
+    }
+#else
+    // the descriptors are not used, the HMB is backed by `hmbSimBuffer`
+    totalPage = HMB_MIN_PAGE_COUNT;
+#endif
+
+    g_nvmeHmb.numOfPage = totalPage;
+    g_nvmeHmb.numOfDesc = numOfDesc;
+    g_nvmeHmb.enabled   = 1;
+
+    MoveMapToHmb();
+#endif
+}
+
+/**
+ * @brief Move the logical slice map back to NAND and stop using the HMB.
+ *
+ * Called when the host disables the HMB, and on the shutdown and the reset of the
+ * controller, while the host memory is still accessible.
+ */
+void disable_nvme_hmb()
+{
+    if (!g_nvmeHmb.enabled)
+        return;
+
+    MoveMapToNand();
+    g_nvmeHmb.enabled = 0;
+}
+
+unsigned int is_nvme_hmb_enabled() { return g_nvmeHmb.enabled; }
+
+#ifndef HMB_SIMULATION
+/**
+ * @brief Translate an offset of the HMB into the PCIe address.
+ *
+ * The buffers of the descriptors are concatenated in the list order.
+ *
+ * @param hmbOffset the byte offset in the HMB.
+ * @param pcieAddrH the upper 32 bits of the PCIe address.
+ * @param pcieAddrL the lower 32 bits of the PCIe address.
+ * @return unsigned int the remaining bytes in the same descriptor.
+ */
+static unsigned int get_nvme_hmb_pcie_addr(unsigned int hmbOffset, unsigned int *pcieAddrH,
+                                           unsigned int *pcieAddrL)
+{
+    unsigned int iDesc, descBytes;
+
+    for (iDesc = 0; iDesc < g_nvmeHmb.numOfDesc; iDesc++)
+    {
+        descBytes = g_nvmeHmb.desc[iDesc].BSIZE * BYTES_PER_HMB_PAGE;
+        if (hmbOffset < descBytes)
+        {
+            *pcieAddrL = g_nvmeHmb.desc[iDesc].BADD[0] + hmbOffset;
+            *pcieAddrH = g_nvmeHmb.desc[iDesc].BADD[1] + (*pcieAddrL < g_nvmeHmb.desc[iDesc].BADD[0]);
+            return descBytes - hmbOffset;
+        }
+        hmbOffset -= descBytes;
+    }
+
+    ASSERT(!"[WARNING] HMB offset out of range [WARNING]");
+    return 0;
+}
+#endif
+
+/**
+ * @brief Copy data from the HMB to the device memory.
+ *
+ * The data is transferred in chunks of at most one memory page, and a chunk never crosses
+ * the end of a descriptor.
+ *
+ * @param hmbOffset the byte offset in the HMB, must be 4-byte aligned.
+ * @param devAddr the destination address in the device memory.
+ * @param len the length in bytes.
+ */
+void read_nvme_hmb(unsigned int hmbOffset, unsigned int devAddr, unsigned int len)
+{
+    ASSERT(g_nvmeHmb.enabled && (hmbOffset + len <= g_nvmeHmb.numOfPage * BYTES_PER_HMB_PAGE));
+
+#ifdef HMB_SIMULATION
+    wait_nvme_hmb_sim_latency();
+    memcpy((void *)devAddr, hmbSimBuffer + hmbOffset, len);
+#else
+    unsigned int pcieAddrH, pcieAddrL, dmaLen;
+
+    while (len)
+    {
+        dmaLen = get_nvme_hmb_pcie_addr(hmbOffset, &pcieAddrH, &pcieAddrL);
+        if (dmaLen > 0x1000 - (pcieAddrL & 0xFFF))
+            dmaLen = 0x1000 - (pcieAddrL & 0xFFF);
+        if (dmaLen > len)
+            dmaLen = len;
+
+        set_direct_rx_dma(devAddr, pcieAddrH, pcieAddrL, dmaLen);
+        hmbOffset += dmaLen;
+        devAddr += dmaLen;
+        len -= dmaLen;
+    }
+    check_direct_rx_dma_done();
+#endif
+}
+
+/**
+ * @brief Copy data from the device memory to the HMB.
+ *
+ * @sa `read_nvme_hmb()`.
+ *
+ * @param hmbOffset the byte offset in the HMB, must be 4-byte aligned.
+ * @param devAddr the source address in the device memory.
+ * @param len the length in bytes.
+ */
+void write_nvme_hmb(unsigned int hmbOffset, unsigned int devAddr, unsigned int len)
+{
+    ASSERT(g_nvmeHmb.enabled && (hmbOffset + len <= g_nvmeHmb.numOfPage * BYTES_PER_HMB_PAGE));
+
+#ifdef HMB_SIMULATION
+    wait_nvme_hmb_sim_latency();
+    memcpy(hmbSimBuffer + hmbOffset, (void *)devAddr, len);
+#else
+    unsigned int pcieAddrH, pcieAddrL, dmaLen;
+
+    while (len)
+    {
+        dmaLen = get_nvme_hmb_pcie_addr(hmbOffset, &pcieAddrH, &pcieAddrL);
+        if (dmaLen > 0x1000 - (pcieAddrL & 0xFFF))
+            dmaLen = 0x1000 - (pcieAddrL & 0xFFF);
+        if (dmaLen > len)
+            dmaLen = len;
+
+        set_direct_tx_dma(devAddr, pcieAddrH, pcieAddrL, dmaLen);
+        hmbOffset += dmaLen;
+        devAddr += dmaLen;
+        len -= dmaLen;
+    }
+    check_direct_tx_dma_done();
+#endif
+}
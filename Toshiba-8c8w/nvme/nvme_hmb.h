@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_hmb.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Host Memory Buffer
+// File Name: nvme_hmb.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - declares the descriptor list of the host memory buffer
+//   - declares the functions for accessing the host memory buffer by offset
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NVME_HMB_H_
+#define __NVME_HMB_H_
+
+#include "xtime_l.h"
+#include "nvme.h"
+#include "../map_cache.h"
+
+#define HMB_MAX_DESC_ENTRY_COUNT 32   // HMMAXD
+#define BYTES_PER_HMB_PAGE       4096 // the memory page size, CC.MPS is assumed to be 0
+
+// the HMB holds the whole logical slice map in place of the translation pages of the DFTL mode
+#if SUPPORT_DFTL
+#define HMB_MIN_PAGE_COUNT (MAP_SEGMENTS_PER_SSD * BYTES_PER_MAP_SEGMENT / BYTES_PER_HMB_PAGE)
+#else
+#define HMB_MIN_PAGE_COUNT 0
+#endif
+
+/**
+ * @brief The simulated latency of a HMB access in `XTime` counts.
+ *
+ * If `HMB_SIMULATION` is defined, the HMB is backed by a reserved region of the device
+ * DRAM instead of the host memory, check `HMB_SIM_BUFFER_ADDR`, so the map cache can be
+ * evaluated without a host driver. Each access is delayed by this latency to model the
+ * PCIe round trip.
+ */
+#define HMB_SIM_ACCESS_LATENCY (COUNTS_PER_SECOND / 1000000 * 2) // about 2us per access
+
+#if defined(HMB_SIMULATION) && !SUPPORT_DFTL
+#error "The HMB is only used in DFTL mode, enable SUPPORT_DFTL to simulate it"
+#endif
+
+/**
+ * @brief The host memory buffer enabled by Set Features (Host Memory Buffer).
+ *
+ * The descriptor list is copied from the host when the HMB is enabled, and the buffers
+ * of all the entries are concatenated into a linear address space, check
+ * `read_nvme_hmb()`.
+ */
+typedef struct _NVME_HMB_CONTEXT
+{
+    unsigned int enabled;
+    unsigned int numOfPage; // HSIZE, the total size in memory pages
+    unsigned int numOfDesc;
+    NVME_HMB_DESCRIPTOR_ENTRY desc[HMB_MAX_DESC_ENTRY_COUNT];
+} NVME_HMB_CONTEXT;
+
+void init_nvme_hmb();
+
+void handle_set_nvme_hmb(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL);
+
+void disable_nvme_hmb();
+
+unsigned int is_nvme_hmb_enabled();
+
+void read_nvme_hmb(unsigned int hmbOffset, unsigned int devAddr, unsigned int len);
+
+void write_nvme_hmb(unsigned int hmbOffset, unsigned int devAddr, unsigned int len);
+
+extern NVME_HMB_CONTEXT g_nvmeHmb;
+
+#endif //__NVME_HMB_H_
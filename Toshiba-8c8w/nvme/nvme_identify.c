@@ -55,11 +55,14 @@
 #include "nvme.h"
 #include "nvme_identify.h"
 #include "../ftl_config.h"
+#include "../namespace.h"
+#include "nvme_hmb.h"
 
 void identify_controller(unsigned int pBuffer)
 {
     ADMIN_IDENTIFY_CONTROLLER *identifyCNTL;
     ADMIN_IDENTIFY_POWER_STATE_DESCRIPTOR *powerStateDesc;
+    unsigned long long capacity;
 
     identifyCNTL = (ADMIN_IDENTIFY_CONTROLLER *)pBuffer;
 
@@ -82,12 +85,13 @@ void identify_controller(unsigned int pBuffer)
     identifyCNTL->IEEE[1] = 0xD2;
     identifyCNTL->IEEE[2] = 0x5C;
     identifyCNTL->CMIC    = 0x0;
-    identifyCNTL->MDTS    = 0x8;
-    identifyCNTL->CNTLID  = 0x9;
+    identifyCNTL->MDTS    = MAX_DATA_TRANSFER_SIZE_EXP;
+    identifyCNTL->CNTLID  = NVME_CONTROLLER_ID;
 
     identifyCNTL->OACS.supportsSecuritySendSecurityReceive      = 0x0;
     identifyCNTL->OACS.supportsFormatNVM                        = 0x0;
     identifyCNTL->OACS.supportsFirmwareActivateFirmwareDownload = 0x0;
+    identifyCNTL->OACS.supportsNamespaceManagement              = 0x1;
 
     identifyCNTL->ACL  = 0x3;
     identifyCNTL->AERL = 0x3;
@@ -95,7 +99,7 @@ void identify_controller(unsigned int pBuffer)
     identifyCNTL->FRMW.firstFirmwareSlotReadOnly      = 0x1;
     identifyCNTL->FRMW.supportedNumberOfFirmwareSlots = 0x1;
 
-    identifyCNTL->LPA.supportsSMARTHealthInformationLogPage = 0x0;
+    identifyCNTL->LPA.supportsSMARTHealthInformationLogPage = 0x1;
 
     identifyCNTL->ELPE  = 0x8;
     identifyCNTL->NPSS  = 0x0;
@@ -108,13 +112,31 @@ void identify_controller(unsigned int pBuffer)
     identifyCNTL->CQES.requiredCompletionQueueEntrySize = 0x4;
     identifyCNTL->CQES.maximumCompletionQueueEntrySize  = 0x4;
 
-    identifyCNTL->NN = 0x1;
+    // the capacity committed to the namespaces includes their over-provisioning space
+    capacity                 = (unsigned long long)GetTotalCapacity() * BYTES_PER_NVME_BLOCK;
+    identifyCNTL->TNVMCAP[0] = (unsigned int)capacity;
+    identifyCNTL->TNVMCAP[1] = (unsigned int)(capacity >> 32);
+    capacity                 = (unsigned long long)GetUnallocatedCapacity() * BYTES_PER_NVME_BLOCK;
+    identifyCNTL->UNVMCAP[0] = (unsigned int)capacity;
+    identifyCNTL->UNVMCAP[1] = (unsigned int)(capacity >> 32);
 
-    identifyCNTL->ONCS.supportsCompare            = 0x0;
+    // the HMB holds the whole logical slice map, in 4KB units
+    identifyCNTL->HMPRE   = HMB_MIN_PAGE_COUNT;
+    identifyCNTL->HMMIN   = HMB_MIN_PAGE_COUNT;
+    identifyCNTL->HMMINDS = 0x0; // no limit
+    identifyCNTL->HMMAXD  = HMB_MAX_DESC_ENTRY_COUNT;
+
+    identifyCNTL->NN = MAX_NUM_OF_NAMESPACE;
+
+    identifyCNTL->ONCS.supportsCompare            = 0x1;
     identifyCNTL->ONCS.supportsWriteUncorrectable = 0x0;
     identifyCNTL->ONCS.supportsDataSetManagement  = 0x0;
+    identifyCNTL->ONCS.supportsWriteZeroes        = 0x1;
+    identifyCNTL->ONCS.supportsCopy               = 0x1;
+
+    identifyCNTL->OCFS = 0x1; // only the Descriptor Format 0h
 
-    identifyCNTL->FUSES.supportsCompareWrite = 0x0;
+    identifyCNTL->FUSES.supportsCompareWrite = 0x1;
 
     identifyCNTL->FNA.formatAppliesToAllNamespaces      = 0x0;
     identifyCNTL->FNA.secureEraseAppliesToAllNamespaces = 0x0;
@@ -143,7 +165,18 @@ void identify_controller(unsigned int pBuffer)
     powerStateDesc->RWL   = 0x0;
 }
 
-void identify_namespace(unsigned int pBuffer)
+/**
+ * @brief Fill the Identify Namespace data structure of the specified namespace.
+ *
+ * The over-provisioning space and the die set of the namespace are reported in the vendor
+ * specific fields, which are also used by `handle_namespace_management()` for creating a
+ * namespace.
+ *
+ * @param pBuffer the DRAM address of the buffer to be filled.
+ * @param nsid the NSID of an allocated namespace, or `NVME_NSID_ALL` for the capabilities
+ * common to all namespaces, whose size fields are all zeros.
+ */
+void identify_namespace(unsigned int pBuffer, unsigned int nsid)
 {
     ADMIN_IDENTIFY_NAMESPACE *identifyNS;
     ADMIN_IDENTIFY_FORMAT_DATA *formatData;
@@ -151,12 +184,19 @@ void identify_namespace(unsigned int pBuffer)
 
     memset(identifyNS, 0, sizeof(ADMIN_IDENTIFY_NAMESPACE));
 
-    identifyNS->NSZE[0] = storageCapacity_L;
-    identifyNS->NSZE[1] = STORAGE_CAPACITY_H;
-    identifyNS->NCAP[0] = storageCapacity_L;
-    identifyNS->NCAP[1] = STORAGE_CAPACITY_H;
-    identifyNS->NUSE[0] = storageCapacity_L;
-    identifyNS->NUSE[1] = STORAGE_CAPACITY_H;
+    if (nsid != NVME_NSID_ALL)
+    {
+        identifyNS->NSZE[0] = GetNamespaceCapacity(nsid);
+        identifyNS->NSZE[1] = STORAGE_CAPACITY_H;
+        identifyNS->NCAP[0] = GetNamespaceCapacity(nsid);
+        identifyNS->NCAP[1] = STORAGE_CAPACITY_H;
+        identifyNS->NUSE[0] = GetNamespaceCapacity(nsid);
+        identifyNS->NUSE[1] = STORAGE_CAPACITY_H;
+
+        identifyNS->OPP  = NS_ENTRY(nsid)->opPercent;
+        identifyNS->FDIE = NS_ENTRY(nsid)->firstDie;
+        identifyNS->NDIE = NS_ENTRY(nsid)->numOfDie;
+    }
 
     identifyNS->NSFEAT.supportsThinProvisioning = 0x0;
 
@@ -186,9 +226,46 @@ void identify_namespace(unsigned int pBuffer)
     identifyNS->RESCAP.supportsWriteExclusiveAllRegistrants  = 0x0;
     identifyNS->RESCAP.supportsExclusiveAccessAllRegistrants = 0x0;
 
+    // the unmapped slices are read as zeros, check `DataReadFromNand()`
+    identifyNS->DLFEAT.readBehavior                    = 0x1;
+    identifyNS->DLFEAT.supportsDeallocateInWriteZeroes = 0x1;
+    identifyNS->DLFEAT.guardFieldIsCrc                 = 0x0;
+
+    identifyNS->MSSRL = COPY_MAX_RANGE_LENGTH;
+    identifyNS->MCL   = COPY_MAX_LENGTH;
+    identifyNS->MSRC  = COPY_MAX_SOURCE_RANGES - 1;
+
     formatData = &identifyNS->LBAFx[0];
 
     formatData->MS    = 0x0;
     formatData->LBADS = 0xC;
     formatData->RP    = 0x2;
 }
+
+/**
+ * @brief Fill the physical geometry reported by the vendor specific `ADMIN_OCSSD_GEOMETRY`.
+ *
+ * Only the blocks reserved for the physical address commands are exposed, the blocks owned
+ * by the FTL, the blocks reserved for bad block remapping and the extended blocks are hidden
+ * from the host. The reserved blocks of a die are reported as a single LUN.
+ *
+ * @param pBuffer the DRAM address of the buffer to be filled.
+ */
+void identify_ocssd_geometry(unsigned int pBuffer)
+{
+    ADMIN_OCSSD_GEOMETRY_DATA *geometry;
+
+    geometry = (ADMIN_OCSSD_GEOMETRY_DATA *)pBuffer;
+
+    memset(geometry, 0, sizeof(ADMIN_OCSSD_GEOMETRY_DATA));
+
+    geometry->version           = 0x1;
+    geometry->numOfChannels     = USER_CHANNELS;
+    geometry->waysPerChannel    = USER_WAYS;
+    geometry->lunsPerWay        = 1;
+    geometry->blocksPerLun      = OCSSD_PHY_BLOCKS_PER_DIE;
+    geometry->pagesPerBlock     = USER_PAGES_PER_BLOCK;
+    geometry->bytesPerPage      = BYTES_PER_DATA_REGION_OF_SLICE;
+    geometry->bytesPerSpare     = BYTES_PER_SPARE_REGION_OF_SLICE;
+    geometry->bytesPerNvmeBlock = BYTES_PER_NVME_BLOCK;
+}
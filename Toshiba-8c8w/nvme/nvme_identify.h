@@ -53,9 +53,12 @@
 #define SERIAL_NUMBER           "SSDD515T"
 #define MODEL_NUMBER            "Cosmos+ OpenSSD"
 #define FIRMWARE_REVISION       "TYPE0005"
+#define NVME_CONTROLLER_ID      0x9
 
 void identify_controller(unsigned int pBuffer);
 
-void identify_namespace(unsigned int pBuffer);
+void identify_namespace(unsigned int pBuffer, unsigned int nsid);
+
+void identify_ocssd_geometry(unsigned int pBuffer);
 
 #endif //__NVME_IDENTIFY_H_
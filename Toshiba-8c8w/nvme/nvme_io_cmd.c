@@ -56,9 +56,55 @@
 #include "nvme.h"
 #include "host_lld.h"
 #include "nvme_io_cmd.h"
+#include "nvme_completion.h"
 
 #include "../ftl_config.h"
+#include "../address_translation.h"
+#include "../request_allocation.h"
 #include "../request_transform.h"
+#include "../namespace.h"
+#include "../write_throttle.h"
+
+extern NVME_CONTEXT g_nvmeTask;
+
+NVME_FUSED_CMD g_nvmeFusedCmd;
+
+/**
+ * @brief Drop the unfinished fused operation.
+ *
+ * @note Should be called when the controller is enabled, the held completion of the first
+ * command is dropped with the command slots of the NVMe controller.
+ */
+void init_nvme_fused_cmd()
+{
+    g_nvmeFusedCmd.valid = 0;
+}
+
+/**
+ * @brief Abort the first command of the unfinished fused operation, if any.
+ *
+ * Called by the arbiter when the second command is not submitted in time, check
+ * `NVME_ARB_FUSED_TIMEOUT`, or when the SQ of the fused operation is deleted. If the second
+ * command still comes later, it is aborted by `check_nvme_fused_cmd()` since its first
+ * command is gone.
+ *
+ * @param sc the status code (generic command status) of the aborted command.
+ */
+void abort_nvme_fused_cmd(unsigned int sc)
+{
+    NVME_COMPLETION nvmeCPL;
+
+    if (!g_nvmeFusedCmd.valid)
+        return;
+
+    nvmeCPL.dword[0]       = 0;
+    nvmeCPL.specific       = 0x0;
+    nvmeCPL.statusField.SC = sc;
+
+    g_nvmeFusedCmd.valid = 0;
+    set_nvme_cmd_cpl_status(g_nvmeFusedCmd.cmdSlotTag, nvmeCPL.statusFieldWord);
+    release_nvme_cmd_cpl(g_nvmeFusedCmd.cmdSlotTag);
+}
 
 /**
  * @brief The entry function for translating the given NVMe command into slice requests.
@@ -85,16 +131,25 @@ void handle_nvme_io_read(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
     startLba[1] = nvmeIOCmd->dword[11];
     nlb         = readInfo12.NLB;
 
-    ASSERT(startLba[0] < storageCapacity_L && (startLba[1] < STORAGE_CAPACITY_H || startLba[1] == 0));
+    // the LBA range was checked by `check_nvme_io_cmd_namespace()`
     // ASSERT(nlb < MAX_NUM_OF_NLB);
     ASSERT((nvmeIOCmd->PRP1[0] & 0x3) == 0 && (nvmeIOCmd->PRP2[0] & 0x3) == 0); // error
     ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
 
-    ReqTransNvmeToSlice(cmdSlotTag, startLba[0], nlb, IO_NVM_READ);
+    ReqTransNvmeToSlice(cmdSlotTag, startLba[0] + GetNamespaceStartLba(nvmeIOCmd->NSID), nlb, IO_NVM_READ);
+
+    count_nvme_cmd_cpl(cmdSlotTag, NVME_CPL_STAT_READ, nlb);
 }
 
 /**
- * Entry point for NVM write commands.
+ * @brief Entry point for NVM write commands.
+ *
+ * If the FUA bit is set or the volatile write cache is disabled, the data of this command
+ * must be on the flash before the command is completed, so the command is marked as
+ * write-through and its completion will wait for the NAND program instead of the host DMA.
+ *
+ * @param cmdSlotTag the entry index of the given NVMe command.
+ * @param nvmeIOCmd a pointer points to the instance of given NVMe command.
  */
 void handle_nvme_io_write(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
 {
@@ -108,26 +163,462 @@ void handle_nvme_io_write(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
     // writeInfo13.dword = nvmeIOCmd->dword[13];
     // writeInfo15.dword = nvmeIOCmd->dword[15];
 
-    // if(writeInfo12.FUA == 1)
-    //	xil_printf("write FUA\r\n");
+    if ((writeInfo12.FUA == 1) || (g_nvmeTask.cacheEn == 0))
+        set_nvme_cmd_write_through(cmdSlotTag);
 
     startLba[0] = nvmeIOCmd->dword[10];
     startLba[1] = nvmeIOCmd->dword[11];
     nlb         = writeInfo12.NLB;
 
-    ASSERT(startLba[0] < storageCapacity_L && (startLba[1] < STORAGE_CAPACITY_H || startLba[1] == 0));
     // ASSERT(nlb < MAX_NUM_OF_NLB);
     ASSERT((nvmeIOCmd->PRP1[0] & 0xF) == 0 && (nvmeIOCmd->PRP2[0] & 0xF) == 0);
     ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
 
-    ReqTransNvmeToSlice(cmdSlotTag, startLba[0], nlb, IO_NVM_WRITE);
+    ReqTransNvmeToSlice(cmdSlotTag, startLba[0] + GetNamespaceStartLba(nvmeIOCmd->NSID), nlb, IO_NVM_WRITE);
+
+    count_nvme_cmd_cpl(cmdSlotTag, NVME_CPL_STAT_WRITE, nlb);
+}
+
+/**
+ * @brief Entry point for NVM Compare commands.
+ *
+ * The data of host is compared with the stored data slice by slice, and a mismatch is
+ * reported as Compare Failure, check `ReqTransCompareSliceToLowLevel()`.
+ *
+ * @note The completion is always posted by firmware, check `handle_nvme_io_cmd()`.
+ *
+ * @param cmdSlotTag the entry index of the given NVMe command.
+ * @param nvmeIOCmd a pointer points to the instance of given NVMe command.
+ */
+void handle_nvme_io_compare(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+    IO_READ_COMMAND_DW12 compareInfo12;
+    unsigned int startLba[2];
+    unsigned int nlb;
+
+    compareInfo12.dword = nvmeIOCmd->dword[12];
+
+    startLba[0] = nvmeIOCmd->dword[10];
+    startLba[1] = nvmeIOCmd->dword[11];
+    nlb         = compareInfo12.NLB;
+
+    ASSERT((nvmeIOCmd->PRP1[0] & 0xF) == 0 && (nvmeIOCmd->PRP2[0] & 0xF) == 0);
+    ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
+
+    ReqTransNvmeToSlice(cmdSlotTag, startLba[0] + GetNamespaceStartLba(nvmeIOCmd->NSID), nlb, IO_NVM_COMPARE);
+}
+
+/**
+ * @brief Entry point for NVM Write Zeroes commands.
+ *
+ * No data is transferred for this command, the whole slices in the range are unmapped and
+ * the partial slices are zeroed in the data buffer, check `ReqTransZeroSliceToLowLevel()`.
+ * Since the unmapped slices are always read as zeros, the range is deallocated whether the
+ * DEAC bit is set or not.
+ *
+ * @note The completion is always posted by firmware, check `handle_nvme_io_cmd()`.
+ *
+ * @param cmdSlotTag the entry index of the given NVMe command.
+ * @param nvmeIOCmd a pointer points to the instance of given NVMe command.
+ */
+void handle_nvme_io_write_zeroes(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+    IO_WRITE_ZEROES_COMMAND_DW12 writeZeroesInfo12;
+    unsigned int startLba[2];
+    unsigned int nlb;
+
+    writeZeroesInfo12.dword = nvmeIOCmd->dword[12];
+
+    if ((writeZeroesInfo12.FUA == 1) || (g_nvmeTask.cacheEn == 0))
+        set_nvme_cmd_write_through(cmdSlotTag);
+
+    startLba[0] = nvmeIOCmd->dword[10];
+    startLba[1] = nvmeIOCmd->dword[11];
+    nlb         = writeZeroesInfo12.NLB;
+
+    ReqTransNvmeToSlice(cmdSlotTag, startLba[0] + GetNamespaceStartLba(nvmeIOCmd->NSID), nlb, IO_NVM_WRITE_ZEROES);
+}
+
+/**
+ * @brief Entry point for NVM Copy commands.
+ *
+ * The source range entries are fetched from host first, and all the ranges are checked
+ * before any data is copied, so an invalid command will not modify the destination. Then
+ * each source range is split into slice requests by `ReqTransCopyToSlice()`, the data is
+ * copied inside the device without host DMA.
+ *
+ * @note The completion is always posted by firmware, check `handle_nvme_io_cmd()`.
+ *
+ * @param cmdSlotTag the entry index of the given NVMe command.
+ * @param nvmeIOCmd a pointer points to the instance of given NVMe command.
+ */
+void handle_nvme_io_copy(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+    IO_COPY_COMMAND_DW12 copyInfo12;
+    IO_COPY_SOURCE_RANGE_ENTRY *ranges;
+    NVME_COMPLETION nvmeCPL;
+    unsigned int sdlba[2];
+    unsigned int numOfRange, rangeLen, prpLen, copyLen, idx, dstLba, nsCapacity, nsStartLba, numOfBlock;
+
+    copyInfo12.dword = nvmeIOCmd->dword[12];
+
+    sdlba[0]   = nvmeIOCmd->dword[10];
+    sdlba[1]   = nvmeIOCmd->dword[11];
+    numOfRange = copyInfo12.NR + 1;
+    nsCapacity = GetNamespaceCapacity(nvmeIOCmd->NSID);
+    nsStartLba = GetNamespaceStartLba(nvmeIOCmd->NSID);
+
+    nvmeCPL.dword[0] = 0;
+    nvmeCPL.specific = 0x0;
+
+    if (copyInfo12.DF != COPY_DESCRIPTOR_FORMAT_0)
+    {
+        nvmeCPL.statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+        set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+        return;
+    }
+
+    if (numOfRange > COPY_MAX_SOURCE_RANGES)
+    {
+        nvmeCPL.statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+        nvmeCPL.statusField.SC  = SC_COMMAND_SIZE_LIMIT_EXCEEDED;
+        set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+        return;
+    }
+
+    // fetch the source range entries, which may cross the page boundary of PRP1
+    ASSERT((nvmeIOCmd->PRP1[0] & 0x3) == 0 && (nvmeIOCmd->PRP2[0] & 0x3) == 0);
+
+    rangeLen = numOfRange * sizeof(IO_COPY_SOURCE_RANGE_ENTRY);
+    prpLen   = 0x1000 - (nvmeIOCmd->PRP1[0] & 0xFFF);
+    if (prpLen > rangeLen)
+        prpLen = rangeLen;
+
+    set_direct_rx_dma(IO_CMD_DRAM_DATA_BUFFER, nvmeIOCmd->PRP1[1], nvmeIOCmd->PRP1[0], prpLen);
+    if (prpLen != rangeLen)
+        set_direct_rx_dma(IO_CMD_DRAM_DATA_BUFFER + prpLen, nvmeIOCmd->PRP2[1], nvmeIOCmd->PRP2[0],
+                          rangeLen - prpLen);
+    check_direct_rx_dma_done();
+
+    ranges = (IO_COPY_SOURCE_RANGE_ENTRY *)IO_CMD_DRAM_DATA_BUFFER;
+
+    // check all the ranges before copying
+    copyLen = 0;
+    for (idx = 0; idx < numOfRange; idx++)
+    {
+        numOfBlock = ranges[idx].NLB + 1; // NLB is 0's based
+        if ((numOfBlock > COPY_MAX_RANGE_LENGTH) || (copyLen + numOfBlock > COPY_MAX_LENGTH))
+        {
+            nvmeCPL.statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+            nvmeCPL.statusField.SC  = SC_COMMAND_SIZE_LIMIT_EXCEEDED;
+            set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+            return;
+        }
+
+        if (ranges[idx].SLBA[1] || (ranges[idx].SLBA[0] >= nsCapacity) ||
+            (numOfBlock > nsCapacity - ranges[idx].SLBA[0]))
+        {
+            nvmeCPL.statusField.SC = SC_LBA_OUT_OF_RANGE;
+            set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+            return;
+        }
+
+        copyLen += numOfBlock;
+    }
+
+    if (sdlba[1] || (sdlba[0] >= nsCapacity) || (copyLen > nsCapacity - sdlba[0]))
+    {
+        nvmeCPL.statusField.SC = SC_LBA_OUT_OF_RANGE;
+        set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+        return;
+    }
+
+    if ((copyInfo12.FUA == 1) || (g_nvmeTask.cacheEn == 0))
+        set_nvme_cmd_write_through(cmdSlotTag);
+
+    // the destination blocks are written in the order of the source ranges
+    dstLba = sdlba[0];
+    for (idx = 0; idx < numOfRange; idx++)
+    {
+        ReqTransCopyToSlice(cmdSlotTag, nsStartLba + ranges[idx].SLBA[0], nsStartLba + dstLba, ranges[idx].NLB);
+        dstLba += ranges[idx].NLB + 1;
+    }
+}
+
+/**
+ * @brief Entry point for the vendor specific physical address commands.
+ *
+ * The given physical address bypasses the FTL mapping, the commands are split into page
+ * sized slice requests and forwarded to `ReqTransNvmeToPhy()`.
+ *
+ * The block number is the index in the blocks reserved for these commands on the target
+ * die, the last `OCSSD_PHY_BLOCKS_PER_DIE` blocks of the die, which are never allocated by
+ * the FTL. An address outside of them, a bad block, or an invalid length will be completed
+ * with status code `SC_INVALID_FIELD_IN_COMMAND` without touching the flash.
+ *
+ * @note The completion is posted by firmware after the NAND requests are done, so a failed
+ * erase, program or read will be reported, check `ReleaseNandReqNvmeCpl()`.
+ *
+ * @param cmdSlotTag the entry index of the given NVMe command.
+ * @param nvmeIOCmd a pointer points to the instance of given NVMe command.
+ * @param opc one of the `IO_OCSSD_PHY_*` opcodes.
+ */
+void handle_nvme_io_ocssd_phy(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd, unsigned int opc)
+{
+    IO_OCSSD_PHY_COMMAND_DW10 phyInfo10;
+    IO_OCSSD_PHY_COMMAND_DW11 phyInfo11;
+    IO_READ_COMMAND_DW12 phyInfo12;
+    NVME_COMPLETION nvmeCPL;
+    unsigned int numOfPage;
+
+    phyInfo10.dword = nvmeIOCmd->dword[10];
+    phyInfo11.dword = nvmeIOCmd->dword[11];
+    phyInfo12.dword = nvmeIOCmd->dword[12];
+
+    if (opc == IO_OCSSD_PHY_ERASE)
+        numOfPage = 1;
+    else
+        numOfPage = (phyInfo12.NLB + 1) / NVME_BLOCKS_PER_SLICE;
+
+    nvmeCPL.dword[0] = 0;
+    nvmeCPL.specific = 0x0;
+
+    if ((phyInfo10.CH >= USER_CHANNELS) || (phyInfo10.WAY >= USER_WAYS) ||
+        (phyInfo10.BLK >= OCSSD_PHY_BLOCKS_PER_DIE) || (numOfPage == 0) ||
+        (phyInfo11.PG + numOfPage > USER_PAGES_PER_BLOCK) ||
+        ((opc != IO_OCSSD_PHY_ERASE) && ((phyInfo12.NLB + 1) % NVME_BLOCKS_PER_SLICE)) ||
+        VBLK_BAD(Pcw2VdieTranslation(phyInfo10.CH, phyInfo10.WAY), FTL_BLOCKS_PER_DIE + phyInfo10.BLK))
+    {
+        xil_printf("Invalid Physical Address: ch %d way %d blk %d pg %d nlb %d\r\n", phyInfo10.CH, phyInfo10.WAY,
+                   phyInfo10.BLK, phyInfo11.PG, phyInfo12.NLB);
+        nvmeCPL.statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+        set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+        return;
+    }
+
+    ASSERT((nvmeIOCmd->PRP1[0] & 0xF) == 0 && (nvmeIOCmd->PRP2[0] & 0xF) == 0);
+    ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
+
+    ReqTransNvmeToPhy(cmdSlotTag, phyInfo10.CH, phyInfo10.WAY, FTL_BLOCKS_PER_DIE + phyInfo10.BLK, phyInfo11.PG,
+                      numOfPage, opc);
+}
+
+/**
+ * @brief Get the worst case number of slice requests of the given I/O command.
+ *
+ * The number of slice requests is derived from the LBA range, and a Copy command may be
+ * split at the slice boundaries of both the source and the destination, so it is bounded
+ * by the max copy length and the number of source ranges.
+ *
+ * @note Each slice request may need up to `REQ_COUNT_PER_SLICE_MAX` requests, check
+ * `ReserveFreeReq()`.
+ *
+ * @param nvmeIOCmd a pointer points to the instance of given NVMe command.
+ * @return unsigned int the number of slice requests.
+ */
+unsigned int get_nvme_io_cmd_slice_cnt(NVME_IO_COMMAND *nvmeIOCmd)
+{
+    IO_READ_COMMAND_DW12 info12;
+    IO_COPY_COMMAND_DW12 copyInfo12;
+    unsigned int numOfSlice;
+
+    info12.dword     = nvmeIOCmd->dword[12];
+    copyInfo12.dword = nvmeIOCmd->dword[12];
+
+    switch (nvmeIOCmd->OPC)
+    {
+    case IO_NVM_WRITE:
+    case IO_NVM_READ:
+    case IO_NVM_COMPARE:
+    case IO_NVM_WRITE_ZEROES:
+        numOfSlice = ((nvmeIOCmd->dword[10] % NVME_BLOCKS_PER_SLICE) + info12.NLB + NVME_BLOCKS_PER_SLICE) /
+                     NVME_BLOCKS_PER_SLICE;
+        break;
+    case IO_NVM_COPY:
+        numOfSlice = 2 * (COPY_MAX_LENGTH / NVME_BLOCKS_PER_SLICE + copyInfo12.NR + 1);
+        break;
+    case IO_OCSSD_PHY_WRITE:
+    case IO_OCSSD_PHY_READ:
+        numOfSlice = (info12.NLB + 1) / NVME_BLOCKS_PER_SLICE;
+        break;
+    case IO_OCSSD_PHY_ERASE:
+        numOfSlice = 1;
+        break;
+    default:
+        numOfSlice = 0;
+        break;
+    }
+
+    return numOfSlice;
+}
+
+/**
+ * @brief Check the namespace and the LBA range of the given I/O command.
+ *
+ * The LBAs of the NVM commands are relative to the namespace, so the namespace must be
+ * attached and the whole range must be inside the namespace. The Copy command checks its
+ * source ranges by itself, and the physical address commands bypass the namespaces.
+ *
+ * @param nvmeIOCmd a pointer points to the instance of given NVMe command.
+ * @return unsigned int the status field of the completion, 0 if the command is valid.
+ */
+unsigned int check_nvme_io_cmd_namespace(NVME_IO_COMMAND *nvmeIOCmd)
+{
+    IO_READ_COMMAND_DW12 info12;
+    NVME_COMPLETION nvmeCPL;
+    unsigned int nsCapacity, numOfBlock;
+
+    info12.dword = nvmeIOCmd->dword[12];
+    numOfBlock   = info12.NLB + 1; // NLB is 0's based
+
+    nvmeCPL.dword[0] = 0;
+    nvmeCPL.specific = 0x0;
+
+    switch (nvmeIOCmd->OPC)
+    {
+    case IO_NVM_FLUSH:
+        if ((nvmeIOCmd->NSID != NVME_NSID_ALL) && !IsNamespaceAttached(nvmeIOCmd->NSID))
+            nvmeCPL.statusField.SC = SC_INVALID_NAMESPACE_OR_FORMAT;
+        break;
+    case IO_NVM_COPY:
+        if (!IsNamespaceAttached(nvmeIOCmd->NSID))
+            nvmeCPL.statusField.SC = SC_INVALID_NAMESPACE_OR_FORMAT;
+        break;
+    case IO_NVM_WRITE:
+    case IO_NVM_READ:
+    case IO_NVM_COMPARE:
+    case IO_NVM_WRITE_ZEROES:
+        if (!IsNamespaceAttached(nvmeIOCmd->NSID))
+        {
+            nvmeCPL.statusField.SC = SC_INVALID_NAMESPACE_OR_FORMAT;
+            break;
+        }
+
+        nsCapacity = GetNamespaceCapacity(nvmeIOCmd->NSID);
+        if (nvmeIOCmd->dword[11] || (nvmeIOCmd->dword[10] >= nsCapacity) ||
+            (numOfBlock > nsCapacity - nvmeIOCmd->dword[10]))
+            nvmeCPL.statusField.SC = SC_LBA_OUT_OF_RANGE;
+        break;
+    default:
+        break;
+    }
+
+    return nvmeCPL.statusFieldWord;
 }
 
-void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
+/**
+ * @brief Check the fused operation (Compare and Write) before executing the given command.
+ *
+ * The arbiter selects the two commands of a fused operation back-to-back, and the Compare
+ * is finished before the next command is handled, so no other command can modify the LBAs
+ * between them. The completion of the Compare is held until the Write is handled, so its
+ * status decides whether the Write should be executed:
+ *
+ * - If the Compare failed, the Write is aborted without modifying the LBAs.
+ * - If the two commands don't access the same LBAs, both of them are failed.
+ * - If either of them is missing, the existing one is aborted.
+ *
+ * @param cmdSlotTag the entry index of the given NVMe command.
+ * @param nvmeIOCmd a pointer points to the instance of given NVMe command.
+ * @return unsigned int 1 if the given command should be executed, otherwise 0.
+ */
+unsigned int check_nvme_fused_cmd(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+    IO_READ_COMMAND_DW12 info12;
+    NVME_COMPLETION nvmeCPL;
+    unsigned int firstCmdSlotTag, firstCmdStatus;
+
+    info12.dword = nvmeIOCmd->dword[12];
+
+    nvmeCPL.dword[0] = 0;
+    nvmeCPL.specific = 0x0;
+
+    if (g_nvmeFusedCmd.valid)
+    {
+        g_nvmeFusedCmd.valid = 0;
+        firstCmdSlotTag      = g_nvmeFusedCmd.cmdSlotTag;
+        firstCmdStatus       = get_nvme_cmd_cpl_status(firstCmdSlotTag);
+
+        if (nvmeIOCmd->FUSE != NVME_FUSE_SECOND)
+        {
+            nvmeCPL.statusField.SC = SC_COMMAND_ABORTED_DUE_TO_MISSING_FUSED_COMMAND;
+            set_nvme_cmd_cpl_status(firstCmdSlotTag, nvmeCPL.statusFieldWord);
+            release_nvme_cmd_cpl(firstCmdSlotTag);
+        }
+        else if ((nvmeIOCmd->OPC != IO_NVM_WRITE) || (nvmeIOCmd->NSID != g_nvmeFusedCmd.nsid) ||
+                 (nvmeIOCmd->dword[10] != g_nvmeFusedCmd.startLba) || (info12.NLB != g_nvmeFusedCmd.nlb))
+        {
+            nvmeCPL.statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+            set_nvme_cmd_cpl_status(firstCmdSlotTag, nvmeCPL.statusFieldWord);
+            set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+            release_nvme_cmd_cpl(firstCmdSlotTag);
+            return 0;
+        }
+        else
+        {
+            release_nvme_cmd_cpl(firstCmdSlotTag);
+            if (firstCmdStatus == 0)
+                return 1;
+
+            nvmeCPL.statusField.SC = SC_COMMAND_ABORTED_DUE_TO_FAILED_FUSED_COMMAND;
+            set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+            return 0;
+        }
+    }
+    else if (nvmeIOCmd->FUSE == NVME_FUSE_SECOND)
+    {
+        nvmeCPL.statusField.SC = SC_COMMAND_ABORTED_DUE_TO_MISSING_FUSED_COMMAND;
+        set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+        return 0;
+    }
+
+    if (nvmeIOCmd->FUSE == NVME_FUSE_FIRST)
+    {
+        if (nvmeIOCmd->OPC != IO_NVM_COMPARE)
+        {
+            nvmeCPL.statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+            set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+            return 0;
+        }
+
+        // keep the status of the Compare until the Write is handled
+        hold_nvme_cmd_cpl(cmdSlotTag);
+
+        g_nvmeFusedCmd.valid      = 1;
+        g_nvmeFusedCmd.cmdSlotTag = cmdSlotTag;
+        g_nvmeFusedCmd.nsid       = nvmeIOCmd->NSID;
+        g_nvmeFusedCmd.startLba   = nvmeIOCmd->dword[10];
+        g_nvmeFusedCmd.nlb        = info12.NLB;
+    }
+    else if (nvmeIOCmd->FUSE != NVME_FUSE_NORMAL)
+    {
+        nvmeCPL.statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+        set_nvme_cmd_cpl_status(cmdSlotTag, nvmeCPL.statusFieldWord);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Handle the given I/O command, or defer it if the request pool can't serve it.
+ *
+ * The requests needed by the whole command are reserved before splitting it, otherwise the
+ * free requests may run out in the middle of a large command, and the main loop will be
+ * blocked by `SyncAvailFreeReq()` until the previous commands are done. A deferred command
+ * is returned to the arbiter, and retried after the scheduler recycles some requests.
+ *
+ * @param nvmeCmd the I/O command selected by the arbiter.
+ * @return unsigned int 1 if the command is handled, 0 if it should be deferred.
+ */
+unsigned int handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
 {
     NVME_IO_COMMAND *nvmeIOCmd;
     NVME_COMPLETION nvmeCPL;
     unsigned int opc;
+    unsigned int numOfSlice;
+    unsigned int manualCpl;
+    unsigned int nsStatus;
 
     nvmeIOCmd = (NVME_IO_COMMAND *)nvmeCmd->cmdDword;
     /* xil_printf("OPC = 0x%X\r\n", nvmeIOCmd->OPC);
@@ -136,7 +627,44 @@ void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
        nvmeIOCmd->PRP2[0]); xil_printf("dword10 = 0x%X\r\n", nvmeIOCmd->dword10); xil_printf("dword11 = 0x%X\r\n",
        nvmeIOCmd->dword11); xil_printf("dword12 = 0x%X\r\n", nvmeIOCmd->dword12);*/
 
-    opc = (unsigned int)nvmeIOCmd->OPC;
+    opc        = (unsigned int)nvmeIOCmd->OPC;
+    numOfSlice = get_nvme_io_cmd_slice_cnt(nvmeIOCmd);
+
+    if (!ReserveFreeReq(numOfSlice * REQ_COUNT_PER_SLICE_MAX))
+        return 0;
+
+    // pace the writes with the GC once the command can be served, the fused Write is never held
+    if ((opc == IO_NVM_WRITE) && (nvmeIOCmd->FUSE == NVME_FUSE_NORMAL) && !AdmitHostWrite(numOfSlice))
+        return 0;
+
+    nsStatus = check_nvme_io_cmd_namespace(nvmeIOCmd);
+
+    /*
+     * WRITE_ZEROES and COPY have no host DMA to trigger the auto completion, and the result
+     * of COMPARE is known after its host DMA, so they are always posted by firmware. So are
+     * the physical address commands, whose result is known after the NAND requests, the fused
+     * commands, since either of them may be aborted by the other, and the commands failed
+     * before any DMA.
+     */
+    manualCpl = (opc == IO_NVM_WRITE_ZEROES) || (opc == IO_NVM_COPY) || (opc == IO_NVM_COMPARE);
+    manualCpl = manualCpl || (opc == IO_OCSSD_PHY_ERASE) || (opc == IO_OCSSD_PHY_WRITE);
+    manualCpl = manualCpl || (opc == IO_OCSSD_PHY_READ);
+    manualCpl = manualCpl || (nvmeIOCmd->FUSE != NVME_FUSE_NORMAL) || nsStatus;
+    start_nvme_cmd_cpl(nvmeCmd->cmdSlotTag, manualCpl);
+
+    if ((g_nvmeFusedCmd.valid || (nvmeIOCmd->FUSE != NVME_FUSE_NORMAL)) &&
+        !check_nvme_fused_cmd(nvmeCmd->cmdSlotTag, nvmeIOCmd))
+    {
+        release_nvme_cmd_cpl(nvmeCmd->cmdSlotTag);
+        return 1;
+    }
+
+    if (nsStatus)
+    {
+        set_nvme_cmd_cpl_status(nvmeCmd->cmdSlotTag, nsStatus);
+        release_nvme_cmd_cpl(nvmeCmd->cmdSlotTag);
+        return 1;
+    }
 
     switch (opc)
     {
@@ -160,6 +688,28 @@ void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
         handle_nvme_io_read(nvmeCmd->cmdSlotTag, nvmeIOCmd);
         break;
     }
+    case IO_NVM_COMPARE:
+    {
+        handle_nvme_io_compare(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+        break;
+    }
+    case IO_NVM_WRITE_ZEROES:
+    {
+        handle_nvme_io_write_zeroes(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+        break;
+    }
+    case IO_NVM_COPY:
+    {
+        handle_nvme_io_copy(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+        break;
+    }
+    case IO_OCSSD_PHY_ERASE:
+    case IO_OCSSD_PHY_WRITE:
+    case IO_OCSSD_PHY_READ:
+    {
+        handle_nvme_io_ocssd_phy(nvmeCmd->cmdSlotTag, nvmeIOCmd, opc);
+        break;
+    }
     default:
     {
         xil_printf("Not Support IO Command OPC: %X\r\n", opc);
@@ -167,4 +717,7 @@ void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
         break;
     }
     }
+
+    release_nvme_cmd_cpl(nvmeCmd->cmdSlotTag);
+    return 1;
 }
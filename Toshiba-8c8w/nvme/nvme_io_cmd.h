@@ -47,6 +47,30 @@
 #ifndef __NVME_IO_CMD_H_
 #define __NVME_IO_CMD_H_
 
-void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd);
+/**
+ * @brief The first command (Compare) of a fused operation waiting for the second command.
+ *
+ * @sa `check_nvme_fused_cmd()`.
+ */
+typedef struct _NVME_FUSED_CMD
+{
+    unsigned int valid;
+    unsigned int cmdSlotTag; // the Compare, its completion is held until the Write is handled
+    unsigned int nsid;
+    unsigned int startLba;
+    unsigned int nlb; // zero-based value
+} NVME_FUSED_CMD;
+
+void init_nvme_fused_cmd();
+
+void abort_nvme_fused_cmd(unsigned int sc);
+
+unsigned int check_nvme_fused_cmd(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd);
+
+unsigned int get_nvme_io_cmd_slice_cnt(NVME_IO_COMMAND *nvmeIOCmd);
+
+unsigned int check_nvme_io_cmd_namespace(NVME_IO_COMMAND *nvmeIOCmd);
+
+unsigned int handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd);
 
 #endif //__NVME_IO_CMD_H_
@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_log_page.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Log Page
+// File Name: nvme_log_page.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - builds the log pages from the statistics of FTL
+//   - builds the vendor telemetry log page from the counters of scheduler and FTL
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include "debug.h"
+#include "string.h"
+
+#include "nvme.h"
+#include "nvme_log_page.h"
+
+#include "../memory_map.h"
+
+/**
+ * @brief Build the SMART / Health Information log page in the given buffer.
+ *
+ * - The percentage used is estimated by the average erase count of the user blocks and
+ *   the rated P/E cycles `BLOCK_RATED_PE_CYCLES`, the value is capped at 255.
+ *
+ * - Every bad block consumes a reserved block (check `GetBadBlockCnt()`), so the available
+ *   spare is the ratio of the reserved blocks that are not consumed yet.
+ *
+ * - The power on hours is counted from the FTL initialization, since there is no
+ *   persistent storage for it yet.
+ *
+ * @note No temperature sensor is accessible by firmware, so the temperatures are reported
+ * as 0 (not implemented), and the temperature warning is never raised.
+ *
+ * @param pBuffer the address of the buffer.
+ * @return unsigned int the size of the log page in bytes.
+ */
+unsigned int get_smart_health_log(unsigned int pBuffer)
+{
+    NVME_SMART_HEALTH_LOG *smartLog;
+    unsigned int percentageUsed, spareBlockCnt, badBlockCnt;
+
+    smartLog = (NVME_SMART_HEALTH_LOG *)pBuffer;
+
+    memset(smartLog, 0, sizeof(NVME_SMART_HEALTH_LOG));
+
+    percentageUsed = GetAvgEraseCnt() * 100 / BLOCK_RATED_PE_CYCLES;
+    spareBlockCnt  = (TOTAL_BLOCKS_PER_DIE - USER_BLOCKS_PER_DIE) * USER_DIES;
+    badBlockCnt    = GetBadBlockCnt();
+
+    smartLog->percentageUsed          = (percentageUsed > 255) ? 255 : percentageUsed;
+    smartLog->availableSpare          = (badBlockCnt < spareBlockCnt)
+                                            ? (spareBlockCnt - badBlockCnt) * 100 / spareBlockCnt
+                                            : 0;
+    smartLog->availableSpareThreshold = AVAILABLE_SPARE_THRESHOLD;
+
+    smartLog->criticalWarning.availableSpareBelowThreshold = smartLog->availableSpare < AVAILABLE_SPARE_THRESHOLD;
+    smartLog->criticalWarning.reliabilityDegraded          = percentageUsed >= 100;
+
+    smartLog->dataUnitsRead[0]     = (ssdStatistics.hostReadSectorCnt + 999) / 1000;
+    smartLog->dataUnitsWritten[0]  = (ssdStatistics.hostWriteSectorCnt + 999) / 1000;
+    smartLog->hostReadCommands[0]  = ssdStatistics.hostReadCmdCnt;
+    smartLog->hostWriteCommands[0] = ssdStatistics.hostWriteCmdCnt;
+    smartLog->powerOnHours[0]      = GetPowerOnHours();
+    smartLog->mediaErrors[0]       = ssdStatistics.mediaErrorCnt;
+
+    return sizeof(NVME_SMART_HEALTH_LOG);
+}
+
+/**
+ * @brief Build the vendor specific SMART extension log page in the given buffer.
+ *
+ * @param pBuffer the address of the buffer.
+ * @return unsigned int the size of the log page in bytes.
+ */
+unsigned int get_vendor_smart_ext_log(unsigned int pBuffer)
+{
+    NVME_VENDOR_SMART_EXTENSION_LOG *extLog;
+    unsigned int minEraseCnt, maxEraseCnt;
+
+    extLog = (NVME_VENDOR_SMART_EXTENSION_LOG *)pBuffer;
+
+    memset(extLog, 0, sizeof(NVME_VENDOR_SMART_EXTENSION_LOG));
+
+    extLog->nandPagesWritten   = ssdStatistics.nandWritePageCnt;
+    extLog->gcPagesCopied      = ssdStatistics.gcCopyPageCnt;
+    extLog->hostSectorsWritten = ssdStatistics.hostWriteSectorCnt;
+    extLog->bytesPerNandPage   = BYTES_PER_DATA_REGION_OF_SLICE;
+    extLog->writeAmplification = GetWriteAmplificationFactor();
+
+    GetEraseCntRange(&minEraseCnt, &maxEraseCnt);
+    extLog->minEraseCnt      = minEraseCnt;
+    extLog->maxEraseCnt      = maxEraseCnt;
+    extLog->avgEraseCnt      = GetAvgEraseCnt();
+    extLog->wlMigratedBlocks = ssdStatistics.wlMigratedBlockCnt;
+
+    return sizeof(NVME_VENDOR_SMART_EXTENSION_LOG);
+}
+
+/**
+ * @brief Build the vendor specific telemetry log page in the given buffer.
+ *
+ * The counters are copied as a snapshot, so they can be cleared right after being read
+ * and the next read only reports the activities since this read.
+ *
+ * @param pBuffer the address of the buffer.
+ * @param reset clear the counters after the snapshot if not 0.
+ * @return unsigned int the size of the log page in bytes.
+ */
+unsigned int get_vendor_telemetry_log(unsigned int pBuffer, unsigned int reset)
+{
+    SSD_TELEMETRY *telemetryLog;
+
+    telemetryLog = (SSD_TELEMETRY *)pBuffer;
+
+    memcpy(telemetryLog, &ssdTelemetry, sizeof(SSD_TELEMETRY));
+    telemetryLog->elapsedTime = GetTelemetryElapsedTime();
+
+    if (reset)
+        ResetTelemetry();
+
+    return sizeof(SSD_TELEMETRY);
+}
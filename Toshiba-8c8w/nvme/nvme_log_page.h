@@ -0,0 +1,51 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_log_page.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Log Page
+// File Name: nvme_log_page.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - declares the functions for building the log pages
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NVME_LOG_PAGE_H_
+#define __NVME_LOG_PAGE_H_
+
+#define AVAILABLE_SPARE_THRESHOLD 10 // in percentage
+
+unsigned int get_smart_health_log(unsigned int pBuffer);
+
+unsigned int get_vendor_smart_ext_log(unsigned int pBuffer);
+
+unsigned int get_vendor_telemetry_log(unsigned int pBuffer, unsigned int reset);
+
+#endif //__NVME_LOG_PAGE_H_
@@ -65,6 +65,9 @@
 #include "nvme_main.h"
 #include "nvme_admin_cmd.h"
 #include "nvme_io_cmd.h"
+#include "nvme_arbitration.h"
+#include "nvme_completion.h"
+#include "nvme_hmb.h"
 
 #include "../memory_map.h"
 
@@ -100,6 +103,10 @@ void nvme_main()
             ccEn = check_nvme_cc_en();
             if (ccEn == 1)
             {
+                init_nvme_arbitration();
+                init_nvme_fused_cmd();
+                init_nvme_hmb();
+                g_nvmeTask.cacheEn = 1; // the volatile write cache is enabled by default
                 set_nvme_admin_queue(1, 1, 1);
                 set_nvme_csts_rdy(1);
                 g_nvmeTask.status = NVME_TASK_RUNNING;
@@ -109,9 +116,6 @@ void nvme_main()
         else if (g_nvmeTask.status == NVME_TASK_RUNNING)
         {
             NVME_COMMAND nvmeCmd;
-            unsigned int cmdValid;
-
-            cmdValid = get_nvme_cmd(&nvmeCmd.qID, &nvmeCmd.cmdSlotTag, &nvmeCmd.cmdSeqNum, nvmeCmd.cmdDword);
 
             /**
              *  Interpret NVMe commands received from host.
@@ -125,21 +129,27 @@ void nvme_main()
              * - If it's I/O (NVM) command:
              *
              * 		Forward to the NVM Command Manager (FTL).
+             *
+             * @note The I/O commands are not handled in the order of fetching, instead, all
+             * the fetched commands are moved to the arbiter by `fetch_nvme_cmd()`, and the
+             * arbiter selects one of them based on the priority of their submission queues.
              */
-            if (cmdValid == 1)
+            if (fetch_nvme_cmd())
+                rstCnt = 0;
+
+            if (arbitrate_nvme_io_cmd(&nvmeCmd))
             {
                 rstCnt = 0;
-                if (nvmeCmd.qID == 0)
-                {
-                    handle_nvme_admin_cmd(&nvmeCmd);
-                }
-                else
+                if (handle_nvme_io_cmd(&nvmeCmd))
                 {
-                    handle_nvme_io_cmd(&nvmeCmd);
                     ReqTransSliceToLowLevel();
                     exeLlr = 0;
                 }
+                else
+                    defer_nvme_io_cmd(&nvmeCmd); // wait for the scheduler to recycle the requests
             }
+            else
+                IdleGarbageCollection(); // no host request is waiting, continue the ongoing GC
         }
         else if (g_nvmeTask.status == NVME_TASK_SHUTDOWN)
         {
@@ -158,6 +168,9 @@ void nvme_main()
 
                 set_nvme_admin_queue(0, 0, 0);
                 g_nvmeTask.cacheEn = 0;
+
+                // the host may release the HMB once the shutdown is completed
+                disable_nvme_hmb();
                 set_nvme_csts_shst(2);
                 g_nvmeTask.status = NVME_TASK_WAIT_RESET;
 
@@ -183,6 +196,10 @@ void nvme_main()
         else if (g_nvmeTask.status == NVME_TASK_RESET)
         {
             unsigned int qID;
+
+            // the HMB is disabled by the reset, take the map back before the host releases it
+            disable_nvme_hmb();
+
             for (qID = 0; qID < 8; qID++)
             {
                 set_io_cq(qID, 0, 0, 0, 0, 0, 0);
@@ -178,6 +178,7 @@ unsigned int GetFromFreeReqQ()
     // try to release some request entries by doing scheduling
     if (reqSlotTag == REQ_SLOT_TAG_NONE)
     {
+        ssdTelemetry.freeReqStallCnt++;
         SyncAvailFreeReq();
         reqSlotTag = freeReqQ.headReq;
     }
@@ -194,12 +195,36 @@ unsigned int GetFromFreeReqQ()
         freeReqQ.tailReq = REQ_SLOT_TAG_NONE;
     }
 
-    reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_NONE;
+    reqPoolPtr->reqPool[reqSlotTag].reqQueueType   = REQ_QUEUE_TYPE_NONE;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nvmeCpl = REQ_OPT_NVME_CPL_NONE;
     freeReqQ.reqCnt--;
 
     return reqSlotTag;
 }
 
+/**
+ * @brief Reserve the free requests needed by a NVMe command before splitting it.
+ *
+ * All the requests of a NVMe command are created in the same iteration of the main loop,
+ * by `handle_nvme_io_cmd()` and `ReqTransSliceToLowLevel()`, so no other command can take
+ * the free requests in between, and checking the number of free requests is enough to
+ * reserve them for the command.
+ *
+ * @note Unlike `GetFromFreeReqQ()`, this function never waits for the requests to be done,
+ * the caller should defer the command if the reservation failed.
+ *
+ * @param reqCnt the worst case number of requests needed by the command.
+ * @return unsigned int 1 if the requests are reserved, otherwise 0.
+ */
+unsigned int ReserveFreeReq(unsigned int reqCnt)
+{
+    // the worst case of a huge command may exceed a small pool, wait for the whole pool then
+    if (reqCnt > AVAILABLE_OUNTSTANDING_REQ_COUNT)
+        reqCnt = AVAILABLE_OUNTSTANDING_REQ_COUNT;
+
+    return (freeReqQ.reqCnt >= reqCnt);
+}
+
 /**
  * @brief Add the given request to the slice request queue.
  *
@@ -374,6 +399,9 @@ void PutToBlockedByRowAddrDepReqQ(unsigned int reqSlotTag, unsigned int chNo, un
     reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_BLOCKED_BY_ROW_ADDR_DEP;
     blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt++;
     blockedReqCnt++;
+
+    AddToQueueDepthHist(ssdTelemetry.blockedByRowAddrDepReqQDepthHist,
+                        blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt);
 }
 
 /**
@@ -529,6 +557,8 @@ void PutToNandReqQ(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo)
     reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_NAND;
     nandReqQ[chNo][wayNo].reqCnt++;
     notCompletedNandReqCnt++;
+
+    AddToQueueDepthHist(ssdTelemetry.nandReqQDepthHist, nandReqQ[chNo][wayNo].reqCnt);
 }
 
 /**
@@ -571,3 +601,41 @@ void GetFromNandReqQ(unsigned int chNo, unsigned int wayNo, unsigned int reqStat
     PutToFreeReqQ(reqSlotTag);
     ReleaseBlockedByBufDepReq(reqSlotTag);
 }
+
+/**
+ * @brief Move the specified request in `nandReqQ` to the head of that queue.
+ *
+ * Used by the scheduler to let a READ request bypass the WRITE/ERASE requests queued in
+ * front of it, the number of requests in the queue is not changed.
+ *
+ * @warning The head request of the queue is the request being executed on the die if the
+ * die is not idle, so the caller should make sure the die is idle.
+ *
+ * @sa `PrioritizeNandReadReq()`.
+ *
+ * @param reqSlotTag the request pool entry index of the request to be moved.
+ * @param chNo the target channel
+ * @param wayNo the target way
+ */
+void MoveToHeadOfNandReqQ(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo)
+{
+    unsigned int prevReq, nextReq;
+
+    prevReq = reqPoolPtr->reqPool[reqSlotTag].prevReq;
+    nextReq = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+
+    // already the head request
+    if (prevReq == REQ_SLOT_TAG_NONE)
+        return;
+
+    reqPoolPtr->reqPool[prevReq].nextReq = nextReq;
+    if (nextReq != REQ_SLOT_TAG_NONE)
+        reqPoolPtr->reqPool[nextReq].prevReq = prevReq;
+    else
+        nandReqQ[chNo][wayNo].tailReq = prevReq;
+
+    reqPoolPtr->reqPool[reqSlotTag].prevReq                    = REQ_SLOT_TAG_NONE;
+    reqPoolPtr->reqPool[reqSlotTag].nextReq                    = nandReqQ[chNo][wayNo].headReq;
+    reqPoolPtr->reqPool[nandReqQ[chNo][wayNo].headReq].prevReq = reqSlotTag;
+    nandReqQ[chNo][wayNo].headReq                              = reqSlotTag;
+}
@@ -56,6 +56,16 @@
  */
 #define AVAILABLE_OUNTSTANDING_REQ_COUNT ((USER_DIES)*128) // regardless of request type
 
+/**
+ * @brief The max number of requests needed by a slice request, including itself.
+ *
+ * Besides the NVMe DMA request, a slice request may write back the evicted data buffer
+ * entry and read the slice for read-modify-write, and a write-through command also writes
+ * the entry right away. A Copy slice may do the eviction and read for both the source and
+ * the destination.
+ */
+#define REQ_COUNT_PER_SLICE_MAX 5
+
 #define REQ_SLOT_TAG_NONE 0xffff // no request pool entry, used for checking tail entry
 #define REQ_SLOT_TAG_FAIL 0xffff // request pool entry not found, used for return error
 
@@ -78,6 +88,7 @@ void InitReqPool();
 
 void PutToFreeReqQ(unsigned int reqSlotTag);
 unsigned int GetFromFreeReqQ();
+unsigned int ReserveFreeReq(unsigned int reqCnt);
 
 void PutToSliceReqQ(unsigned int reqSlotTag);
 unsigned int GetFromSliceReqQ();
@@ -93,6 +104,7 @@ void SelectiveGetFromNvmeDmaReqQ(unsigned int regSlotTag);
 
 void PutToNandReqQ(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo);
 void GetFromNandReqQ(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus, unsigned int reqCode);
+void MoveToHeadOfNandReqQ(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo);
 
 extern P_REQ_POOL reqPoolPtr;
 extern FREE_REQUEST_QUEUE freeReqQ;
@@ -51,6 +51,7 @@
 #define REQ_TYPE_SLICE    0x0
 #define REQ_TYPE_NAND     0x1 // flash or flash DMA operation
 #define REQ_TYPE_NVME_DMA 0x2 // host DMA
+#define REQ_TYPE_ZERO     0x3 // zero fill of a data buffer entry by CPU, check `ZeroDataBufEntry()`
 
 /**
  * The queue type of a request pool entry. Each of these macros, except for NONE, has a
@@ -72,12 +73,16 @@
 #define REQ_CODE_WRITE         0x00
 #define REQ_CODE_READ          0x08 // read trigger
 #define REQ_CODE_READ_TRANSFER 0x09 // read transfer
+#define REQ_CODE_READ_CACHE    0x0A // read trigger already queued behind the previous read transfer
 #define REQ_CODE_ERASE         0x0C
 #define REQ_CODE_RESET         0x0D // currently only used in FTL initialization stage
 #define REQ_CODE_SET_FEATURE   0x0E // currently only used in FTL initialization stage
 #define REQ_CODE_FLUSH         0x0F
 #define REQ_CODE_RxDMA         0x10
 #define REQ_CODE_TxDMA         0x20
+#define REQ_CODE_WRITE_ZEROES  0x30 // slice request only, check `ReqTransZeroSliceToLowLevel()`
+#define REQ_CODE_COPY          0x31 // slice request only, check `ReqTransCopySliceToLowLevel()`
+#define REQ_CODE_COMPARE       0x32 // slice request only, check `ReqTransCompareSliceToLowLevel()`
 
 #define REQ_CODE_OCSSD_PHY_TYPE_BASE 0xA0
 #define REQ_CODE_OCSSD_PHY_WRITE     0xA0
@@ -142,6 +147,20 @@
 #define REQ_OPT_BLOCK_SPACE_MAIN  0 // main blocks only
 #define REQ_OPT_BLOCK_SPACE_TOTAL 1 // main blocks and extended blocks
 
+/**
+ * @brief for the 1 bit flag `REQ_OPTION::nvmeCpl`.
+ *
+ * A NAND request with `REQ_OPT_NVME_CPL_HOLD` holds the completion of the NVMe command
+ * `SSD_REQ_FORMAT::nvmeCmdSlotTag`, which will be released once this request is finished.
+ * This is used by the write-through requests (e.g., FUA), check `nvme_completion.h`.
+ *
+ * @note The flag is cleared by `GetFromFreeReqQ()`, so only the requests that hold the
+ * completion need to set it.
+ */
+
+#define REQ_OPT_NVME_CPL_NONE 0 // the NVMe completion doesn't depend on this request
+#define REQ_OPT_NVME_CPL_HOLD 1 // the NVMe completion waits for this request
+
 #define LOGICAL_SLICE_ADDR_NONE 0xffffffff
 
 /**
@@ -191,6 +210,7 @@ typedef struct _NAND_INFO
     union
     {
         unsigned int virtualSliceAddr; // location vector mention in paper
+        unsigned int srcNvmeBlockAddr; // the first source NVMe block of a COPY slice request
         struct
         {
             unsigned int physicalCh : 4;
@@ -229,7 +249,8 @@ typedef struct _REQ_OPTION
     unsigned int nandEccWarning : 1;         // 0 for OFF, 1 for ON
     unsigned int rowAddrDependencyCheck : 1; // whether this request needs to check dependency.
     unsigned int blockSpace : 1;             // 0 for MAIN, 1 for TOTAL
-    unsigned int reserved0 : 24;
+    unsigned int nvmeCpl : 1;                // 0 for NONE, 1 for HOLD
+    unsigned int reserved0 : 23;
 } REQ_OPTION, *P_REQ_OPTION; /* NOTE: 32 bits */
 
 /**
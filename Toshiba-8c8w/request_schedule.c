@@ -115,6 +115,7 @@ void InitReqScheduler()
             dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_NONE;
             dieStateTablePtr->dieState[chNo][wayNo].prevWay           = wayNo - 1;
             dieStateTablePtr->dieState[chNo][wayNo].nextWay           = wayNo + 1;
+            dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt     = 0;
 
             completeFlagTablePtr->completeFlag[chNo][wayNo] = 0;
             statusReportTablePtr->statusReport[chNo][wayNo] = 0;
@@ -180,6 +181,58 @@ void SyncReleaseEraseReq(unsigned int chNo, unsigned int wayNo, unsigned int blo
     }
 }
 
+/**
+ * @brief Do schedule until all the requests on the specified data buffer entry are done.
+ *
+ * The requests in the blocking request queue of the entry (e.g., the eviction of its old
+ * data, or a pending RxDMA) may still access the buffer, so the fw should call this before
+ * modifying the buffer directly.
+ *
+ * @param dataBufEntry the index of the target data buffer entry.
+ */
+void SyncDataBufReqDone(unsigned int dataBufEntry)
+{
+    while (dataBufMapPtr->dataBuf[dataBufEntry].blockingReqTail != REQ_SLOT_TAG_NONE)
+    {
+        CheckDoneNvmeDmaReq();
+        SchedulingNandReq();
+    }
+}
+
+/**
+ * @brief Do schedule until all the requests on the specified temp data buffer entry are done.
+ *
+ * @sa `SyncDataBufReqDone()`.
+ *
+ * @param tempDataBufEntry the index of the target temp data buffer entry.
+ */
+void SyncTempDataBufReqDone(unsigned int tempDataBufEntry)
+{
+    while (tempDataBufMapPtr->tempDataBuf[tempDataBufEntry].blockingReqTail != REQ_SLOT_TAG_NONE)
+    {
+        CheckDoneNvmeDmaReq();
+        SchedulingNandReq();
+    }
+}
+
+/**
+ * @brief Do schedule until the specified NAND request is done.
+ *
+ * The request entry is recycled once the request is done, so this function may also wait
+ * for a later request that reused the entry, which is harmless as long as that request has
+ * been issued when this function is called.
+ *
+ * @param reqSlotTag the request pool entry index of the target request.
+ */
+void SyncNandReqDone(unsigned int reqSlotTag)
+{
+    while (reqPoolPtr->reqPool[reqSlotTag].reqQueueType != REQ_QUEUE_TYPE_FREE)
+    {
+        CheckDoneNvmeDmaReq();
+        SchedulingNandReq();
+    }
+}
+
 /**
  * @brief Iteratively do schedule on each channel by calling `SchedulingNandReqPerCh`.
  */
@@ -210,7 +263,7 @@ void SchedulingNandReq()
  */
 void SchedulingNandReqPerCh(unsigned int chNo)
 {
-    unsigned int readyBusy, wayNo, reqStatus, nextWay, waitWayCnt;
+    unsigned int readyBusy, wayNo, reqStatus, nextWay, waitWayCnt, freeQueueCnt;
 
     waitWayCnt = 0;
 
@@ -248,6 +301,7 @@ void SchedulingNandReqPerCh(unsigned int chNo)
             {
                 nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
                 SelectivGetFromNandIdleList(chNo, wayNo);
+                PrioritizeNandReadReq(chNo, wayNo);
                 PutToNandWayPriorityTable(nandReqQ[chNo][wayNo].headReq, chNo, wayNo);
                 wayNo = nextWay;
             }
@@ -276,7 +330,12 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
         while (wayNo != WAY_NONE)
         {
-            if (V2FWayReady(readyBusy, wayNo))
+            /*
+             * The completion of READ_TRANSFER is reported by the completion flag, and the
+             * die may be busy with the pipelined READ_TRIGGER of the next request.
+             */
+            if (V2FWayReady(readyBusy, wayNo) || (dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt ==
+                                                  REQ_STATUS_CHECK_OPT_COMPLETION_FLAG))
             {
                 reqStatus = CheckReqStatus(chNo, wayNo);
                 if (reqStatus != REQ_STATUS_RUNNING)
@@ -287,11 +346,22 @@ void SchedulingNandReqPerCh(unsigned int chNo)
                      * in `DIE_STATE_IDLE` state.
                      *
                      * Also, we had check the request state is not `REQ_STATUS_RUNNING`,
-                     * thus the `ExecuteNandReq()` must bring the die to `DIE_STATE_IDLE`.
+                     * thus the `ExecuteNandReq()` must bring the die to `DIE_STATE_IDLE`,
+                     * unless the READ_TRIGGER of next request was pipelined behind the
+                     * finished READ_TRANSFER, in which case the die goes back to the
+                     * `statusCheck` list to wait for that READ_TRIGGER.
                      */
                     ExecuteNandReq(chNo, wayNo, reqStatus);
                     nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
 
+                    if (dieStateTablePtr->dieState[chNo][wayNo].dieState == DIE_STATE_EXE)
+                    {
+                        SelectivGetFromNandStatusReportList(chNo, wayNo);
+                        PutToNandStatusCheckList(chNo, wayNo);
+                        wayNo = nextWay;
+                        continue;
+                    }
+
                     /**
                      * Since the die become idle, now we can try to schedule request on
                      * this die like what we just did in the previous part, if there is
@@ -305,7 +375,10 @@ void SchedulingNandReqPerCh(unsigned int chNo)
                         ReleaseBlockedByRowAddrDepReq(chNo, wayNo);
 
                     if (nandReqQ[chNo][wayNo].headReq != REQ_SLOT_TAG_NONE)
+                    {
+                        PrioritizeNandReadReq(chNo, wayNo);
                         PutToNandWayPriorityTable(nandReqQ[chNo][wayNo].headReq, chNo, wayNo);
+                    }
                     else
                     {
                         PutToNandIdleList(chNo, wayNo);
@@ -363,8 +436,15 @@ void SchedulingNandReqPerCh(unsigned int chNo)
      * If there is at least one request should be scheduled and their ways and the channel
      * is not busy, we can issue the requests by calling `ExecuteNandReq()`.
      *
-     * @note Since some request may make the channel controller busy, we should skip the
-     * remaining requests right away as the channel become busy.
+     * @note The channel controller has a command queue (up to 32 commands), so we can
+     * push the commands of several ways into the queue back-to-back in one pass. Before
+     * issuing, we get the number of free queue entries by `V2FGetFreeQueueCount()`, and
+     * each issued command consumes one entry, we should skip the remaining requests right
+     * away as the queue become full. The controller may consume some commands during this
+     * part, so the count is only a lower bound of the real free entries.
+     *
+     * @note Since the issued die will be moved to another state list, the next way of the
+     * current list must be saved before the die is moved.
      *
      * After the command is issued, we should move the die to the state list `statusCheck`
      * or `statusReport` based on the request type:
@@ -400,7 +480,14 @@ void SchedulingNandReqPerCh(unsigned int chNo)
      *      @warning here should second stage status check
      */
     if (waitWayCnt != USER_WAYS)
-        if (!V2FIsControllerBusy(&chCtlReg[chNo]))
+    {
+        freeQueueCnt = V2FGetFreeQueueCount(&chCtlReg[chNo]);
+
+        ssdTelemetry.channel[chNo].issueAttemptCnt++;
+        if (freeQueueCnt == 0)
+            ssdTelemetry.channel[chNo].queueFullCnt++;
+
+        if (freeQueueCnt)
         {
             if (wayPriorityTablePtr->wayPriority[chNo].statusCheckHead != WAY_NONE)
             {
@@ -409,6 +496,8 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
                 while (wayNo != WAY_NONE)
                 {
+                    nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
                     if (V2FWayReady(readyBusy, wayNo)) // TODO why this need?
                     {
                         // FIXME: called again in second stage status check?? redundant?
@@ -417,11 +506,11 @@ void SchedulingNandReqPerCh(unsigned int chNo)
                         SelectiveGetFromNandStatusCheckList(chNo, wayNo);
                         PutToNandStatusReportList(chNo, wayNo);
 
-                        if (V2FIsControllerBusy(&chCtlReg[chNo]))
+                        if (--freeQueueCnt == 0)
                             return;
                     }
 
-                    wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+                    wayNo = nextWay;
                 }
             }
             if (wayPriorityTablePtr->wayPriority[chNo].readTriggerHead != WAY_NONE)
@@ -430,15 +519,17 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
                 while (wayNo != WAY_NONE)
                 {
+                    nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
                     ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
 
                     SelectiveGetFromNandReadTriggerList(chNo, wayNo);
                     PutToNandStatusCheckList(chNo, wayNo);
 
-                    if (V2FIsControllerBusy(&chCtlReg[chNo]))
+                    if (--freeQueueCnt == 0)
                         return;
 
-                    wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+                    wayNo = nextWay;
                 }
             }
 
@@ -448,15 +539,17 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
                 while (wayNo != WAY_NONE)
                 {
+                    nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
                     ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
 
                     SelectiveGetFromNandEraseList(chNo, wayNo);
                     PutToNandStatusCheckList(chNo, wayNo);
 
-                    if (V2FIsControllerBusy(&chCtlReg[chNo]))
+                    if (--freeQueueCnt == 0)
                         return;
 
-                    wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+                    wayNo = nextWay;
                 }
             }
             if (wayPriorityTablePtr->wayPriority[chNo].writeHead != WAY_NONE)
@@ -465,15 +558,17 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
                 while (wayNo != WAY_NONE)
                 {
+                    nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
                     ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
 
                     SelectiveGetFromNandWriteList(chNo, wayNo);
                     PutToNandStatusCheckList(chNo, wayNo);
 
-                    if (V2FIsControllerBusy(&chCtlReg[chNo]))
+                    if (--freeQueueCnt == 0)
                         return;
 
-                    wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+                    wayNo = nextWay;
                 }
             }
             if (wayPriorityTablePtr->wayPriority[chNo].readTransferHead != WAY_NONE)
@@ -482,18 +577,108 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
                 while (wayNo != WAY_NONE)
                 {
+                    nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
                     ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
 
                     SelectiveGetFromNandReadTransferList(chNo, wayNo);
                     PutToNandStatusReportList(chNo, wayNo);
 
-                    if (V2FIsControllerBusy(&chCtlReg[chNo]))
+                    if (--freeQueueCnt == 0)
                         return;
 
-                    wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+                    wayNo = nextWay;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Let a READ request bypass the WRITE/ERASE requests queued in front of it.
+ *
+ * The `nandReqQ` of each die is FIFO, so a READ request queued behind several WRITE and
+ * ERASE requests must wait for the tPROG/tBERS of all of them. To reduce the read latency,
+ * this function will scan the first `READ_PRIORITY_SCAN_DEPTH` requests of the specified
+ * die and move the first READ request that can be safely reordered to the head.
+ *
+ * The requests in `nandReqQ` already passed the dependency checks, but the row address
+ * dependency table is updated when the requests were dispatched, not when they are done.
+ * So, similar to `CheckRowAddrDep()`, a READ request cannot bypass a WRITE or ERASE request
+ * on the same block, since the page to be read may not be programmed yet, or the block is
+ * going to be erased. The READ requests are never moved behind other requests, so ERASE
+ * requests will still wait for the READ requests in front of them.
+ *
+ * @note Only the requests that use VSA are reordered, the requests that use physical
+ * address (e.g. BBT and the host physical address commands) are treated as barriers.
+ *
+ * To prevent the WRITE/ERASE requests from starving, at most `READ_PRIORITY_BYPASS_LIMIT`
+ * READ requests can bypass the head request in a row.
+ *
+ * @warning This function should only be called when the die is idle, since the head
+ * request is the request being executed on that die.
+ *
+ * @sa `CheckRowAddrDep()`, `MoveToHeadOfNandReqQ()`.
+ *
+ * @param chNo the channel number of the specified die.
+ * @param wayNo the way number of the specified die.
+ */
+void PrioritizeNandReadReq(unsigned int chNo, unsigned int wayNo)
+{
+    unsigned int headReq, readReq, prevReq, readBlockNo, scanCnt, conflict;
+
+    headReq = nandReqQ[chNo][wayNo].headReq;
+
+    // the head request is READ (or READ_TRANSFER that must not be interrupted)
+    if ((reqPoolPtr->reqPool[headReq].reqCode != REQ_CODE_WRITE) &&
+        (reqPoolPtr->reqPool[headReq].reqCode != REQ_CODE_ERASE))
+        return;
+    else if (reqPoolPtr->reqPool[headReq].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA)
+        return;
+
+    // the head request should be issued now, reset the counter for next request
+    if (dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt >= READ_PRIORITY_BYPASS_LIMIT)
+    {
+        dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt = 0;
+        return;
+    }
+
+    readReq = reqPoolPtr->reqPool[headReq].nextReq;
+    for (scanCnt = 1; (scanCnt < READ_PRIORITY_SCAN_DEPTH) && (readReq != REQ_SLOT_TAG_NONE); scanCnt++)
+    {
+        if (reqPoolPtr->reqPool[readReq].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA)
+            break;
+
+        if (reqPoolPtr->reqPool[readReq].reqCode == REQ_CODE_READ)
+        {
+            // check the WRITE/ERASE requests in front of this READ request
+            readBlockNo = Vsa2VblockTranslation(reqPoolPtr->reqPool[readReq].nandInfo.virtualSliceAddr);
+            conflict    = 0;
+            prevReq     = reqPoolPtr->reqPool[readReq].prevReq;
+            while (prevReq != REQ_SLOT_TAG_NONE)
+            {
+                if ((reqPoolPtr->reqPool[prevReq].reqCode != REQ_CODE_READ) &&
+                    (Vsa2VblockTranslation(reqPoolPtr->reqPool[prevReq].nandInfo.virtualSliceAddr) == readBlockNo))
+                {
+                    conflict = 1;
+                    break;
                 }
+                prevReq = reqPoolPtr->reqPool[prevReq].prevReq;
+            }
+
+            if (!conflict)
+            {
+                MoveToHeadOfNandReqQ(readReq, chNo, wayNo);
+                dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt++;
+                return;
             }
         }
+
+        readReq = reqPoolPtr->reqPool[readReq].nextReq;
+    }
+
+    // no READ request can be prioritized, the head request will be issued
+    dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt = 0;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1005,6 +1190,13 @@ void SelectiveGetFromNandStatusCheckList(unsigned int chNo, unsigned int wayNo)
  * during the scheduling process. Check `SchedulingNandReqPerCh()` and `CheckReqStatus()`
  * for details.
  *
+ * @note To pipeline the READ requests on the same die, once a READ_TRANSFER is issued, the
+ * READ_TRIGGER of the next request in `nandReqQ` will also be issued if it is a READ. The
+ * command queue of the channel controller executes the commands in order, so the trigger
+ * only starts after the data of current page was moved out of the die register, and the
+ * next request will be marked as `REQ_CODE_READ_CACHE` to prevent it from being triggered
+ * again. Check `ResumeCachedNandReadReq()` for how the next request is resumed.
+ *
  * @warning replace the condition statements with switch statement
  *
  * @param chNo the channel number of the targe die to issue the NAND request.
@@ -1012,7 +1204,7 @@ void SelectiveGetFromNandStatusCheckList(unsigned int chNo, unsigned int wayNo)
  */
 void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 {
-    unsigned int reqSlotTag, rowAddr;
+    unsigned int reqSlotTag, nextReqSlotTag, rowAddr;
     void *dataBufAddr;
     void *spareDataBufAddr;
     unsigned int *errorInfo;
@@ -1032,6 +1224,7 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
     else if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
     {
         dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_COMPLETION_FLAG;
+        ssdTelemetry.die[Pcw2VdieTranslation(chNo, wayNo)].readCnt++;
 
         errorInfo  = (unsigned int *)(&eccErrorInfoTablePtr->errorInfo[chNo][wayNo]);
         completion = (unsigned int *)(&completeFlagTablePtr->completeFlag[chNo][wayNo]);
@@ -1041,18 +1234,41 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
                                      rowAddr);
         else
             V2FReadPageTransferRawAsync(&chCtlReg[chNo], wayNo, dataBufAddr, completion);
+
+        /*
+         * Pipeline the next READ on this die: its trigger is queued right behind the data
+         * out of this page, so tR of the next page overlaps with the completion handling
+         * of this page instead of waiting for another scheduling pass. Skip it if the
+         * command queue is full, the next request will then be triggered as usual.
+         */
+        nextReqSlotTag = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+        if ((nextReqSlotTag != REQ_SLOT_TAG_NONE) &&
+            (reqPoolPtr->reqPool[nextReqSlotTag].reqCode == REQ_CODE_READ) &&
+            !V2FIsControllerBusy(&chCtlReg[chNo]))
+        {
+            reqPoolPtr->reqPool[nextReqSlotTag].reqCode = REQ_CODE_READ_CACHE;
+
+            V2FReadPageTriggerAsync(&chCtlReg[chNo], wayNo, GenerateNandRowAddr(nextReqSlotTag));
+        }
     }
     else if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE)
     {
         dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
 
+        // the slices managed by the FTL record their owners for the GC, check `VALID_SLICE_MAP`
+        if (reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_VSA)
+            ((P_SPARE_DATA_ENTRY)spareDataBufAddr)->logicalSliceAddr =
+                reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr;
+
         V2FProgramPageAsync(&chCtlReg[chNo], wayNo, rowAddr, dataBufAddr, spareDataBufAddr);
+        ssdTelemetry.die[Pcw2VdieTranslation(chNo, wayNo)].writeCnt++;
     }
     else if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_ERASE)
     {
         dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
 
         V2FEraseBlockAsync(&chCtlReg[chNo], wayNo, rowAddr);
+        ssdTelemetry.die[Pcw2VdieTranslation(chNo, wayNo)].eraseCnt++;
     }
     else if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_RESET)
     {
@@ -1192,6 +1408,10 @@ unsigned int GenerateDataBufAddr(unsigned int reqSlotTag)
             return (DATA_BUFFER_BASE_ADDR +
                     reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry * BYTES_PER_DATA_REGION_OF_SLICE +
                     reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset * BYTES_PER_NVME_BLOCK);
+        else if (reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat == REQ_OPT_DATA_BUF_TEMP_ENTRY)
+            return (TEMPORARY_DATA_BUFFER_BASE_ADDR +
+                    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry * BYTES_PER_DATA_REGION_OF_SLICE +
+                    reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset * BYTES_PER_NVME_BLOCK);
         else
             assert(!"[WARNING] wrong reqOpt-dataBufFormat [WARNING]");
     }
@@ -1234,6 +1454,9 @@ unsigned int GenerateSpareDataBufAddr(unsigned int reqSlotTag)
         if (reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat == REQ_OPT_DATA_BUF_ENTRY)
             return (SPARE_DATA_BUFFER_BASE_ADDR +
                     reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry * BYTES_PER_SPARE_REGION_OF_SLICE);
+        else if (reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat == REQ_OPT_DATA_BUF_TEMP_ENTRY)
+            return (TEMPORARY_SPARE_DATA_BUFFER_BASE_ADDR +
+                    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry * BYTES_PER_SPARE_REGION_OF_SLICE);
         else
             assert(!"[WARNING] wrong reqOpt-dataBufFormat [WARNING]");
     }
@@ -1364,16 +1587,22 @@ unsigned int CheckEccErrorInfo(unsigned int chNo, unsigned int wayNo)
  *      register, thus we should make sure the READ_TRANSFER to be the next request that
  *      will be executed on this die to prevent the die register from being overwritten.
  *
+ *      @note if the READ_TRIGGER of the next request was pipelined behind the finished
+ *      READ_TRANSFER, the die is kept in EXE state to wait for that READ_TRIGGER, check
+ *      `ResumeCachedNandReadReq()`.
+ *
  * - previous request is FAIL
  *
  *      If the request failed, there are different things to do based on the request type.
  *      For READ_TRIGGER and READ_TRANSFER, retry the request (from READ_TRIGGER state)
  *      until reaching the retry limitation. For other requests, just mark as bad block.
+ *      The pipelined READ_TRIGGER of the next request, if any, will be issued again.
  *
  *
  * - previous request is WARNING
  *
- *      This means ECC failed, report bad block then make die IDLE and reset retry count
+ *      This means ECC failed, report bad block then make die IDLE and reset retry count,
+ *      the pipelined READ_TRIGGER of the next request is also resumed as DONE does.
  *
  * @todo bad block and ECC related handling
  *
@@ -1385,7 +1614,7 @@ unsigned int CheckEccErrorInfo(unsigned int chNo, unsigned int wayNo)
  */
 void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus)
 {
-    unsigned int reqSlotTag, rowAddr, phyBlockNo;
+    unsigned int reqSlotTag, nextReqSlotTag, rowAddr, phyBlockNo;
     unsigned char *badCheck;
 
     reqSlotTag = nandReqQ[chNo][wayNo].headReq;
@@ -1395,6 +1624,7 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
     case DIE_STATE_IDLE:
         IssueNandReq(chNo, wayNo);
         dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_EXE;
+        MarkDieBusy(Pcw2VdieTranslation(chNo, wayNo));
         break;
     case DIE_STATE_EXE:
         if (reqStatus == REQ_STATUS_DONE)
@@ -1403,14 +1633,32 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
                 reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ_TRANSFER;
             else
             {
+                if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE)
+                    ssdStatistics.nandWritePageCnt++;
+
                 retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
+                ReleaseNandReqNvmeCpl(reqSlotTag, reqStatus);
                 GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
+
+                // the next READ was already triggered, keep the die busy with it
+                if (ResumeCachedNandReadReq(chNo, wayNo))
+                    break;
             }
 
             dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
+            MarkDieIdle(Pcw2VdieTranslation(chNo, wayNo));
         }
         else if (reqStatus == REQ_STATUS_FAIL)
         {
+            /*
+             * The die register may be reloaded by the retry of this request, trigger the
+             * pipelined READ again to be safe.
+             */
+            nextReqSlotTag = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+            if ((nextReqSlotTag != REQ_SLOT_TAG_NONE) &&
+                (reqPoolPtr->reqPool[nextReqSlotTag].reqCode == REQ_CODE_READ_CACHE))
+                reqPoolPtr->reqPool[nextReqSlotTag].reqCode = REQ_CODE_READ;
+
             if ((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) ||
                 (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER))
                 if (retryLimitTablePtr->retryLimit[chNo][wayNo] > 0)
@@ -1421,6 +1669,7 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
                         reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
 
                     dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
+                    MarkDieIdle(Pcw2VdieTranslation(chNo, wayNo));
                     return;
                 }
 
@@ -1450,10 +1699,13 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
             phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) +
                          ((rowAddr / LUN_1_BASE_ADDR) * TOTAL_BLOCKS_PER_LUN);
             UpdatePhyBlockMapForGrownBadBlock(Pcw2VdieTranslation(chNo, wayNo), phyBlockNo);
+            ssdStatistics.mediaErrorCnt++;
 
             retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
+            ReleaseNandReqNvmeCpl(reqSlotTag, reqStatus);
             GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
             dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
+            MarkDieIdle(Pcw2VdieTranslation(chNo, wayNo));
         }
         else if (reqStatus == REQ_STATUS_WARNING)
         {
@@ -1468,8 +1720,14 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
             UpdatePhyBlockMapForGrownBadBlock(Pcw2VdieTranslation(chNo, wayNo), phyBlockNo);
 
             retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
+            ReleaseNandReqNvmeCpl(reqSlotTag, reqStatus);
             GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
+
+            if (ResumeCachedNandReadReq(chNo, wayNo))
+                break;
+
             dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
+            MarkDieIdle(Pcw2VdieTranslation(chNo, wayNo));
         }
         else if (reqStatus == REQ_STATUS_RUNNING)
             break;
@@ -1478,3 +1736,29 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
         break;
     }
 }
+
+/**
+ * @brief Resume the pipelined READ request on the specified die.
+ *
+ * If the new head request of `nandReqQ` is `REQ_CODE_READ_CACHE`, its READ_TRIGGER was
+ * issued behind the READ_TRANSFER of the previous request, check `IssueNandReq()`. So the
+ * die should not become idle, instead, we restore the request to a READ_TRIGGER in flight
+ * and let the scheduler check its status as usual.
+ *
+ * @param chNo the channel number of the specified die.
+ * @param wayNo the way number of the specified die.
+ * @return unsigned int 1 if the die is still executing the pipelined READ, otherwise 0.
+ */
+unsigned int ResumeCachedNandReadReq(unsigned int chNo, unsigned int wayNo)
+{
+    unsigned int reqSlotTag;
+
+    reqSlotTag = nandReqQ[chNo][wayNo].headReq;
+    if ((reqSlotTag == REQ_SLOT_TAG_NONE) || (reqPoolPtr->reqPool[reqSlotTag].reqCode != REQ_CODE_READ_CACHE))
+        return 0;
+
+    reqPoolPtr->reqPool[reqSlotTag].reqCode                   = REQ_CODE_READ;
+    dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
+
+    return 1;
+}
@@ -65,6 +65,23 @@
  */
 #define RETRY_LIMIT 5
 
+/**
+ * @brief The max number of READ requests that can bypass the WRITE/ERASE requests on the
+ * same die in a row.
+ *
+ * Once reaching this limit, the head WRITE/ERASE request will be issued before any other
+ * READ request can be prioritized again, to prevent the WRITE/ERASE requests from being
+ * starved by a stream of READ requests.
+ *
+ * @note Must be less than 16, check `DIE_STATE_ENTRY::readBypassCnt`.
+ */
+#define READ_PRIORITY_BYPASS_LIMIT 8
+
+/**
+ * @brief The max number of requests to be scanned for a READ request in `nandReqQ`.
+ */
+#define READ_PRIORITY_SCAN_DEPTH 16
+
 #define DIE_STATE_IDLE 0
 #define DIE_STATE_EXE  1
 
@@ -109,12 +126,13 @@ typedef struct _RETRY_LIMIT_TABLE
 /**
  * like a node of doubly-linked list.
  *
- * Each entry consist of 4 members:
+ * Each entry consist of 5 members:
  *
  * - dieState
  * - reqStatusCheckOpt
  * - prevWay
  * - nextWay
+ * - readBypassCnt
  *
  * In the beginning, the dieState of each way was initialized to IDLE and all the ways of
  * this channel were connected in serial order.
@@ -125,7 +143,8 @@ typedef struct _DIE_STATE_ENTRY
     unsigned int reqStatusCheckOpt : 4; // one of the four: NONE, CHECK, REPORT, COMPLETE
     unsigned int prevWay : 4;           // the die state entry index of prev way in the same list
     unsigned int nextWay : 4;           // the die state entry index of next way in the same list
-    unsigned int reserved : 12;
+    unsigned int readBypassCnt : 4;     // number of READ requests prioritized over the head request in a row
+    unsigned int reserved : 8;
 } DIE_STATE_ENTRY, *P_DIE_STATE_ENTRY;
 
 /**
@@ -188,9 +207,14 @@ void InitReqScheduler();
 void SyncAllLowLevelReqDone();
 void SyncAvailFreeReq();
 void SyncReleaseEraseReq(unsigned int chNo, unsigned int wayNo, unsigned int blockNo);
+void SyncDataBufReqDone(unsigned int dataBufEntry);
+void SyncTempDataBufReqDone(unsigned int tempDataBufEntry);
+void SyncNandReqDone(unsigned int reqSlotTag);
 void SchedulingNandReq();
 void SchedulingNandReqPerCh(unsigned int chNo);
 
+void PrioritizeNandReadReq(unsigned int chNo, unsigned int wayNo);
+
 void PutToNandWayPriorityTable(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo);
 void PutToNandIdleList(unsigned int chNo, unsigned int wayNo);
 void SelectivGetFromNandIdleList(unsigned int chNo, unsigned int wayNo);
@@ -215,6 +239,7 @@ unsigned int CheckReqStatus(unsigned int chNo, unsigned int wayNo);
 unsigned int CheckEccErrorInfo(unsigned int chNo, unsigned int wayNo);
 
 void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus);
+unsigned int ResumeCachedNandReadReq(unsigned int chNo, unsigned int wayNo);
 
 extern P_COMPLETE_FLAG_TABLE completeFlagTablePtr;
 extern P_STATUS_REPORT_TABLE statusReportTablePtr;
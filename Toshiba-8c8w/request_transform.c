@@ -48,8 +48,10 @@
 
 #include "xil_printf.h"
 #include <assert.h>
+#include <string.h>
 #include "nvme/nvme.h"
 #include "nvme/host_lld.h"
+#include "nvme/nvme_completion.h"
 #include "memory_map.h"
 #include "ftl_config.h"
 
@@ -136,6 +138,10 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
         reqCode = REQ_CODE_WRITE;
     else if (cmdCode == IO_NVM_READ)
         reqCode = REQ_CODE_READ;
+    else if (cmdCode == IO_NVM_WRITE_ZEROES)
+        reqCode = REQ_CODE_WRITE_ZEROES;
+    else if (cmdCode == IO_NVM_COMPARE)
+        reqCode = REQ_CODE_COMPARE;
     else
         assert(!"[WARNING] Not supported command code [WARNING]");
 
@@ -157,6 +163,7 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
     reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock  = tempNumOfNvmeBlock;
 
     PutToSliceReqQ(reqSlotTag);
+    hold_nvme_cmd_cpl(cmdSlotTag);
 
     tempLsa++;
     transCounter++;
@@ -179,6 +186,7 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
         reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock  = tempNumOfNvmeBlock;
 
         PutToSliceReqQ(reqSlotTag);
+        hold_nvme_cmd_cpl(cmdSlotTag);
 
         tempLsa++;
         transCounter++;
@@ -202,6 +210,161 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
     reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock  = tempNumOfNvmeBlock;
 
     PutToSliceReqQ(reqSlotTag);
+    hold_nvme_cmd_cpl(cmdSlotTag);
+}
+
+/**
+ * @brief Split the physical address NVMe command into page sized slice requests.
+ *
+ * Unlike `ReqTransNvmeToSlice()`, the target of these slice requests is specified by the
+ * host in physical organization (channel, way, block, page), so the slice requests will
+ * use the `REQ_CODE_OCSSD_PHY_*` request codes and keep the physical address in their
+ * `nandInfo`, and `logicalSliceAddr` is not used.
+ *
+ * The given block number is the index of the user block on the target die, which will be
+ * converted to the main block space here, and the bad blocks will be remapped while the
+ * NAND row address is generated.
+ *
+ * Each slice request holds the completion of the command until its host DMA (or the ERASE)
+ * is done, like `ReqTransNvmeToSlice()` does.
+ *
+ * @note The block must be one of the blocks reserved for the physical address commands,
+ * which are never allocated by the FTL, check `handle_nvme_io_ocssd_phy()`.
+ *
+ * @sa `ReqTransPhySliceToLowLevel()`.
+ *
+ * @param cmdSlotTag the entry index of the given NVMe command.
+ * @param chNo the channel number of the target die.
+ * @param wayNo the way number of the target die.
+ * @param blockNo the user block number on the target die.
+ * @param pageNo the first page to be accessed in the target block.
+ * @param numOfPage the number of pages to be accessed, should be 1 for ERASE.
+ * @param cmdCode opcode of the given NVMe command, one of `IO_OCSSD_PHY_*`.
+ */
+void ReqTransNvmeToPhy(unsigned int cmdSlotTag, unsigned int chNo, unsigned int wayNo, unsigned int blockNo,
+                       unsigned int pageNo, unsigned int numOfPage, unsigned int cmdCode)
+{
+    unsigned int reqSlotTag, reqCode, loop;
+
+    // translate the opcode for NVMe command into that for slice requests.
+    if (cmdCode == IO_OCSSD_PHY_WRITE)
+        reqCode = REQ_CODE_OCSSD_PHY_WRITE;
+    else if (cmdCode == IO_OCSSD_PHY_READ)
+        reqCode = REQ_CODE_OCSSD_PHY_READ;
+    else if (cmdCode == IO_OCSSD_PHY_ERASE)
+        reqCode = REQ_CODE_OCSSD_PHY_ERASE;
+    else
+        assert(!"[WARNING] Not supported command code [WARNING]");
+
+    for (loop = 0; loop < numOfPage; loop++)
+    {
+        reqSlotTag = GetFromFreeReqQ();
+
+        reqPoolPtr->reqPool[reqSlotTag].reqType                     = REQ_TYPE_SLICE;
+        reqPoolPtr->reqPool[reqSlotTag].reqCode                     = reqCode;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag              = cmdSlotTag;
+        reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr            = LSA_NONE;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex      = loop * NVME_BLOCKS_PER_SLICE;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = 0;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock  = NVME_BLOCKS_PER_SLICE;
+        reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalCh         = chNo;
+        reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalWay        = wayNo;
+        reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock      = Vblock2PblockOfMbsTranslation(blockNo);
+        reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage       = pageNo + loop;
+
+        PutToSliceReqQ(reqSlotTag);
+        hold_nvme_cmd_cpl(cmdSlotTag);
+    }
+}
+
+/**
+ * @brief Split the given source range of a Copy command into slice requests.
+ *
+ * Similar to `ReqTransNvmeToSlice()`, but the NVMe blocks of each slice request should be
+ * in the same slice for both the source and the destination, so the range is split at the
+ * slice boundaries of both of them. The destination is kept in `logicalSliceAddr` and
+ * `nvmeDmaInfo`, and the first source NVMe block is kept in `nandInfo.srcNvmeBlockAddr`.
+ *
+ * @note No data is transferred from/to host, check `ReqTransCopySliceToLowLevel()`.
+ *
+ * @param cmdSlotTag the entry index of the given NVMe command.
+ * @param srcLba the first source NVMe block of this range.
+ * @param dstLba the first destination NVMe block of this range.
+ * @param nlb number of NVMe blocks to be copied, 0's based.
+ */
+void ReqTransCopyToSlice(unsigned int cmdSlotTag, unsigned int srcLba, unsigned int dstLba, unsigned int nlb)
+{
+    unsigned int reqSlotTag, requestedNvmeBlock, tempNumOfNvmeBlock;
+
+    requestedNvmeBlock = nlb + 1;
+
+    while (requestedNvmeBlock)
+    {
+        // stop at the nearest slice boundary of the source and destination
+        tempNumOfNvmeBlock = NVME_BLOCKS_PER_SLICE - (dstLba % NVME_BLOCKS_PER_SLICE);
+        if (tempNumOfNvmeBlock > NVME_BLOCKS_PER_SLICE - (srcLba % NVME_BLOCKS_PER_SLICE))
+            tempNumOfNvmeBlock = NVME_BLOCKS_PER_SLICE - (srcLba % NVME_BLOCKS_PER_SLICE);
+        if (tempNumOfNvmeBlock > requestedNvmeBlock)
+            tempNumOfNvmeBlock = requestedNvmeBlock;
+
+        reqSlotTag = GetFromFreeReqQ();
+
+        reqPoolPtr->reqPool[reqSlotTag].reqType                     = REQ_TYPE_SLICE;
+        reqPoolPtr->reqPool[reqSlotTag].reqCode                     = REQ_CODE_COPY;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag              = cmdSlotTag;
+        reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr            = dstLba / NVME_BLOCKS_PER_SLICE;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex      = 0;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = dstLba % NVME_BLOCKS_PER_SLICE;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock  = tempNumOfNvmeBlock;
+        reqPoolPtr->reqPool[reqSlotTag].nandInfo.srcNvmeBlockAddr   = srcLba;
+
+        PutToSliceReqQ(reqSlotTag);
+        hold_nvme_cmd_cpl(cmdSlotTag);
+
+        srcLba += tempNumOfNvmeBlock;
+        dstLba += tempNumOfNvmeBlock;
+        requestedNvmeBlock -= tempNumOfNvmeBlock;
+    }
+}
+
+/**
+ * @brief Generate and dispatch a flash write request for the given data buffer entry, and
+ * mark the entry as clean.
+ *
+ * The write request is appended to the blocking request queue of the data buffer entry,
+ * so it will not be executed before the previous requests (e.g., the RxDMA) on the entry.
+ *
+ * @sa `EvictDataBufEntry()`, `ReqTransSliceToLowLevel()`, `FlushDataBuf()`.
+ *
+ * @param dataBufEntry the data buffer entry to be written.
+ * @param nvmeCmdSlotTag the NVMe command that triggers this write request.
+ * @param nvmeCplOpt `REQ_OPT_NVME_CPL_HOLD` if the write request holds the NVMe completion.
+ */
+void DataWriteToNand(unsigned int dataBufEntry, unsigned int nvmeCmdSlotTag, unsigned int nvmeCplOpt)
+{
+    unsigned int reqSlotTag, virtualSliceAddr;
+
+    reqSlotTag       = GetFromFreeReqQ();
+    virtualSliceAddr = AddrTransWrite(dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr);
+
+    reqPoolPtr->reqPool[reqSlotTag].reqType          = REQ_TYPE_NAND;
+    reqPoolPtr->reqPool[reqSlotTag].reqCode          = REQ_CODE_WRITE;
+    reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag   = nvmeCmdSlotTag;
+    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_ENTRY;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr               = REQ_OPT_NAND_ADDR_VSA;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc                = REQ_OPT_NAND_ECC_ON;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning         = REQ_OPT_NAND_ECC_WARNING_ON;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nvmeCpl                = nvmeCplOpt;
+    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry             = dataBufEntry;
+    UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
+    reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+
+    SelectLowLevelReqQ(reqSlotTag);
+
+    dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_CLEAN;
 }
 
 /**
@@ -213,57 +376,117 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
  * whether the evicted entry is dirty and perform write request if needed before the entry
  * being evicted.
  *
- * @param originReqSlotTag the request entry index of the data buffer entry to be evicted.
+ * @param dataBufEntry the data buffer entry to be evicted.
+ * @param nvmeCmdSlotTag the NVMe command that triggers this eviction.
  */
-void EvictDataBufEntry(unsigned int originReqSlotTag)
+void EvictDataBufEntry(unsigned int dataBufEntry, unsigned int nvmeCmdSlotTag)
 {
-    unsigned int reqSlotTag, virtualSliceAddr, dataBufEntry;
-
-    dataBufEntry = reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry;
     if (dataBufMapPtr->dataBuf[dataBufEntry].dirty == DATA_BUF_DIRTY)
     {
-        reqSlotTag       = GetFromFreeReqQ();
-        virtualSliceAddr = AddrTransWrite(dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr);
+        DataWriteToNand(dataBufEntry, nvmeCmdSlotTag, REQ_OPT_NVME_CPL_NONE);
+        ssdTelemetry.dataBufEvictDirtyCnt++;
+    }
+}
 
-        reqPoolPtr->reqPool[reqSlotTag].reqType          = REQ_TYPE_NAND;
-        reqPoolPtr->reqPool[reqSlotTag].reqCode          = REQ_CODE_WRITE;
-        reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag   = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
-        reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr;
-        reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_ENTRY;
-        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr               = REQ_OPT_NAND_ADDR_VSA;
-        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc                = REQ_OPT_NAND_ECC_ON;
-        reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning         = REQ_OPT_NAND_ECC_WARNING_ON;
-        reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-        reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
-        reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry             = dataBufEntry;
-        UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
-        reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+/**
+ * @brief Write all the dirty data buffer entries back to flash and wait for them.
+ *
+ * The pending slice requests are translated first, so the data of the write commands that
+ * were fetched before calling this function will also be written back.
+ *
+ * @note The data buffer entries are still valid after flushing, so they can be used as the
+ * read cache.
+ */
+void FlushDataBuf()
+{
+    unsigned int dataBufEntry;
 
-        SelectLowLevelReqQ(reqSlotTag);
+    ReqTransSliceToLowLevel();
 
-        dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_CLEAN;
-    }
+    for (dataBufEntry = 0; dataBufEntry < AVAILABLE_DATA_BUFFER_ENTRY_COUNT; dataBufEntry++)
+        if (dataBufMapPtr->dataBuf[dataBufEntry].dirty == DATA_BUF_DIRTY)
+            DataWriteToNand(dataBufEntry, 0, REQ_OPT_NVME_CPL_NONE);
+
+    SyncAllLowLevelReqDone();
 }
 
 /**
- * @brief Generate and dispatch a flash read request for the given slice request.
+ * @brief Generate a request to fill the specified NVMe blocks of the data buffer entry
+ * with zeros.
+ *
+ * The requests already on the entry (e.g., the eviction of its old data) may still access
+ * the buffer, so the fill is appended to the blocking request queue of the entry like the
+ * other requests, and done by `ExecuteZeroReq()` once they are done, instead of waiting
+ * for them here. The requests created after this one are ordered behind the fill.
+ *
+ * @param dataBufEntry the data buffer entry to be filled.
+ * @param nvmeBlockOffset the first NVMe block in the slice to be filled.
+ * @param numOfNvmeBlock the number of NVMe blocks to be filled.
+ */
+void ZeroDataBufEntry(unsigned int dataBufEntry, unsigned int nvmeBlockOffset, unsigned int numOfNvmeBlock)
+{
+    unsigned int reqSlotTag;
+
+    reqSlotTag = GetFromFreeReqQ();
+
+    reqPoolPtr->reqPool[reqSlotTag].reqType                       = REQ_TYPE_ZERO;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_ENTRY;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
+    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry             = dataBufEntry;
+    reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset   = nvmeBlockOffset;
+    reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock    = numOfNvmeBlock;
+    UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
+
+    SelectLowLevelReqQ(reqSlotTag);
+}
+
+/**
+ * @brief Fill the data buffer entry of the zero fill request, and release the requests
+ * blocked by it.
+ *
+ * The fill is done by CPU right away, so the request is recycled here without entering
+ * any request queue.
+ *
+ * @param reqSlotTag the request pool entry index of the zero fill request.
+ */
+static void ExecuteZeroReq(unsigned int reqSlotTag)
+{
+    memset((void *)(BUF_DATA_ENTRY2ADDR(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry) +
+                    reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset * BYTES_PER_NVME_BLOCK),
+           0, reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock * BYTES_PER_NVME_BLOCK);
+
+    PutToFreeReqQ(reqSlotTag);
+    ReleaseBlockedByBufDepReq(reqSlotTag);
+}
+
+/**
+ * @brief Generate and dispatch a flash read request to read the given logical slice into
+ * the given data buffer entry.
  *
  * Before issuing NVMe Tx request and migration, we must read the target page into target
  * data buffer entry. To do this, we should create and issue a sub-request for flash read
  * operation.
  *
+ * If the logical slice was never written or was unmapped by Write Zeroes, there is nothing
+ * to read and the data buffer entry is filled with zeros instead.
+ *
+ * @note The logical slice is usually the one cached by the entry, except the source slice
+ * of a Copy command, check `ReqTransCopySliceToLowLevel()`.
+ *
  * @warning In the original implementation, `nandInfo.virtualSliceAddr` was assigned after
  * calling the function `UpdateDataBufEntryInfoBlockingReq()`.
  *
  * @sa `ReqTransSliceToLowLevel()`
  *
- * @param originReqSlotTag the request pool entry index of the parent NVMe slice request.
+ * @param dataBufEntry the data buffer entry to store the data.
+ * @param logicalSliceAddr the logical slice to be read.
+ * @param nvmeCmdSlotTag the NVMe command that triggers this read request.
  */
-void DataReadFromNand(unsigned int originReqSlotTag)
+void DataReadFromNand(unsigned int dataBufEntry, unsigned int logicalSliceAddr, unsigned int nvmeCmdSlotTag)
 {
     unsigned int reqSlotTag, virtualSliceAddr;
 
-    virtualSliceAddr = AddrTransRead(reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr);
+    virtualSliceAddr = AddrTransRead(logicalSliceAddr);
 
     /*
      * Since `ReqTransNvmeToSlice()` only set a part of options for `ReqTransNvmeToSlice`,
@@ -279,8 +502,8 @@ void DataReadFromNand(unsigned int originReqSlotTag)
 
         reqPoolPtr->reqPool[reqSlotTag].reqType          = REQ_TYPE_NAND;
         reqPoolPtr->reqPool[reqSlotTag].reqCode          = REQ_CODE_READ;
-        reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag   = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
-        reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr;
+        reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag   = nvmeCmdSlotTag;
+        reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
         reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_ENTRY;
         reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr               = REQ_OPT_NAND_ADDR_VSA;
         reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc                = REQ_OPT_NAND_ECC_ON;
@@ -288,13 +511,355 @@ void DataReadFromNand(unsigned int originReqSlotTag)
         reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
         reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
 
-        reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry =
-            reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry;
-        UpdateDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
+        reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
+        UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
         reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
 
         SelectLowLevelReqQ(reqSlotTag);
     }
+    else
+        ZeroDataBufEntry(dataBufEntry, 0, NVME_BLOCKS_PER_SLICE);
+}
+
+/**
+ * @brief Generate the NAND and NVMe DMA requests for the given physical address slice request.
+ *
+ * The physical address slice requests have no logical slice address, so the data buffer
+ * managed by LRU can't be used. Instead, the temp data buffer entry of the target die is
+ * used, and all the requests are appended to the blocking request queue of that entry:
+ *
+ * - For a PHY_WRITE request, receive the data from host and then program it to NAND.
+ * - For a PHY_READ request, read the page from NAND and then transfer it to host.
+ * - For a PHY_ERASE request, the slice request is converted to an ERASE request directly.
+ *
+ * Since the temp data buffer entry is shared by all the physical address requests (and the
+ * GC) on the same die, these requests will be executed in the order they were created.
+ *
+ * The ERASE request and the NAND requests of PHY_WRITE and PHY_READ hold the completion of
+ * the command, so a failed erase, program or an uncorrectable read will be reported to the
+ * host, check `ReleaseNandReqNvmeCpl()`.
+ *
+ * @note The physical address requests don't need to check the row address dependency, the
+ * blocks reserved for them are never accessed by the FTL, and the page program order in a
+ * block should be maintained by the host.
+ *
+ * @sa `ReqTransNvmeToPhy()`, `ReqTransSliceToLowLevel()`.
+ *
+ * @param originReqSlotTag the request pool entry index of the physical address slice request.
+ */
+void ReqTransPhySliceToLowLevel(unsigned int originReqSlotTag)
+{
+    unsigned int reqSlotTag, dieNo, tempDataBufEntry;
+
+    dieNo            = Pcw2VdieTranslation(reqPoolPtr->reqPool[originReqSlotTag].nandInfo.physicalCh,
+                                           reqPoolPtr->reqPool[originReqSlotTag].nandInfo.physicalWay);
+    tempDataBufEntry = AllocateTempDataBuf(dieNo);
+
+    if (reqPoolPtr->reqPool[originReqSlotTag].reqCode == REQ_CODE_OCSSD_PHY_ERASE)
+    {
+        reqPoolPtr->reqPool[originReqSlotTag].reqType                       = REQ_TYPE_NAND;
+        reqPoolPtr->reqPool[originReqSlotTag].reqCode                       = REQ_CODE_ERASE;
+        reqPoolPtr->reqPool[originReqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+        reqPoolPtr->reqPool[originReqSlotTag].reqOpt.nandAddr               = REQ_OPT_NAND_ADDR_PHY_ORG;
+        reqPoolPtr->reqPool[originReqSlotTag].reqOpt.nandEcc                = REQ_OPT_NAND_ECC_OFF;
+        reqPoolPtr->reqPool[originReqSlotTag].reqOpt.nandEccWarning         = REQ_OPT_NAND_ECC_WARNING_OFF;
+        reqPoolPtr->reqPool[originReqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
+        reqPoolPtr->reqPool[originReqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
+        reqPoolPtr->reqPool[originReqSlotTag].reqOpt.nvmeCpl                = REQ_OPT_NVME_CPL_HOLD;
+        reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry             = tempDataBufEntry;
+        UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, originReqSlotTag);
+
+        SelectLowLevelReqQ(originReqSlotTag);
+        return;
+    }
+
+    // the NAND request shares the physical address with the slice request
+    reqSlotTag = GetFromFreeReqQ();
+
+    reqPoolPtr->reqPool[reqSlotTag].reqType                       = REQ_TYPE_NAND;
+    reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag   = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
+    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = LSA_NONE;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat          = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr               = REQ_OPT_NAND_ADDR_PHY_ORG;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc                = REQ_OPT_NAND_ECC_ON;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning         = REQ_OPT_NAND_ECC_WARNING_OFF;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace             = REQ_OPT_BLOCK_SPACE_MAIN;
+    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nvmeCpl                = REQ_OPT_NVME_CPL_HOLD;
+    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry             = tempDataBufEntry;
+    reqPoolPtr->reqPool[reqSlotTag].nandInfo                      = reqPoolPtr->reqPool[originReqSlotTag].nandInfo;
+    hold_nvme_cmd_cpl(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
+
+    // generate NVMe request by replacing the slice request entry directly
+    reqPoolPtr->reqPool[originReqSlotTag].reqType              = REQ_TYPE_NVME_DMA;
+    reqPoolPtr->reqPool[originReqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+    reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry    = tempDataBufEntry;
+
+    if (reqPoolPtr->reqPool[originReqSlotTag].reqCode == REQ_CODE_OCSSD_PHY_WRITE)
+    {
+        // host -> temp buffer -> NAND
+        reqPoolPtr->reqPool[originReqSlotTag].reqCode = REQ_CODE_RxDMA;
+        UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, originReqSlotTag);
+        SelectLowLevelReqQ(originReqSlotTag);
+
+        reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
+        UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, reqSlotTag);
+        SelectLowLevelReqQ(reqSlotTag);
+    }
+    else if (reqPoolPtr->reqPool[originReqSlotTag].reqCode == REQ_CODE_OCSSD_PHY_READ)
+    {
+        // NAND -> temp buffer -> host
+        reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+        UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, reqSlotTag);
+        SelectLowLevelReqQ(reqSlotTag);
+
+        reqPoolPtr->reqPool[originReqSlotTag].reqCode = REQ_CODE_TxDMA;
+        UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, originReqSlotTag);
+        SelectLowLevelReqQ(originReqSlotTag);
+    }
+    else
+        assert(!"[WARNING] Not supported reqCode. [WARNING]");
+}
+
+/**
+ * @brief Handle the slice request of a Write Zeroes command without any host DMA.
+ *
+ * - For a whole slice, the logical slice is simply unmapped, so it costs no NAND program.
+ *   If the slice is cached in the data buffer, the cached copy is replaced with zeros and
+ *   marked clean, so it will not be written back.
+ *
+ * - For a partial slice, the data buffer entry is prepared like a normal write request
+ *   (read-modify-write), then the target NVMe blocks are filled with zeros and the entry
+ *   is marked dirty. For a write-through command, the entry is programmed right away.
+ *
+ * The slice request is recycled here since no NVMe DMA request is generated.
+ *
+ * @sa `ReqTransSliceToLowLevel()`, `AddrTransUnmap()`.
+ *
+ * @param originReqSlotTag the request pool entry index of the Write Zeroes slice request.
+ */
+void ReqTransZeroSliceToLowLevel(unsigned int originReqSlotTag)
+{
+    unsigned int dataBufEntry, nvmeCmdSlotTag;
+
+    nvmeCmdSlotTag = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
+    dataBufEntry   = CheckDataBufHit(originReqSlotTag);
+
+    if (reqPoolPtr->reqPool[originReqSlotTag].nvmeDmaInfo.numOfNvmeBlock == NVME_BLOCKS_PER_SLICE)
+    {
+        if (dataBufEntry != DATA_BUF_FAIL)
+        {
+            ZeroDataBufEntry(dataBufEntry, 0, NVME_BLOCKS_PER_SLICE);
+            dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_CLEAN;
+        }
+
+        AddrTransUnmap(reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr);
+    }
+    else
+    {
+        if (dataBufEntry == DATA_BUF_FAIL)
+        {
+            dataBufEntry                                            = AllocateDataBuf();
+            reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry = dataBufEntry;
+
+            EvictDataBufEntry(dataBufEntry, nvmeCmdSlotTag);
+            dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr =
+                reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr;
+            PutToDataBufHashList(dataBufEntry);
+
+            DataReadFromNand(dataBufEntry, dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr, nvmeCmdSlotTag);
+        }
+
+        ZeroDataBufEntry(dataBufEntry, reqPoolPtr->reqPool[originReqSlotTag].nvmeDmaInfo.nvmeBlockOffset,
+                         reqPoolPtr->reqPool[originReqSlotTag].nvmeDmaInfo.numOfNvmeBlock);
+        dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_DIRTY;
+
+        if (is_nvme_cmd_write_through(nvmeCmdSlotTag))
+        {
+            hold_nvme_cmd_cpl(nvmeCmdSlotTag);
+            DataWriteToNand(dataBufEntry, nvmeCmdSlotTag, REQ_OPT_NVME_CPL_HOLD);
+        }
+    }
+
+    PutToFreeReqQ(originReqSlotTag);
+    release_nvme_cmd_cpl(nvmeCmdSlotTag);
+}
+
+/**
+ * @brief Handle the slice request of a Copy command without any host DMA.
+ *
+ * The destination slice is prepared in the data buffer like a normal write request, then
+ * the source data is copied into it and the entry is marked dirty, so it will be programmed
+ * when it is evicted (or right away for a write-through command):
+ *
+ * - If a whole slice is copied and the source slice is not cached, the source slice is
+ *   read from NAND into the destination entry directly, no CPU copy is needed and the
+ *   read is queued like other requests on the entry.
+ *
+ * - Otherwise, the source slice is cached in the data buffer (read from NAND if needed),
+ *   and the NVMe blocks are copied by CPU once the requests on both entries are done.
+ *
+ * If the source and destination are in the same slice (an overlapping range), the source
+ * is the destination entry itself, since a slice must never be cached by two entries.
+ *
+ * The slice request is recycled here since no NVMe DMA request is generated.
+ *
+ * @note The CPU copy holds the main loop until the NAND reads of both entries are done, so
+ * a Copy of ranges not aligned to slices is bound by the core, check `tools/copy_sim.c`.
+ *
+ * @sa `ReqTransCopyToSlice()`.
+ *
+ * @param originReqSlotTag the request pool entry index of the Copy slice request.
+ */
+void ReqTransCopySliceToLowLevel(unsigned int originReqSlotTag)
+{
+    unsigned int srcDataBufEntry, dstDataBufEntry, nvmeCmdSlotTag, srcLsa, srcOffset, dstLsa, dstOffset,
+        numOfNvmeBlock;
+
+    nvmeCmdSlotTag = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
+    srcLsa         = reqPoolPtr->reqPool[originReqSlotTag].nandInfo.srcNvmeBlockAddr / NVME_BLOCKS_PER_SLICE;
+    srcOffset      = reqPoolPtr->reqPool[originReqSlotTag].nandInfo.srcNvmeBlockAddr % NVME_BLOCKS_PER_SLICE;
+    dstLsa         = reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr;
+    dstOffset      = reqPoolPtr->reqPool[originReqSlotTag].nvmeDmaInfo.nvmeBlockOffset;
+    numOfNvmeBlock = reqPoolPtr->reqPool[originReqSlotTag].nvmeDmaInfo.numOfNvmeBlock;
+
+    if ((srcLsa == dstLsa) && (srcOffset == dstOffset))
+    {
+        PutToFreeReqQ(originReqSlotTag);
+        release_nvme_cmd_cpl(nvmeCmdSlotTag);
+        return;
+    }
+
+    /*
+     * Check the source first, so it becomes the MRU entry and will not be evicted by the
+     * allocation of the destination entry.
+     */
+    srcDataBufEntry = CheckDataBufHitByLsa(srcLsa);
+    dstDataBufEntry = CheckDataBufHit(originReqSlotTag);
+    if (dstDataBufEntry == DATA_BUF_FAIL)
+    {
+        dstDataBufEntry = AllocateDataBuf();
+
+        EvictDataBufEntry(dstDataBufEntry, nvmeCmdSlotTag);
+        dataBufMapPtr->dataBuf[dstDataBufEntry].logicalSliceAddr = dstLsa;
+        PutToDataBufHashList(dstDataBufEntry);
+
+        // for read modify write
+        if (numOfNvmeBlock != NVME_BLOCKS_PER_SLICE)
+            DataReadFromNand(dstDataBufEntry, dstLsa, nvmeCmdSlotTag);
+    }
+
+    if (srcLsa == dstLsa)
+        srcDataBufEntry = dstDataBufEntry;
+
+    if ((srcDataBufEntry == DATA_BUF_FAIL) && (numOfNvmeBlock == NVME_BLOCKS_PER_SLICE))
+        DataReadFromNand(dstDataBufEntry, srcLsa, nvmeCmdSlotTag);
+    else
+    {
+        if (srcDataBufEntry == DATA_BUF_FAIL)
+        {
+            srcDataBufEntry = AllocateDataBuf();
+
+            EvictDataBufEntry(srcDataBufEntry, nvmeCmdSlotTag);
+            dataBufMapPtr->dataBuf[srcDataBufEntry].logicalSliceAddr = srcLsa;
+            PutToDataBufHashList(srcDataBufEntry);
+
+            DataReadFromNand(srcDataBufEntry, srcLsa, nvmeCmdSlotTag);
+        }
+
+        SyncDataBufReqDone(srcDataBufEntry);
+        SyncDataBufReqDone(dstDataBufEntry);
+
+        // the source and destination may be in the same slice
+        memmove((void *)(BUF_DATA_ENTRY2ADDR(dstDataBufEntry) + dstOffset * BYTES_PER_NVME_BLOCK),
+                (void *)(BUF_DATA_ENTRY2ADDR(srcDataBufEntry) + srcOffset * BYTES_PER_NVME_BLOCK),
+                numOfNvmeBlock * BYTES_PER_NVME_BLOCK);
+    }
+
+    dataBufMapPtr->dataBuf[dstDataBufEntry].dirty = DATA_BUF_DIRTY;
+
+    if (is_nvme_cmd_write_through(nvmeCmdSlotTag))
+    {
+        hold_nvme_cmd_cpl(nvmeCmdSlotTag);
+        DataWriteToNand(dstDataBufEntry, nvmeCmdSlotTag, REQ_OPT_NVME_CPL_HOLD);
+    }
+
+    PutToFreeReqQ(originReqSlotTag);
+    release_nvme_cmd_cpl(nvmeCmdSlotTag);
+}
+
+/**
+ * @brief Handle the slice request of a Compare command.
+ *
+ * The data of the host is received into the temp data buffer entry of a die, since the
+ * data buffer entry of this slice holds the stored data to be compared with. The stored
+ * data is looked up in the data buffer first, so a cached slice never touches the NAND,
+ * and only a miss reads the slice from NAND into a newly allocated entry.
+ *
+ * Once the requests on both entries are done, the NVMe blocks are compared by CPU and a
+ * mismatch is reported as Compare Failure. The completion is held across the comparison,
+ * since the RxDMA request releases its own hold as soon as the host data is received.
+ *
+ * @note The comparison is done before this function returns, so the result is known
+ * before the next NVMe command is handled, check `handle_nvme_io_cmd()` for the fused
+ * Compare and Write.
+ *
+ * @param originReqSlotTag the request pool entry index of the Compare slice request.
+ */
+void ReqTransCompareSliceToLowLevel(unsigned int originReqSlotTag)
+{
+    NVME_COMPLETION nvmeCPL;
+    unsigned int dataBufEntry, tempDataBufEntry, nvmeCmdSlotTag, logicalSliceAddr, nvmeBlockOffset,
+        numOfNvmeBlock;
+
+    nvmeCmdSlotTag   = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
+    logicalSliceAddr = reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr;
+    nvmeBlockOffset  = reqPoolPtr->reqPool[originReqSlotTag].nvmeDmaInfo.nvmeBlockOffset;
+    numOfNvmeBlock   = reqPoolPtr->reqPool[originReqSlotTag].nvmeDmaInfo.numOfNvmeBlock;
+
+    hold_nvme_cmd_cpl(nvmeCmdSlotTag);
+
+    // the stored data
+    dataBufEntry = CheckDataBufHitByLsa(logicalSliceAddr);
+    if (dataBufEntry != DATA_BUF_FAIL)
+        ssdTelemetry.dataBufHitCnt++;
+    else
+    {
+        dataBufEntry = AllocateDataBuf();
+        ssdTelemetry.dataBufMissCnt++;
+
+        EvictDataBufEntry(dataBufEntry, nvmeCmdSlotTag);
+        dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr = logicalSliceAddr;
+        PutToDataBufHashList(dataBufEntry);
+
+        DataReadFromNand(dataBufEntry, logicalSliceAddr, nvmeCmdSlotTag);
+    }
+
+    // the data of host, generate NVMe request by replacing the slice request entry directly
+    tempDataBufEntry = AllocateTempDataBuf(logicalSliceAddr % USER_DIES);
+
+    reqPoolPtr->reqPool[originReqSlotTag].reqType              = REQ_TYPE_NVME_DMA;
+    reqPoolPtr->reqPool[originReqSlotTag].reqCode              = REQ_CODE_RxDMA;
+    reqPoolPtr->reqPool[originReqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+    reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry    = tempDataBufEntry;
+
+    UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, originReqSlotTag);
+    SelectLowLevelReqQ(originReqSlotTag);
+
+    SyncDataBufReqDone(dataBufEntry);
+    SyncTempDataBufReqDone(tempDataBufEntry);
+
+    if (memcmp((void *)(BUF_DATA_ENTRY2ADDR(dataBufEntry) + nvmeBlockOffset * BYTES_PER_NVME_BLOCK),
+               (void *)(BUF_TEMP_ENTRY2ADDR(tempDataBufEntry) + nvmeBlockOffset * BYTES_PER_NVME_BLOCK),
+               numOfNvmeBlock * BYTES_PER_NVME_BLOCK))
+    {
+        nvmeCPL.statusFieldWord = 0;
+        nvmeCPL.statusField.SCT = SCT_MEDIA_AND_DATA_INTEGRITY_ERRORS;
+        nvmeCPL.statusField.SC  = SC_COMPARE_FAILURE;
+        set_nvme_cmd_cpl_status(nvmeCmdSlotTag, nvmeCPL.statusFieldWord);
+    }
+
+    release_nvme_cmd_cpl(nvmeCmdSlotTag);
 }
 
 /**
@@ -316,6 +881,12 @@ void DataReadFromNand(unsigned int originReqSlotTag)
  *
  * 4. Dispatch the transfer/receive request by calling `SelectLowLevelReqQ()`.
  *
+ * 5. For the write request of a write-through command (FUA, or the volatile write cache is
+ *    disabled), program the data buffer entry right after the receive request instead of
+ *    waiting for it to be evicted. Since each slice is programmed as soon as it is queued,
+ *    the slices of a command are programmed on different dies in parallel, and overlapped
+ *    with the host DMA of the remaining slices.
+ *
  *
  * @note This function is currently only called after `handle_nvme_io_cmd()` during the
  * process of handling NVMe I/O commands in `nvme_main.c`.
@@ -332,6 +903,30 @@ void ReqTransSliceToLowLevel()
         if (reqSlotTag == REQ_SLOT_TAG_FAIL)
             return;
 
+        // the physical address requests don't use the LRU data buffer
+        if (reqPoolPtr->reqPool[reqSlotTag].reqCode >= REQ_CODE_OCSSD_PHY_TYPE_BASE)
+        {
+            ReqTransPhySliceToLowLevel(reqSlotTag);
+            continue;
+        }
+
+        // the Write Zeroes and Copy requests have no data to be transferred
+        if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE_ZEROES)
+        {
+            ReqTransZeroSliceToLowLevel(reqSlotTag);
+            continue;
+        }
+        else if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_COPY)
+        {
+            ReqTransCopySliceToLowLevel(reqSlotTag);
+            continue;
+        }
+        else if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_COMPARE)
+        {
+            ReqTransCompareSliceToLowLevel(reqSlotTag);
+            continue;
+        }
+
         /*
          * In current implementation, the data buffer to be used is determined on the
          * `logicalSliceAddr` of this request, so the data buffer may already be allocated
@@ -345,15 +940,17 @@ void ReqTransSliceToLowLevel()
         {
             // data buffer hit
             reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
+            ssdTelemetry.dataBufHitCnt++;
         }
         else
         {
             // data buffer miss, allocate a new buffer entry
             dataBufEntry                                      = AllocateDataBuf();
             reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
+            ssdTelemetry.dataBufMissCnt++;
 
             // initialize the newly allocated data buffer entry for this request
-            EvictDataBufEntry(reqSlotTag);
+            EvictDataBufEntry(dataBufEntry, reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
             dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr =
                 reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr;
             PutToDataBufHashList(dataBufEntry);
@@ -364,12 +961,14 @@ void ReqTransSliceToLowLevel()
              * call the function `DataReadFromNand()` to read the desired data to buffer.
              */
             if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
-                DataReadFromNand(reqSlotTag);
+                DataReadFromNand(dataBufEntry, reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr,
+                                 reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
             else if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE)
                 // in case of not overwriting a whole page, read current page content for migration
                 if (reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock != NVME_BLOCKS_PER_SLICE)
                     // for read modify write
-                    DataReadFromNand(reqSlotTag);
+                    DataReadFromNand(dataBufEntry, reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr,
+                                     reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
         }
 
         // generate NVMe request by replacing the slice request entry directly
@@ -388,6 +987,17 @@ void ReqTransSliceToLowLevel()
 
         UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
         SelectLowLevelReqQ(reqSlotTag);
+
+        /*
+         * The completion must be held before allocating the write request, since the free
+         * request may be recycled by syncing the NVMe DMA requests, including this one.
+         */
+        if ((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_RxDMA) &&
+            is_nvme_cmd_write_through(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag))
+        {
+            hold_nvme_cmd_cpl(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
+            DataWriteToNand(dataBufEntry, reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, REQ_OPT_NVME_CPL_HOLD);
+        }
     }
 }
 
@@ -644,6 +1254,8 @@ void SelectLowLevelReqQ(unsigned int reqSlotTag)
             IssueNvmeDmaReq(reqSlotTag);
             PutToNvmeDmaReqQ(reqSlotTag);
         }
+        else if (reqPoolPtr->reqPool[reqSlotTag].reqType == REQ_TYPE_ZERO)
+            ExecuteZeroReq(reqSlotTag);
         else if (reqPoolPtr->reqPool[reqSlotTag].reqType == REQ_TYPE_NAND)
         {
             // get physical organization info from VSA
@@ -716,7 +1328,7 @@ void SelectLowLevelReqQ(unsigned int reqSlotTag)
  * released the data buffer entry it occupied. Therefore, we now need to update the
  * relevant information about the data buffer dependency.
  *
- * @warning Only the NAND requests with VSA can use this function.
+ * @warning Only the NAND requests with VSA or physical organization can use this function.
  *
  * @warning Since the struct `DATA_BUF_ENTRY` maintains only the tail of blocked requests,
  * the specified request should be the head of blocked requests to ensure that the request
@@ -769,6 +1381,8 @@ void ReleaseBlockedByBufDepReq(unsigned int reqSlotTag)
             IssueNvmeDmaReq(targetReqSlotTag);
             PutToNvmeDmaReqQ(targetReqSlotTag);
         }
+        else if (reqPoolPtr->reqPool[targetReqSlotTag].reqType == REQ_TYPE_ZERO)
+            ExecuteZeroReq(targetReqSlotTag);
         else if (reqPoolPtr->reqPool[targetReqSlotTag].reqType == REQ_TYPE_NAND)
         {
             if (reqPoolPtr->reqPool[targetReqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_VSA)
@@ -777,6 +1391,11 @@ void ReleaseBlockedByBufDepReq(unsigned int reqSlotTag)
                 chNo  = Vdie2PchTranslation(dieNo);
                 wayNo = Vdie2PwayTranslation(dieNo);
             }
+            else if (reqPoolPtr->reqPool[targetReqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_PHY_ORG)
+            {
+                chNo  = reqPoolPtr->reqPool[targetReqSlotTag].nandInfo.physicalCh;
+                wayNo = reqPoolPtr->reqPool[targetReqSlotTag].nandInfo.physicalWay;
+            }
             else
                 assert(!"[WARNING] Not supported reqOpt-nandAddress [WARNING]");
 
@@ -877,18 +1496,23 @@ void ReleaseBlockedByRowAddrDepReq(unsigned int chNo, unsigned int wayNo)
  */
 void IssueNvmeDmaReq(unsigned int reqSlotTag)
 {
-    unsigned int devAddr, dmaIndex, numOfNvmeBlock;
+    unsigned int devAddr, dmaIndex, numOfNvmeBlock, autoCpl;
 
     dmaIndex       = reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex;
     devAddr        = GenerateDataBufAddr(reqSlotTag);
     numOfNvmeBlock = 0;
 
+    // the completion of this command may be posted by firmware, check `nvme_completion.h`
+    if (is_nvme_cmd_manual_cpl(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag))
+        autoCpl = NVME_COMMAND_AUTO_COMPLETION_OFF;
+    else
+        autoCpl = NVME_COMMAND_AUTO_COMPLETION_ON;
+
     if (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_RxDMA)
     {
         while (numOfNvmeBlock < reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock)
         {
-            set_auto_rx_dma(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, dmaIndex, devAddr,
-                            NVME_COMMAND_AUTO_COMPLETION_ON);
+            set_auto_rx_dma(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, dmaIndex, devAddr, autoCpl);
 
             numOfNvmeBlock++;
             dmaIndex++;
@@ -901,8 +1525,7 @@ void IssueNvmeDmaReq(unsigned int reqSlotTag)
     {
         while (numOfNvmeBlock < reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock)
         {
-            set_auto_tx_dma(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, dmaIndex, devAddr,
-                            NVME_COMMAND_AUTO_COMPLETION_ON);
+            set_auto_tx_dma(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, dmaIndex, devAddr, autoCpl);
 
             numOfNvmeBlock++;
             dmaIndex++;
@@ -915,6 +1538,38 @@ void IssueNvmeDmaReq(unsigned int reqSlotTag)
         assert(!"[WARNING] Not supported reqCode [WARNING]");
 }
 
+/**
+ * @brief Release the NVMe completion held by the given NAND request, if any.
+ *
+ * If the request failed, the NVMe command will be completed with the error status, which
+ * is Unrecovered Read Error for a read request (only the physical address reads hold the
+ * completion), and Write Fault for a program or an erase request.
+ *
+ * @param reqSlotTag the request pool entry index of the finished NAND request.
+ * @param reqStatus the final status of the NAND request, `REQ_STATUS_(DONE|FAIL|WARNING)`.
+ */
+void ReleaseNandReqNvmeCpl(unsigned int reqSlotTag, unsigned int reqStatus)
+{
+    NVME_COMPLETION nvmeCPL;
+
+    if (reqPoolPtr->reqPool[reqSlotTag].reqOpt.nvmeCpl != REQ_OPT_NVME_CPL_HOLD)
+        return;
+
+    if (reqStatus == REQ_STATUS_FAIL)
+    {
+        nvmeCPL.statusFieldWord = 0;
+        nvmeCPL.statusField.SCT = SCT_MEDIA_AND_DATA_INTEGRITY_ERRORS;
+        if ((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) ||
+            (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER))
+            nvmeCPL.statusField.SC = SC_UNRECOVERED_READ_ERROR;
+        else
+            nvmeCPL.statusField.SC = SC_WRITE_FAULT;
+        set_nvme_cmd_cpl_status(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, nvmeCPL.statusFieldWord);
+    }
+
+    release_nvme_cmd_cpl(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
+}
+
 void CheckDoneNvmeDmaReq()
 {
     unsigned int reqSlotTag, prevReq;
@@ -935,7 +1590,10 @@ void CheckDoneNvmeDmaReq()
                                                         reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.overFlowCnt);
 
             if (rxDone)
+            {
+                release_nvme_cmd_cpl(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
                 SelectiveGetFromNvmeDmaReqQ(reqSlotTag);
+            }
         }
         else
         {
@@ -944,7 +1602,10 @@ void CheckDoneNvmeDmaReq()
                                                         reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.overFlowCnt);
 
             if (txDone)
+            {
+                release_nvme_cmd_cpl(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
                 SelectiveGetFromNvmeDmaReqQ(reqSlotTag);
+            }
         }
 
         reqSlotTag = prevReq;
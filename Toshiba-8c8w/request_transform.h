@@ -95,9 +95,14 @@ typedef struct _ROW_ADDR_DEPENDENCY_TABLE
 
 void InitDependencyTable();
 void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigned int nlb, unsigned int cmdCode);
+void ReqTransCopyToSlice(unsigned int cmdSlotTag, unsigned int srcLba, unsigned int dstLba, unsigned int nlb);
+void ReqTransNvmeToPhy(unsigned int cmdSlotTag, unsigned int chNo, unsigned int wayNo, unsigned int blockNo,
+                       unsigned int pageNo, unsigned int numOfPage, unsigned int cmdCode);
 void ReqTransSliceToLowLevel();
+void FlushDataBuf();
 void IssueNvmeDmaReq(unsigned int reqSlotTag);
 void CheckDoneNvmeDmaReq();
+void ReleaseNandReqNvmeCpl(unsigned int reqSlotTag, unsigned int reqStatus);
 
 void SelectLowLevelReqQ(unsigned int reqSlotTag);
 void ReleaseBlockedByBufDepReq(unsigned int reqSlotTag);
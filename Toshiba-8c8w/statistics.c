@@ -0,0 +1,228 @@
+//////////////////////////////////////////////////////////////////////////////////
+// statistics.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Statistics
+// File Name: statistics.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - collect the counters for the health information and write amplification
+//   - collect the telemetry counters of the scheduler and FTL
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <string.h>
+#include "memory_map.h"
+
+SSD_STATISTICS ssdStatistics;
+SSD_TELEMETRY ssdTelemetry;
+
+XTime telemetryResetTime;
+XTime dieBusyStartTime[USER_DIES];
+
+void InitStatistics()
+{
+    memset(&ssdStatistics, 0, sizeof(SSD_STATISTICS));
+    XTime_GetTime(&ssdStatistics.powerOnTime);
+
+    ResetTelemetry();
+}
+
+/**
+ * @brief Get the average erase count of the user blocks, the bad blocks are excluded.
+ *
+ * @note The erase counts of the blocks reserved for the physical address commands are not
+ * tracked, so only the blocks owned by the FTL are counted, and so does `GetEraseCntRange()`.
+ *
+ * @return unsigned int the average erase count, 0 if all the blocks are bad.
+ */
+unsigned int GetAvgEraseCnt()
+{
+    unsigned int dieNo, blockNo, blockCnt;
+    unsigned long long eraseCnt;
+
+    eraseCnt = 0;
+    blockCnt = 0;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        for (blockNo = 0; blockNo < FTL_BLOCKS_PER_DIE; blockNo++)
+            if (!VBLK_BAD(dieNo, blockNo))
+            {
+                eraseCnt += VBLK_ERASE_CNT(dieNo, blockNo);
+                blockCnt++;
+            }
+
+    return blockCnt ? (unsigned int)(eraseCnt / blockCnt) : 0;
+}
+
+/**
+ * @brief Get the min and max erase counts of the user blocks, the bad blocks are excluded.
+ *
+ * The difference between them is the wear spread, which should be kept around
+ * `WL_ERASE_CNT_SPREAD_THRESHOLD` by the wear leveling.
+ *
+ * @param minEraseCnt the min erase count, 0 if all the blocks are bad.
+ * @param maxEraseCnt the max erase count, 0 if all the blocks are bad.
+ */
+void GetEraseCntRange(unsigned int *minEraseCnt, unsigned int *maxEraseCnt)
+{
+    unsigned int dieNo, blockNo, eraseCnt, blockCnt;
+
+    *minEraseCnt = 0;
+    *maxEraseCnt = 0;
+    blockCnt     = 0;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        for (blockNo = 0; blockNo < FTL_BLOCKS_PER_DIE; blockNo++)
+            if (!VBLK_BAD(dieNo, blockNo))
+            {
+                eraseCnt = VBLK_ERASE_CNT(dieNo, blockNo);
+                if (!blockCnt || (eraseCnt < *minEraseCnt))
+                    *minEraseCnt = eraseCnt;
+                if (eraseCnt > *maxEraseCnt)
+                    *maxEraseCnt = eraseCnt;
+                blockCnt++;
+            }
+}
+
+/**
+ * @brief Get the number of bad blocks (both initial and grown) on all the dies.
+ *
+ * Every bad block consumes a reserved block, a bad user block is remapped to a reserved
+ * block, and a bad reserved block can't be used for remapping. So this count can be used
+ * for calculating the available spare.
+ *
+ * @sa `RemapBadBlock()`, `UpdatePhyBlockMapForGrownBadBlock()`.
+ *
+ * @return unsigned int the number of bad blocks.
+ */
+unsigned int GetBadBlockCnt()
+{
+    unsigned int dieNo, phyBlockNo, badBlockCnt;
+
+    badBlockCnt = 0;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        for (phyBlockNo = 0; phyBlockNo < TOTAL_BLOCKS_PER_DIE; phyBlockNo++)
+            if (phyBlockMapPtr->phyBlock[dieNo][phyBlockNo].bad)
+                badBlockCnt++;
+
+    return badBlockCnt;
+}
+
+unsigned int GetPowerOnHours()
+{
+    XTime curTime;
+
+    XTime_GetTime(&curTime);
+
+    return (unsigned int)((curTime - ssdStatistics.powerOnTime) / COUNTS_PER_SECOND / 3600);
+}
+
+/**
+ * @brief Get the write amplification factor, the ratio of the bytes programmed to the NAND
+ * to the bytes written by host.
+ *
+ * @return unsigned int the WAF in percentage (e.g., 150 for 1.5), 0 if the host didn't
+ * write anything yet.
+ */
+unsigned int GetWriteAmplificationFactor()
+{
+    unsigned long long nandWriteBytes, hostWriteBytes;
+
+    nandWriteBytes = ssdStatistics.nandWritePageCnt * BYTES_PER_DATA_REGION_OF_SLICE;
+    hostWriteBytes = ssdStatistics.hostWriteSectorCnt * BYTES_PER_SECTOR;
+
+    return hostWriteBytes ? (unsigned int)(nandWriteBytes * 100 / hostWriteBytes) : 0;
+}
+
+/**
+ * @brief Clear all the telemetry counters.
+ *
+ * @note The busy time of the dies that are busy now will be counted from now on.
+ */
+void ResetTelemetry()
+{
+    unsigned int dieNo;
+
+    memset(&ssdTelemetry, 0, sizeof(SSD_TELEMETRY));
+
+    ssdTelemetry.version         = TELEMETRY_VERSION;
+    ssdTelemetry.numOfChannels   = USER_CHANNELS;
+    ssdTelemetry.numOfWays       = USER_WAYS;
+    ssdTelemetry.countsPerSecond = COUNTS_PER_SECOND;
+
+    XTime_GetTime(&telemetryResetTime);
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        dieBusyStartTime[dieNo] = telemetryResetTime;
+}
+
+/**
+ * @brief Record the time when the die changed to `DIE_STATE_EXE`.
+ */
+void MarkDieBusy(unsigned int dieNo)
+{
+    XTime_GetTime(&dieBusyStartTime[dieNo]);
+}
+
+/**
+ * @brief Accumulate the busy time of the die that changed to `DIE_STATE_IDLE`.
+ */
+void MarkDieIdle(unsigned int dieNo)
+{
+    XTime curTime;
+
+    XTime_GetTime(&curTime);
+    ssdTelemetry.die[dieNo].busyTime += curTime - dieBusyStartTime[dieNo];
+}
+
+/**
+ * @brief Add the queue depth sample to the given histogram.
+ *
+ * @param hist the histogram with `TELEMETRY_QUEUE_DEPTH_BINS` bins.
+ * @param depth the queue depth, should be larger than 0.
+ */
+void AddToQueueDepthHist(unsigned int *hist, unsigned int depth)
+{
+    unsigned int bin;
+
+    bin = 0;
+    while ((depth >>= 1) && (bin < TELEMETRY_QUEUE_DEPTH_BINS - 1))
+        bin++;
+
+    hist[bin]++;
+}
+
+unsigned long long GetTelemetryElapsedTime()
+{
+    XTime curTime;
+
+    XTime_GetTime(&curTime);
+
+    return curTime - telemetryResetTime;
+}
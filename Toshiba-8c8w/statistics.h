@@ -0,0 +1,159 @@
+//////////////////////////////////////////////////////////////////////////////////
+// statistics.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Statistics
+// File Name: statistics.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define the counters for the health information and write amplification
+//   - define the telemetry counters of the scheduler and FTL
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef STATISTICS_H_
+#define STATISTICS_H_
+
+#include "xtime_l.h"
+
+#include "ftl_config.h"
+
+#define BYTES_PER_SECTOR 512 // the unit of the data units read/written of SMART
+
+/**
+ * @brief The counters of the SSD since it was powered on.
+ *
+ * The host counters are updated when the NVMe commands are completed without error, check
+ * `count_nvme_cmd_cpl()`, and the NAND counters are updated when the NAND requests are
+ * finished, check `ExecuteNandReq()`.
+ *
+ * @note The counters are kept in memory only, so they are reset at each power cycle.
+ */
+typedef struct _SSD_STATISTICS
+{
+    unsigned long long hostReadSectorCnt;  // the number of sectors read by the completed read commands
+    unsigned long long hostWriteSectorCnt; // the number of sectors written by the completed write commands
+    unsigned long long hostReadCmdCnt;     // the number of read commands completed successfully
+    unsigned long long hostWriteCmdCnt;    // the number of write commands completed successfully
+    unsigned long long nandWritePageCnt;   // the number of pages programmed, including GC and metadata
+    unsigned long long gcCopyPageCnt;      // the number of valid pages copied by GC
+    unsigned long long gcEraseCnt;         // the number of victim blocks erased by GC
+    unsigned long long mediaErrorCnt;      // the number of NAND requests failed after retry
+    unsigned long long wlMigratedBlockCnt; // the number of cold blocks migrated by the static wear leveling
+    XTime powerOnTime;                     // when the FTL was initialized
+} SSD_STATISTICS, *P_SSD_STATISTICS;
+
+#define TELEMETRY_VERSION          6
+#define TELEMETRY_QUEUE_DEPTH_BINS 8 // 1, 2~3, 4~7, ..., 64~127, 128+
+
+/**
+ * @brief The telemetry counters of a die.
+ *
+ * The NAND operations are counted when they are issued, so the retries are also counted.
+ * The busy time is the time the die spent in `DIE_STATE_EXE`, in XTime counts.
+ */
+typedef struct _DIE_TELEMETRY
+{
+    unsigned int readCnt;  // the number of READ_TRANSFER issued
+    unsigned int writeCnt; // the number of WRITE issued
+    unsigned int eraseCnt; // the number of ERASE issued
+    unsigned int gcCnt;    // the number of GC invoked on this die
+    unsigned long long busyTime;
+} DIE_TELEMETRY, *P_DIE_TELEMETRY;
+
+/**
+ * @brief The telemetry counters of a channel.
+ *
+ * A channel is saturated if its command queue is often full while there are requests
+ * waiting to be issued, which can be measured by `queueFullCnt / issueAttemptCnt`.
+ */
+typedef struct _CHANNEL_TELEMETRY
+{
+    unsigned int issueAttemptCnt; // the number of scheduling passes with requests to be issued
+    unsigned int queueFullCnt;    // the number of passes that the command queue was full
+} CHANNEL_TELEMETRY, *P_CHANNEL_TELEMETRY;
+
+/**
+ * @brief The telemetry counters since the last reset, reported by the vendor specific log
+ * page `LOG_PAGE_VENDOR_TELEMETRY` as is.
+ *
+ * The queue depth histograms are sampled when a request is added to the queue, the depth
+ * including the added request is counted in the bin `floor(log2(depth))`.
+ *
+ * @note All the members are naturally aligned, so the layout of the log page is identical
+ * to this structure.
+ *
+ * @sa `get_vendor_telemetry_log()`.
+ */
+typedef struct _SSD_TELEMETRY
+{
+    unsigned int version;
+    unsigned short numOfChannels;
+    unsigned short numOfWays;
+    unsigned long long countsPerSecond; // the unit of the time counters
+    unsigned long long elapsedTime;     // the time since the last reset, filled when reporting
+    unsigned long long gcCnt;           // the number of GC invoked
+    unsigned long long dataBufHitCnt;
+    unsigned long long dataBufMissCnt;
+    unsigned long long dataBufEvictDirtyCnt; // the number of dirty entries evicted
+    unsigned long long freeReqStallCnt;      // the number of times `SyncAvailFreeReq()` was needed
+    unsigned long long mapCacheHitCnt;       // the map segment lookups served by the map cache
+    unsigned long long mapCacheMissCnt;      // the map segment lookups fetched from the HMB or NAND
+    unsigned long long mapCacheFlushCnt;     // the number of dirty map segments written back
+    unsigned long long mapCacheFetchTime;    // the total time spent on fetching map segments
+    unsigned long long mapExtentHitCnt;      // the lookups served by the compressed map segments
+    unsigned long long mapExtentExpandCnt;   // the compressed map segments expanded on fragmentation
+    unsigned long long mapExtentPackCnt;     // the dirty map segments compressed instead of written back
+    unsigned long long gcCrossDieCopyCnt;    // the valid slices programmed to another die by GC
+    unsigned long long gcBlockingCnt;        // the GCs finished at once since a die ran out of free blocks
+    unsigned long long writeThrottleTime;    // the total time the host writes were held by `AdmitHostWrite()`
+    unsigned int nandReqQDepthHist[TELEMETRY_QUEUE_DEPTH_BINS];
+    unsigned int blockedByRowAddrDepReqQDepthHist[TELEMETRY_QUEUE_DEPTH_BINS];
+    CHANNEL_TELEMETRY channel[USER_CHANNELS];
+    DIE_TELEMETRY die[USER_DIES];
+} SSD_TELEMETRY, *P_SSD_TELEMETRY;
+
+void InitStatistics();
+unsigned int GetAvgEraseCnt();
+void GetEraseCntRange(unsigned int *minEraseCnt, unsigned int *maxEraseCnt);
+unsigned int GetBadBlockCnt();
+unsigned int GetPowerOnHours();
+unsigned int GetWriteAmplificationFactor();
+
+void ResetTelemetry();
+void MarkDieBusy(unsigned int dieNo);
+void MarkDieIdle(unsigned int dieNo);
+void AddToQueueDepthHist(unsigned int *hist, unsigned int depth);
+unsigned long long GetTelemetryElapsedTime();
+
+extern SSD_STATISTICS ssdStatistics;
+extern SSD_TELEMETRY ssdTelemetry;
+
+#endif /* STATISTICS_H_ */
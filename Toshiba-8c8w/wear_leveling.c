@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////////////
+// wear_leveling.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Wear Leveling
+// File Name: wear_leveling.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - select the cold blocks for the static wear leveling
+//   - migrate the cold blocks while the host is idle
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "memory_map.h"
+
+WEAR_LEVELING_MAP wlMap;
+
+void InitWearLeveling()
+{
+    unsigned int dieNo;
+
+    memset(&wlMap, 0, sizeof(WEAR_LEVELING_MAP));
+
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        wlMap.coldBlock[dieNo] = BLOCK_NONE;
+    wlMap.migratingDie = DIE_NONE;
+}
+
+/**
+ * @brief Find the least erased block holding data on the specified die.
+ *
+ * The bad blocks and the free blocks are skipped, and so are the current block and the
+ * victim block of the die, which will be filled or erased soon anyway. The blocks reserved
+ * for the physical address commands are not owned by the FTL, so they are not checked.
+ *
+ * @param dieNo the die to be checked.
+ * @return unsigned int the least erased block, or `BLOCK_NONE` if there is none.
+ */
+static unsigned int FindColdBlock(unsigned int dieNo)
+{
+    unsigned int blockNo, coldBlockNo;
+
+    coldBlockNo = BLOCK_NONE;
+    for (blockNo = 0; blockNo < FTL_BLOCKS_PER_DIE; blockNo++)
+    {
+        if (VBLK_BAD(dieNo, blockNo) || VBLK_FREE(dieNo, blockNo))
+            continue;
+        if ((blockNo == virtualDieMapPtr->die[dieNo].currentBlock) ||
+            (blockNo == gcVictimMapPtr->victimBlock[dieNo]))
+            continue;
+
+        if ((coldBlockNo == BLOCK_NONE) || (VBLK_ERASE_CNT(dieNo, blockNo) < VBLK_ERASE_CNT(dieNo, coldBlockNo)))
+            coldBlockNo = blockNo;
+    }
+
+    return coldBlockNo;
+}
+
+/**
+ * @brief Update the state of the static wear leveling after a block is erased.
+ *
+ * A die is checked every `WL_CHECK_INTERVAL` erases, if the erase count of its least erased
+ * block in use is more than `WL_ERASE_CNT_SPREAD_THRESHOLD` below the max erase count of
+ * the die, the block is selected as the cold block of the die.
+ *
+ * @note The cold block may be erased by the GC before it is migrated, which has the same
+ * effect as migrating it.
+ *
+ * @param dieNo the die of the erased block.
+ * @param blockNo the erased block.
+ */
+void CheckWearLeveling(unsigned int dieNo, unsigned int blockNo)
+{
+    unsigned int coldBlockNo;
+
+    if (VBLK_ERASE_CNT(dieNo, blockNo) > wlMap.maxEraseCnt[dieNo])
+        wlMap.maxEraseCnt[dieNo] = VBLK_ERASE_CNT(dieNo, blockNo);
+
+    if (blockNo == wlMap.coldBlock[dieNo])
+    {
+        if (wlMap.migratingDie == dieNo)
+        {
+            wlMap.migratingDie = DIE_NONE;
+            ssdStatistics.wlMigratedBlockCnt++;
+        }
+        wlMap.coldBlock[dieNo] = BLOCK_NONE;
+        wlMap.coldBlockCnt--;
+    }
+
+    wlMap.eraseCnt[dieNo]++;
+    if ((wlMap.eraseCnt[dieNo] < WL_CHECK_INTERVAL) || (wlMap.coldBlock[dieNo] != BLOCK_NONE))
+        return;
+
+    wlMap.eraseCnt[dieNo] = 0;
+    if (wlMap.maxEraseCnt[dieNo] <= WL_ERASE_CNT_SPREAD_THRESHOLD)
+        return;
+
+    coldBlockNo = FindColdBlock(dieNo);
+    if ((coldBlockNo != BLOCK_NONE) &&
+        (wlMap.maxEraseCnt[dieNo] - VBLK_ERASE_CNT(dieNo, coldBlockNo) > WL_ERASE_CNT_SPREAD_THRESHOLD))
+    {
+        wlMap.coldBlock[dieNo] = coldBlockNo;
+        wlMap.coldBlockCnt++;
+    }
+}
+
+/**
+ * @brief Start migrating a cold block while there is no host request and no ongoing GC.
+ *
+ * The cold block is collected like a GC victim, check `StartGarbageCollection()`, and the
+ * following steps are done by `IdleGarbageCollection()`. Only one cold block is migrated
+ * at a time.
+ */
+void IdleWearLeveling()
+{
+    unsigned int dieNo, blockNo;
+
+    if (!wlMap.coldBlockCnt || (wlMap.migratingDie != DIE_NONE))
+        return;
+
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+    {
+        blockNo = wlMap.coldBlock[dieNo];
+        if (blockNo == BLOCK_NONE)
+            continue;
+
+        // a block is only in the victim list after some of its slices are invalidated
+        if (VBLK_INVALID_CNT(dieNo, blockNo))
+            SelectiveGetFromGcVictimList(dieNo, blockNo);
+
+        wlMap.migratingDie = dieNo;
+        StartGarbageCollection(dieNo, blockNo);
+        return;
+    }
+}
+
+/**
+ * @brief Park the migration of the cold block of the specified die.
+ *
+ * Called once the die runs short of free blocks, the cold block is returned to the victim
+ * list, and stays the cold block of the die, so its migration is restarted by
+ * `IdleWearLeveling()` once no die needs GC. It may also be erased by the GC meanwhile.
+ *
+ * @param dieNo the die migrating its cold block.
+ */
+void ParkWearLevelingMigration(unsigned int dieNo)
+{
+    StopGarbageCollection(dieNo);
+    wlMap.migratingDie = DIE_NONE;
+}
+
+/**
+ * @brief Check whether the specified block is a cold block being migrated.
+ */
+unsigned int IsWearLevelingMigration(unsigned int dieNo, unsigned int blockNo)
+{
+    return (wlMap.migratingDie == dieNo) && (wlMap.coldBlock[dieNo] == blockNo);
+}
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////////
+// wear_leveling.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Wear Leveling
+// File Name: wear_leveling.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define the state of the static wear leveling
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WEAR_LEVELING_H_
+#define WEAR_LEVELING_H_
+
+#include "ftl_config.h"
+
+#define WL_CHECK_INTERVAL             64  // user configurable factor, the erases of a die between two checks
+#define WL_ERASE_CNT_SPREAD_THRESHOLD 128 // user configurable factor, the max erase count spread of a die
+
+/**
+ * @brief The state of the static wear leveling.
+ *
+ * The free blocks are allocated in the order of their erase counts, check `PutToFbList()`,
+ * which only levels the blocks that are erased anyway. A block holding cold data is never
+ * erased, so once the erase counts of a die spread over `WL_ERASE_CNT_SPREAD_THRESHOLD`, the
+ * least erased block in use is selected as a cold block, and its valid slices are moved
+ * by the GC, check `CheckWearLeveling()` and `IdleWearLeveling()`.
+ *
+ * To avoid slowing down the host requests, the dies are only checked every
+ * `WL_CHECK_INTERVAL` erases, and a cold block is only migrated while the host is idle and
+ * no GC is ongoing, one at a time. The migration is parked once its die runs short of free
+ * blocks, check `ParkWearLevelingMigration()`.
+ */
+typedef struct _WEAR_LEVELING_MAP
+{
+    unsigned int maxEraseCnt[USER_DIES]; // the max erase count of the blocks on each die
+    unsigned int eraseCnt[USER_DIES];    // the erases of each die since the last check
+    unsigned int coldBlock[USER_DIES];   // the block to be migrated, or `BLOCK_NONE`
+    unsigned int coldBlockCnt;           // the number of dies with a `coldBlock`
+    unsigned int migratingDie;           // the die whose `coldBlock` is being migrated, or `DIE_NONE`
+} WEAR_LEVELING_MAP;
+
+void InitWearLeveling();
+void CheckWearLeveling(unsigned int dieNo, unsigned int blockNo);
+void IdleWearLeveling();
+void ParkWearLevelingMigration(unsigned int dieNo);
+unsigned int IsWearLevelingMigration(unsigned int dieNo, unsigned int blockNo);
+
+extern WEAR_LEVELING_MAP wlMap;
+
+#endif /* WEAR_LEVELING_H_ */
@@ -0,0 +1,176 @@
+//////////////////////////////////////////////////////////////////////////////////
+// write_throttle.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Write Throttle
+// File Name: write_throttle.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - measure the GC debt and the copy cost of the next victims
+//   - pace the host writes with a token bucket
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "memory_map.h"
+
+WRITE_THROTTLE writeThrottle;
+
+void InitWriteThrottle()
+{
+    memset(&writeThrottle, 0, sizeof(WRITE_THROTTLE));
+
+    XTime_GetTime(&writeThrottle.lastUpdateTime);
+    writeThrottle.lastGcCopyCnt       = ssdStatistics.gcCopyPageCnt;
+    writeThrottle.victimValidSliceCnt = SLICES_PER_BLOCK;
+}
+
+/**
+ * @brief Update the measured speeds and the slice rate of the host writes.
+ *
+ * The program bandwidth is only measured while the host writes or the GC keep the dies
+ * busy, so the highest rate so far is used. The dies without any usable slice are ignored,
+ * since their free blocks never change.
+ *
+ * Once the rate is above the program bandwidth, the host writes are not throttled at all,
+ * which also lets a bandwidth measured too low (e.g. right after the boot) grow.
+ *
+ * @param curTime the current time.
+ */
+static void UpdateWriteThrottle(XTime curTime)
+{
+    unsigned long long programmedSliceCnt, elapsedTime;
+    unsigned int dieNo, targetDie, sliceRate;
+    long long rate;
+
+    elapsedTime        = curTime - writeThrottle.lastUpdateTime;
+    programmedSliceCnt =
+        writeThrottle.admittedSliceCnt + (ssdStatistics.gcCopyPageCnt - writeThrottle.lastGcCopyCnt);
+
+    writeThrottle.programRate = (writeThrottle.programRate * (THROTTLE_EWMA_WEIGHT - 1) +
+                                 (unsigned int)(programmedSliceCnt * COUNTS_PER_SECOND / elapsedTime)) /
+                                THROTTLE_EWMA_WEIGHT;
+    if (writeThrottle.maxProgramRate < writeThrottle.programRate)
+        writeThrottle.maxProgramRate = writeThrottle.programRate;
+
+    writeThrottle.lastUpdateTime   = curTime;
+    writeThrottle.lastGcCopyCnt    = ssdStatistics.gcCopyPageCnt;
+    writeThrottle.admittedSliceCnt = 0;
+
+    targetDie = DIE_NONE;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        if (nsMap.dieSlice[dieNo] && ((targetDie == DIE_NONE) || (virtualDieMapPtr->die[dieNo].freeBlockCnt <
+                                                                  virtualDieMapPtr->die[targetDie].freeBlockCnt)))
+            targetDie = dieNo;
+    if (targetDie == DIE_NONE)
+        return;
+
+    writeThrottle.victimValidSliceCnt = GetGcVictimValidSliceCnt(targetDie, THROTTLE_VICTIM_COUNT);
+
+    rate = (long long)writeThrottle.maxProgramRate * (SLICES_PER_BLOCK - writeThrottle.victimValidSliceCnt) /
+           SLICES_PER_BLOCK;
+    rate += ((long long)virtualDieMapPtr->die[targetDie].freeBlockCnt - THROTTLE_FREE_BLOCK_COUNT) *
+            SLICES_PER_BLOCK * USER_DIES / THROTTLE_SURPLUS_TIME;
+
+    if (rate > writeThrottle.maxProgramRate)
+    {
+        writeThrottle.sliceRate = 0;
+        return;
+    }
+    sliceRate = (rate < THROTTLE_MIN_SLICE_RATE) ? THROTTLE_MIN_SLICE_RATE : (unsigned int)rate;
+
+    // start with a full bucket, so the writes are not held right after the throttling starts
+    if (!writeThrottle.sliceRate)
+    {
+        writeThrottle.tokens         = THROTTLE_BURST_SLICES;
+        writeThrottle.lastRefillTime = curTime;
+    }
+    writeThrottle.sliceRate = sliceRate;
+}
+
+/**
+ * @brief Check whether a host write of the specified size can be admitted now.
+ *
+ * A write is admitted if there is any token left, and the tokens may go negative for a
+ * large write, which is paid back by the following writes. The time a write is held is
+ * given to the GC, so that the debt is reclaimed meanwhile, check `IdleGarbageCollection()`.
+ *
+ * @param numOfSlice the number of slices to be written.
+ * @return unsigned int 1 if the write is admitted, 0 if it should be deferred.
+ */
+unsigned int AdmitHostWrite(unsigned int numOfSlice)
+{
+    XTime curTime;
+    unsigned long long elapsedTime, refill;
+
+    XTime_GetTime(&curTime);
+    if (curTime - writeThrottle.lastUpdateTime >= THROTTLE_UPDATE_PERIOD)
+        UpdateWriteThrottle(curTime);
+
+    if (writeThrottle.sliceRate)
+    {
+        elapsedTime = curTime - writeThrottle.lastRefillTime;
+        if (elapsedTime > COUNTS_PER_SECOND)
+            elapsedTime = COUNTS_PER_SECOND;
+
+        // keep the remainder in `lastRefillTime`, or the slow rates will never refill
+        refill = elapsedTime * writeThrottle.sliceRate / COUNTS_PER_SECOND;
+        if (refill >= (unsigned long long)(THROTTLE_BURST_SLICES - writeThrottle.tokens))
+        {
+            writeThrottle.tokens         = THROTTLE_BURST_SLICES;
+            writeThrottle.lastRefillTime = curTime;
+        }
+        else if (refill)
+        {
+            writeThrottle.tokens += (int)refill;
+            writeThrottle.lastRefillTime += refill * COUNTS_PER_SECOND / writeThrottle.sliceRate;
+        }
+
+        if (writeThrottle.tokens <= 0)
+        {
+            if (!writeThrottle.throttledTime)
+                writeThrottle.throttledTime = curTime;
+
+            IdleGarbageCollection();
+            return 0;
+        }
+
+        writeThrottle.tokens -= (int)numOfSlice;
+    }
+    writeThrottle.admittedSliceCnt += numOfSlice;
+
+    if (writeThrottle.throttledTime)
+    {
+        ssdTelemetry.writeThrottleTime += curTime - writeThrottle.throttledTime;
+        writeThrottle.throttledTime = 0;
+    }
+
+    return 1;
+}
@@ -0,0 +1,100 @@
+//////////////////////////////////////////////////////////////////////////////////
+// write_throttle.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Write Throttle
+// File Name: write_throttle.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define the state of the host write throttling
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WRITE_THROTTLE_H_
+#define WRITE_THROTTLE_H_
+
+#include "xtime_l.h"
+
+#include "ftl_config.h"
+
+#define THROTTLE_UPDATE_PERIOD    (COUNTS_PER_SECOND / 100) // how often the slice rate is updated
+#define THROTTLE_EWMA_WEIGHT      8    // the speeds are averaged over about this many periods
+#define THROTTLE_BURST_SLICES     4096 // user configurable factor, the max slices admitted at once
+#define THROTTLE_MIN_SLICE_RATE   256  // user configurable factor, in slices per second, never stop the host
+#define THROTTLE_VICTIM_COUNT     8    // user configurable factor, the victims the copy cost is averaged over
+#define THROTTLE_SURPLUS_TIME     60   // user configurable factor, in seconds, to spend the surplus free blocks
+#define THROTTLE_FREE_BLOCK_COUNT 6    // user configurable factor, the free blocks the surplus is spent down to,
+                                       // between `GC_START_FREE_BLOCK_COUNT` and `GC_BACKGROUND_FREE_BLOCK_COUNT`
+
+/**
+ * @brief The state of the host write throttling.
+ *
+ * The GC debt is measured on the die with the fewest free blocks, by its free blocks above
+ * or below `THROTTLE_FREE_BLOCK_COUNT`, and by the valid slices the GC will have to copy
+ * from its next victim blocks. The host writes are admitted by a token bucket, whose
+ * rate is the sum of two terms, check `UpdateWriteThrottle()`:
+ *
+ * - The sustainable rate. A victim with `v` valid slices frees `SLICES_PER_BLOCK - v` slices
+ *   for `v` copies, so the host gets that share of the program bandwidth of the SSD, which is
+ *   the fastest the host writes and the GC copies were ever programmed together.
+ * - The surplus. The free blocks above `THROTTLE_FREE_BLOCK_COUNT` are spent over
+ *   `THROTTLE_SURPLUS_TIME`, and the free blocks missing below it are taken back over the
+ *   same time.
+ *
+ * So the pacing starts long before `GC_BACKGROUND_FREE_BLOCK_COUNT` is reached. A drive
+ * with all of its over-provisioning free slows down gradually to the rate the GC can
+ * sustain, instead of running at full speed until the foreground GC starts, and in the
+ * steady state the rate follows the average cost of the victims rather than the cost of
+ * each one.
+ *
+ * The burst covers about the free slices a victim block of each die reclaims, so the tokens
+ * saved while the victims are copied are spent once they are erased, instead of leaving
+ * the dies idle.
+ */
+typedef struct _WRITE_THROTTLE
+{
+    XTime lastUpdateTime;
+    XTime lastRefillTime;
+    XTime throttledTime;               // when a write was first held, 0 if no write is held
+    unsigned long long lastGcCopyCnt;  // `SSD_STATISTICS::gcCopyPageCnt` at the last update
+    unsigned int programRate;          // the host slices and GC copies programmed per second
+    unsigned int maxProgramRate;       // the highest `programRate` so far, i.e. the program bandwidth
+    unsigned int victimValidSliceCnt;  // the average valid slices of the next victim blocks
+    unsigned int admittedSliceCnt;     // the host slices admitted since the last update
+    unsigned int sliceRate;            // the host slices admitted per second, 0 if not throttled
+    int tokens;                        // the host slices can be admitted now
+} WRITE_THROTTLE;
+
+void InitWriteThrottle();
+unsigned int AdmitHostWrite(unsigned int numOfSlice);
+
+extern WRITE_THROTTLE writeThrottle;
+
+#endif /* WRITE_THROTTLE_H_ */
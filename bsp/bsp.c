@@ -1,3 +1,7 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <time.h>
+
 #include "bsp.h"
 #include "debug.h"
 
@@ -6,4 +10,12 @@ char inbyte()
     pr_info("Waiting for keyboard input: ");
     return getc(stdin);
 }
-void *void_func() { return NULL; }
\ No newline at end of file
+void *void_func() { return NULL; }
+
+void XTime_GetTime(XTime *Xtime_Global)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    *Xtime_Global = (XTime)ts.tv_sec * COUNTS_PER_SECOND + ts.tv_nsec / 1000;
+}
\ No newline at end of file
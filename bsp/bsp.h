@@ -52,6 +52,11 @@ typedef struct
 #define XScuGic_CfgInitialize(...)        void_func()
 #define XPAR_SCUGIC_SINGLE_DEVICE_ID
 
+typedef unsigned long long XTime;
+
+#define COUNTS_PER_SECOND 1000000ULL
+
+extern void XTime_GetTime(XTime *Xtime_Global);
 extern char inbyte() __attribute__((unused));
 extern void *void_func() __attribute__((unused));
 
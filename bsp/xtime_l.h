@@ -0,0 +1 @@
+#include "bsp.h"
\ No newline at end of file
@@ -0,0 +1,447 @@
+//////////////////////////////////////////////////////////////////////////////////
+// copy_sim.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Copy Simulation
+// File Name: copy_sim.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - host-side microbenchmark of the Copy command, check `handle_nvme_io_copy()`
+//   - compare a host-mediated copy (Read to the host, then Write back) with Copy on the
+//     same ranges, and report the throughput, the PCIe traffic and the busy time of the
+//     link and of the firmware core
+//
+// Build and run on the host, from the root of the repository:
+//
+//   gcc -std=c99 -O2 -DHOST_DEBUG -Ibsp -IToshiba-8c8w -IToshiba-8c8w/nvme
+//       tools/copy_sim.c -o copy_sim
+//   ./copy_sim [-m megabytes]
+//
+// Every stage of a slice is scheduled on the resource it occupies: the dies, each
+// direction of the host link and the firmware core, which handles one request at a time.
+// The stages follow the firmware:
+//
+//   - Read and Write: a NAND read into the data buffer and a TxDMA, then a RxDMA, with a
+//     NAND read first if the destination slice is partially written and not cached.
+//   - Copy: a whole uncached source slice is read straight into the destination entry.
+//     Otherwise the source is read into its own entry and the core waits for both entries
+//     (`SyncDataBufReqDone()`) before it copies the blocks, check
+//     `ReqTransCopySliceToLowLevel()`.
+//
+// In both cases the destination entry is programmed when it is evicted, on the die of the
+// next free slice, and the programs of the dirty entries hold their buffer entries. The
+// sources are cold, i.e. not cached before they are copied, and the destination is written
+// sequentially, like a compaction. The host keeps `SIM_QUEUE_DEPTH` ranges in flight, or
+// Copy commands of up to `COPY_MAX_LENGTH` blocks, and starts the Write of a range once its
+// Read is complete. The run ends when all the programs are done.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory_map.h"
+#include "nvme/nvme.h"
+
+/*
+ * The typical timing of a MLC die, not measured on the board, same as `map_cache_sim.c`.
+ * The firmware times are rough figures of the Cortex-A9 core.
+ */
+#define SIM_READ_TIME      60   // in us, a page read and transfer
+#define SIM_PROG_TIME      1300 // in us, a page program
+#define SIM_XFER_TIME      5    // in us, a slice over the PCIe Gen2 x8 link of the board
+#define SIM_CMD_TIME       3    // in us, fetch, check and split a NVMe command
+#define SIM_SLICE_REQ_TIME 1    // in us, handle a slice request
+#define SIM_MEMCPY_TIME    4    // in us, copy a NVMe block between the data buffer entries
+#define SIM_HOST_TIME      10   // in us, from the completion of a Read to the Write of the host
+
+#define SIM_DEFAULT_MEGABYTES 1024
+#define SIM_QUEUE_DEPTH       32
+#define SIM_BUFFER_ENTRIES    (16 * USER_DIES) // `AVAILABLE_DATA_BUFFER_ENTRY_COUNT`
+#define SIM_CMD_BYTES         80               // a submission and a completion queue entry
+#define SIM_RANGE_BYTES       32               // a source range entry of Copy
+#define SIM_INTERVALS         1024             // the busy intervals kept per resource
+#define SIM_NONE              0xffffffff
+
+#define SIM_PATH_HOST   0
+#define SIM_PATH_DEVICE 1
+#define SIM_PATH_COUNT  2
+
+#define SIM_NS(us) ((unsigned long long)(us) * 1000)
+
+typedef struct _SIM_WORKLOAD
+{
+    const char *name;
+    unsigned int rangeBlocks; // the NVMe blocks of each source range
+    unsigned int aligned;     // whether the source ranges start on a slice boundary
+} SIM_WORKLOAD;
+
+static const SIM_WORKLOAD simWorkload[] = {
+    {"aligned 1MB ranges", COPY_MAX_RANGE_LENGTH, 1},
+    {"aligned 64KB ranges", 16, 1},
+    {"unaligned 64KB ranges", 16, 0},
+    {"unaligned 4KB ranges", 1, 0},
+};
+
+static const char *simPathName[SIM_PATH_COUNT] = {"Read + Write", "Copy"};
+
+/**
+ * @brief A die, a direction of the host link or the firmware core.
+ *
+ * A resource serves any request that is ready, e.g. a die reads while the program queued
+ * before waits for its data, so the busy intervals are kept in order, and a request takes
+ * the first idle gap after it is ready. The times are in ns.
+ */
+typedef struct _SIM_RESOURCE
+{
+    unsigned long long busy[SIM_INTERVALS][2];
+    unsigned int intervalCnt;
+    unsigned long long busyTime;
+} SIM_RESOURCE;
+
+static struct
+{
+    SIM_RESOURCE die[USER_DIES], tx, rx, core;
+    unsigned long long pcieBytes, endTime;
+    unsigned long long cmdDone[SIM_QUEUE_DEPTH];
+    unsigned long long progDone[SIM_BUFFER_ENTRIES];
+    unsigned int progCnt, targetDie;
+    unsigned int dstLsa;         // the cached destination slice, `SIM_NONE` if none
+    unsigned long long dstReady; // when the data of the cached destination slice is in place
+    unsigned int srcLsa;         // the last source slice read into its own entry
+    unsigned long long srcReady;
+} sim;
+
+static unsigned int SimRandom()
+{
+    static unsigned long long seed = 0x2545f4914f6cdd1dULL;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (unsigned int)seed;
+}
+
+static unsigned long long SimMax(unsigned long long a, unsigned long long b) { return (a > b) ? a : b; }
+
+/**
+ * @brief Occupy the first idle gap of a resource after the specified time.
+ *
+ * @return when the resource is done with the request.
+ */
+static unsigned long long SimUse(SIM_RESOURCE *res, unsigned long long ready, unsigned long long duration)
+{
+    unsigned long long(*busy)[2] = res->busy;
+    unsigned int low, high, iInterval;
+
+    res->busyTime += duration;
+
+    // the first interval that ends after the ready time
+    low  = 0;
+    high = res->intervalCnt;
+    while (low < high)
+    {
+        iInterval = (low + high) / 2;
+        if (busy[iInterval][1] <= ready)
+            low = iInterval + 1;
+        else
+            high = iInterval;
+    }
+    for (iInterval = low; iInterval < res->intervalCnt; iInterval++)
+    {
+        if (busy[iInterval][0] >= ready + duration)
+            break;
+        ready = SimMax(ready, busy[iInterval][1]);
+    }
+
+    if ((iInterval > 0) && (busy[iInterval - 1][1] == ready))
+        busy[iInterval - 1][1] += duration;
+    else
+    {
+        // give up the oldest gap if there is no room
+        if (res->intervalCnt == SIM_INTERVALS)
+        {
+            busy[1][0] = busy[0][0];
+            memmove(busy[0], busy[1], (res->intervalCnt - 1) * sizeof(busy[0]));
+            res->intervalCnt--;
+            iInterval--;
+        }
+        memmove(busy[iInterval + 1], busy[iInterval], (res->intervalCnt - iInterval) * sizeof(busy[0]));
+        busy[iInterval][0] = ready;
+        busy[iInterval][1] = ready + duration;
+        res->intervalCnt++;
+        iInterval++;
+    }
+    if ((iInterval < res->intervalCnt) && (busy[iInterval - 1][1] == busy[iInterval][0]))
+    {
+        busy[iInterval - 1][1] = busy[iInterval][1];
+        memmove(busy[iInterval], busy[iInterval + 1], (res->intervalCnt - iInterval - 1) * sizeof(busy[0]));
+        res->intervalCnt--;
+    }
+
+    return ready + duration;
+}
+
+static unsigned long long SimNandRead(unsigned int lsa, unsigned long long ready)
+{
+    return SimUse(&sim.die[lsa % USER_DIES], ready, SIM_NS(SIM_READ_TIME));
+}
+
+static unsigned long long SimXfer(SIM_RESOURCE *link, unsigned int blocks, unsigned long long ready)
+{
+    sim.pcieBytes += (unsigned long long)blocks * BYTES_PER_NVME_BLOCK;
+    return SimUse(link, ready, SIM_NS(SIM_XFER_TIME) * blocks / NVME_BLOCKS_PER_SLICE);
+}
+
+/**
+ * @brief Program the cached destination slice on the next die, like `EvictDataBufEntry()`.
+ */
+static void SimEvictDstSlice()
+{
+    unsigned long long progDone;
+
+    if (sim.dstLsa == SIM_NONE)
+        return;
+
+    progDone      = SimUse(&sim.die[sim.targetDie], sim.dstReady, SIM_NS(SIM_PROG_TIME));
+    sim.targetDie = (sim.targetDie + 1) % USER_DIES;
+
+    sim.progDone[sim.progCnt % SIM_BUFFER_ENTRIES] = progDone;
+    sim.progCnt++;
+    sim.endTime = SimMax(sim.endTime, progDone);
+    sim.dstLsa  = SIM_NONE;
+}
+
+/**
+ * @brief Look up the destination slice, and allocate its entry on a miss.
+ *
+ * @return when the entry is allocated, i.e. the program of the dirty entry it reuses is done.
+ */
+static unsigned long long SimAllocateDstSlice(unsigned int dstLsa, unsigned long long ready, unsigned int *hit)
+{
+    *hit = (sim.dstLsa == dstLsa);
+    if (*hit)
+        return ready;
+
+    SimEvictDstSlice();
+    sim.dstLsa   = dstLsa;
+    sim.dstReady = 0;
+    if (sim.progCnt >= SIM_BUFFER_ENTRIES)
+        ready = SimMax(ready, sim.progDone[sim.progCnt % SIM_BUFFER_ENTRIES]);
+    return ready;
+}
+
+/**
+ * @brief The NVMe blocks from the specified block to the end of its slice, or to the end.
+ */
+static unsigned int SimBlocksInSlice(unsigned int lba, unsigned int endLba)
+{
+    unsigned int blocks = NVME_BLOCKS_PER_SLICE - lba % NVME_BLOCKS_PER_SLICE;
+
+    return (blocks < endLba - lba) ? blocks : endLba - lba;
+}
+
+/**
+ * @brief Read a source range to the host, and return when all of it is received.
+ */
+static unsigned long long SimHostRead(unsigned int srcLba, unsigned int nlb, unsigned long long ready)
+{
+    unsigned long long done, coreDone;
+    unsigned int lba, blocks;
+
+    coreDone = SimUse(&sim.core, ready, SIM_NS(SIM_CMD_TIME));
+    done     = coreDone;
+    for (lba = srcLba; lba < srcLba + nlb; lba += blocks)
+    {
+        blocks   = SimBlocksInSlice(lba, srcLba + nlb);
+        coreDone = SimUse(&sim.core, coreDone, SIM_NS(SIM_SLICE_REQ_TIME));
+        done     = SimMax(done, SimXfer(&sim.tx, blocks, SimNandRead(lba / NVME_BLOCKS_PER_SLICE, coreDone)));
+    }
+    sim.pcieBytes += SIM_CMD_BYTES;
+
+    return done;
+}
+
+/**
+ * @brief Write a range from the host, and return when all of it is received.
+ */
+static unsigned long long SimHostWrite(unsigned int dstLba, unsigned int nlb, unsigned long long ready)
+{
+    unsigned long long done, coreDone, dmaReady;
+    unsigned int lba, blocks, hit;
+
+    coreDone = SimUse(&sim.core, ready, SIM_NS(SIM_CMD_TIME));
+    done     = coreDone;
+    for (lba = dstLba; lba < dstLba + nlb; lba += blocks)
+    {
+        blocks   = SimBlocksInSlice(lba, dstLba + nlb);
+        coreDone = SimUse(&sim.core, coreDone, SIM_NS(SIM_SLICE_REQ_TIME));
+        dmaReady = SimAllocateDstSlice(lba / NVME_BLOCKS_PER_SLICE, coreDone, &hit);
+
+        // for read modify write
+        if (!hit && (blocks != NVME_BLOCKS_PER_SLICE))
+            dmaReady = SimNandRead(lba / NVME_BLOCKS_PER_SLICE, dmaReady);
+        sim.dstReady = SimXfer(&sim.rx, blocks, SimMax(dmaReady, sim.dstReady));
+        done         = SimMax(done, sim.dstReady);
+    }
+    sim.pcieBytes += SIM_CMD_BYTES;
+
+    return done;
+}
+
+/**
+ * @brief Copy a source range inside the device, like `ReqTransCopySliceToLowLevel()`.
+ *
+ * @return when the data of the range is in the destination entries, and when the core is
+ * done with the range, via `coreDone`.
+ */
+static unsigned long long SimDeviceCopy(unsigned int srcLba, unsigned int dstLba, unsigned int nlb,
+                                        unsigned long long *coreDone)
+{
+    unsigned long long done, dstReady, srcReady;
+    unsigned int blocks, hit;
+
+    done = *coreDone;
+    while (nlb)
+    {
+        blocks = SimBlocksInSlice(srcLba, srcLba + nlb);
+        blocks = SimBlocksInSlice(dstLba, dstLba + blocks);
+
+        *coreDone = SimUse(&sim.core, *coreDone, SIM_NS(SIM_SLICE_REQ_TIME));
+        dstReady  = SimAllocateDstSlice(dstLba / NVME_BLOCKS_PER_SLICE, *coreDone, &hit);
+        if (!hit && (blocks != NVME_BLOCKS_PER_SLICE))
+            dstReady = SimNandRead(dstLba / NVME_BLOCKS_PER_SLICE, dstReady);
+        dstReady = SimMax(dstReady, sim.dstReady);
+
+        if ((blocks == NVME_BLOCKS_PER_SLICE) && (sim.srcLsa != srcLba / NVME_BLOCKS_PER_SLICE))
+            sim.dstReady = SimNandRead(srcLba / NVME_BLOCKS_PER_SLICE, dstReady);
+        else
+        {
+            if (sim.srcLsa != srcLba / NVME_BLOCKS_PER_SLICE)
+            {
+                sim.srcLsa   = srcLba / NVME_BLOCKS_PER_SLICE;
+                sim.srcReady = SimNandRead(sim.srcLsa, *coreDone);
+            }
+
+            // `SyncDataBufReqDone()` on both entries holds the core until the reads are done
+            srcReady     = SimMax(sim.srcReady, dstReady);
+            sim.dstReady = SimUse(&sim.core, *coreDone, srcReady - *coreDone + SIM_NS(SIM_MEMCPY_TIME) * blocks);
+            *coreDone    = sim.dstReady;
+        }
+        done = SimMax(done, sim.dstReady);
+
+        srcLba += blocks;
+        dstLba += blocks;
+        nlb -= blocks;
+    }
+
+    return done;
+}
+
+/**
+ * @brief Copy the specified megabytes with the specified path, and print the results.
+ */
+static void SimRun(const SIM_WORKLOAD *workload, unsigned int path, unsigned int megabytes)
+{
+    unsigned long long copyBlocks, ready, done, coreDone;
+    unsigned int iCmd, iRange, rangesPerCmd, dstLba, srcLba, srcSlices;
+
+    memset(&sim, 0, sizeof(sim));
+    sim.dstLsa = SIM_NONE;
+    sim.srcLsa = SIM_NONE;
+    coreDone   = 0;
+
+    copyBlocks   = (unsigned long long)megabytes * 1024 * 1024 / BYTES_PER_NVME_BLOCK;
+    srcSlices    = SLICES_PER_SSD / 2;
+    rangesPerCmd = COPY_MAX_LENGTH / workload->rangeBlocks;
+    if (rangesPerCmd > COPY_MAX_SOURCE_RANGES)
+        rangesPerCmd = COPY_MAX_SOURCE_RANGES;
+    if (path == SIM_PATH_HOST)
+        rangesPerCmd = 1;
+
+    dstLba = srcSlices * NVME_BLOCKS_PER_SLICE;
+    for (iCmd = 0; (unsigned long long)iCmd * rangesPerCmd * workload->rangeBlocks < copyBlocks; iCmd++)
+    {
+        ready = (iCmd >= SIM_QUEUE_DEPTH) ? sim.cmdDone[iCmd % SIM_QUEUE_DEPTH] : 0;
+        done  = ready;
+        if (path == SIM_PATH_DEVICE)
+        {
+            // the source range entries are fetched by a direct DMA
+            coreDone = SimUse(&sim.core, ready, SIM_NS(SIM_CMD_TIME));
+            sim.pcieBytes += SIM_CMD_BYTES + rangesPerCmd * SIM_RANGE_BYTES;
+        }
+
+        for (iRange = 0; iRange < rangesPerCmd; iRange++)
+        {
+            srcLba = SimRandom() % (srcSlices - COPY_MAX_RANGE_LENGTH / NVME_BLOCKS_PER_SLICE);
+            srcLba *= NVME_BLOCKS_PER_SLICE;
+            if (!workload->aligned)
+                srcLba += 1 + SimRandom() % (NVME_BLOCKS_PER_SLICE - 1);
+
+            if (path == SIM_PATH_HOST)
+                done = SimHostWrite(dstLba, workload->rangeBlocks,
+                                    SimHostRead(srcLba, workload->rangeBlocks, ready) + SIM_NS(SIM_HOST_TIME));
+            else
+                done = SimMax(done, SimDeviceCopy(srcLba, dstLba, workload->rangeBlocks, &coreDone));
+            dstLba += workload->rangeBlocks;
+        }
+        sim.cmdDone[iCmd % SIM_QUEUE_DEPTH] = done;
+    }
+    SimEvictDstSlice();
+
+    printf("%-22s %-12s %9.1f %10.2f %8.1f%% %8.1f%%\n", workload->name, simPathName[path],
+           megabytes * 1e9 / sim.endTime, (double)sim.pcieBytes / ((double)megabytes * 1024 * 1024),
+           100.0 * (sim.tx.busyTime + sim.rx.busyTime) / (2 * sim.endTime),
+           100.0 * sim.core.busyTime / sim.endTime);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int megabytes, iArg, iWorkload, path;
+
+    megabytes = SIM_DEFAULT_MEGABYTES;
+    for (iArg = 1; iArg < (unsigned int)argc; iArg++)
+        if (!strcmp(argv[iArg], "-m") && (iArg + 1 < (unsigned int)argc))
+            megabytes = (unsigned int)atoi(argv[++iArg]);
+    if (!megabytes || (megabytes > SLICES_PER_SSD / 4 / (1024 * 1024 / BYTES_PER_DATA_REGION_OF_SLICE)))
+    {
+        printf("usage: %s [-m megabytes]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%u dies, %u MB copied, queue depth %u:\n", USER_DIES, megabytes, SIM_QUEUE_DEPTH);
+    printf("%-22s %-12s %9s %10s %9s %9s\n", "", "", "MB/s", "PCIe B/B", "link", "core");
+    for (iWorkload = 0; iWorkload < sizeof(simWorkload) / sizeof(simWorkload[0]); iWorkload++)
+        for (path = 0; path < SIM_PATH_COUNT; path++)
+            SimRun(&simWorkload[iWorkload], path, megabytes);
+
+    return 0;
+}
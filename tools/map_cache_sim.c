@@ -0,0 +1,301 @@
+//////////////////////////////////////////////////////////////////////////////////
+// map_cache_sim.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Map Cache Simulation
+// File Name: map_cache_sim.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - host-side model of the map cache of the DFTL mode (`SUPPORT_DFTL`)
+//   - report the hit rate and the throughput of random 16KB I/O against the DRAM
+//     spent on the cache, i.e. against `MAP_CACHE_ENTRY_COUNT`
+//
+// Build and run on the host, from the root of the repository:
+//
+//   gcc -std=c99 -O2 -DHOST_DEBUG -Ibsp -IToshiba-8c8w -IToshiba-8c8w/nvme
+//       tools/map_cache_sim.c -o map_cache_sim
+//   ./map_cache_sim [-f footprint percent] [-n lookups]
+//
+// The cache follows the policy of `map_cache.c`: a LRU list of map segments, a miss
+// evicts the LRU entry and reads the translation page synchronously, and a dirty LRU
+// entry is written back together with up to `MAP_CACHE_FLUSH_BATCH` dirty entries of the
+// LRU half, then waited for. The segments are assumed to be fragmented by the random
+// writes, so the extents never serve a lookup, check `map_extent.h`. The sizes that do
+// not fit below `COMPLETE_FLAG_TABLE_ADDR` are marked, since they need another region.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory_map.h"
+
+/*
+ * The typical timing of a MLC die, not measured on the board, same as `write_throttle_sim.c`.
+ * The host I/O is striped over all the dies, so a slice costs a die operation divided by
+ * `USER_DIES`, but no less than its transfer over the host link. A translation page is read
+ * or written while the main loop waits for it, so its whole latency is added, and the
+ * programs of a write-back batch overlap on the dies.
+ */
+#define SIM_READ_TIME 60   // in us, a page read and transfer
+#define SIM_PROG_TIME 1300 // in us, a page program
+#define SIM_XFER_TIME 5    // in us, a slice over the PCIe Gen2 x8 link of the board
+
+#define SIM_DEFAULT_FOOTPRINT_PERCENT 100
+#define SIM_DEFAULT_LOOKUPS           4000000
+#define SIM_HOT_ACCESS_PERCENT        80 // the hot-spot workload sends 80% of the I/O to 20% of the footprint
+#define SIM_HOT_DATA_PERCENT          20
+
+#define SIM_MAX_ENTRY_COUNT 8192
+#define SIM_NONE            0xffffffff
+
+typedef struct _SIM_WORKLOAD
+{
+    const char *name;
+    unsigned int writePercent;
+    unsigned int hotSpot; // whether `SIM_HOT_ACCESS_PERCENT` of the I/O goes to the hot data
+} SIM_WORKLOAD;
+
+static const SIM_WORKLOAD simWorkload[] = {
+    {"random read", 0, 0},     {"random write", 100, 0},   {"random 70/30", 30, 0},
+    {"hot-spot read", 0, 1},   {"hot-spot write", 100, 1}, {"hot-spot 70/30", 30, 1},
+};
+
+static const unsigned int simEntryCnt[] = {64, 128, 256, 512, 1024, 2048, 4096, SIM_MAX_ENTRY_COUNT};
+
+/**
+ * @brief The simulated map cache, linked in LRU order like `MAP_CACHE`.
+ */
+static struct
+{
+    unsigned int entryCnt;
+    unsigned int segment[SIM_MAX_ENTRY_COUNT]; // the cached segment of each entry, `SIM_NONE` if empty
+    unsigned char dirty[SIM_MAX_ENTRY_COUNT];
+    unsigned int prevEntry[SIM_MAX_ENTRY_COUNT];
+    unsigned int nextEntry[SIM_MAX_ENTRY_COUNT];
+    unsigned int segmentEntry[MAP_SEGMENTS_PER_SSD];
+    unsigned int headEntry, tailEntry;
+    unsigned long long hitCnt, missCnt, flushCnt, flushBatchCnt;
+} sim;
+
+static unsigned int SimRandom()
+{
+    static unsigned long long seed = 0x2545f4914f6cdd1dULL;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (unsigned int)seed;
+}
+
+static void SimReset(unsigned int entryCnt)
+{
+    unsigned int iEntry, segment;
+
+    memset(&sim, 0, sizeof(sim));
+    sim.entryCnt = entryCnt;
+    for (iEntry = 0; iEntry < entryCnt; iEntry++)
+    {
+        sim.segment[iEntry]   = SIM_NONE;
+        sim.prevEntry[iEntry] = iEntry ? iEntry - 1 : SIM_NONE;
+        sim.nextEntry[iEntry] = (iEntry + 1 < entryCnt) ? iEntry + 1 : SIM_NONE;
+    }
+    sim.headEntry = 0;
+    sim.tailEntry = entryCnt - 1;
+
+    for (segment = 0; segment < MAP_SEGMENTS_PER_SSD; segment++)
+        sim.segmentEntry[segment] = SIM_NONE;
+}
+
+/**
+ * @brief Move the specified entry to the head (MRU), like `TouchMapCacheEntry()`.
+ */
+static void SimTouch(unsigned int iEntry)
+{
+    unsigned int prevEntry = sim.prevEntry[iEntry];
+    unsigned int nextEntry = sim.nextEntry[iEntry];
+
+    if (iEntry == sim.headEntry)
+        return;
+
+    sim.nextEntry[prevEntry] = nextEntry;
+    if (nextEntry != SIM_NONE)
+        sim.prevEntry[nextEntry] = prevEntry;
+    else
+        sim.tailEntry = prevEntry;
+
+    sim.prevEntry[iEntry]        = SIM_NONE;
+    sim.nextEntry[iEntry]        = sim.headEntry;
+    sim.prevEntry[sim.headEntry] = iEntry;
+    sim.headEntry                = iEntry;
+}
+
+/**
+ * @brief Write back the dirty entries of the LRU half, like `FlushMapCacheFromTail()`.
+ */
+static void SimFlush()
+{
+    unsigned int iEntry, scanCnt, flushCnt;
+
+    iEntry   = sim.tailEntry;
+    flushCnt = 0;
+    for (scanCnt = 0; (scanCnt < sim.entryCnt / 2) && (flushCnt < MAP_CACHE_FLUSH_BATCH); scanCnt++)
+    {
+        if ((sim.segment[iEntry] != SIM_NONE) && sim.dirty[iEntry])
+        {
+            sim.dirty[iEntry] = 0;
+            flushCnt++;
+        }
+        iEntry = sim.prevEntry[iEntry];
+    }
+
+    sim.flushCnt += flushCnt;
+    sim.flushBatchCnt++;
+}
+
+/**
+ * @brief Look up the segment of a logical slice, like `LoadMapSegment()`.
+ */
+static void SimLookup(unsigned int logicalSliceAddr, unsigned int write)
+{
+    unsigned int segment = logicalSliceAddr / SLICES_PER_MAP_SEGMENT;
+    unsigned int iEntry  = sim.segmentEntry[segment];
+
+    if (iEntry != SIM_NONE)
+        sim.hitCnt++;
+    else
+    {
+        sim.missCnt++;
+        iEntry = sim.tailEntry;
+        if (sim.dirty[iEntry])
+            SimFlush();
+        if (sim.segment[iEntry] != SIM_NONE)
+            sim.segmentEntry[sim.segment[iEntry]] = SIM_NONE;
+        sim.segment[iEntry]       = segment;
+        sim.segmentEntry[segment] = iEntry;
+    }
+
+    SimTouch(iEntry);
+    if (write)
+        sim.dirty[iEntry] = 1;
+}
+
+static unsigned int SimNextLsa(const SIM_WORKLOAD *workload, unsigned int footprint)
+{
+    unsigned int hotFootprint = (unsigned int)((unsigned long long)footprint * SIM_HOT_DATA_PERCENT / 100);
+
+    if (!workload->hotSpot)
+        return SimRandom() % footprint;
+    if (SimRandom() % 100 < SIM_HOT_ACCESS_PERCENT)
+        return SimRandom() % hotFootprint;
+    return hotFootprint + SimRandom() % (footprint - hotFootprint);
+}
+
+/**
+ * @brief Run a workload against a cache size, after the same number of lookups to warm it up.
+ */
+static void SimRun(const SIM_WORKLOAD *workload, unsigned int entryCnt, unsigned int footprint,
+                   unsigned int lookups, unsigned int fitEntryCnt)
+{
+    unsigned long long writeCnt;
+    unsigned int iLookup, write;
+    double readTime, writeTime, hostTime, mapTime, iops;
+
+    SimReset(entryCnt);
+    for (iLookup = 0; iLookup < lookups; iLookup++)
+        SimLookup(SimNextLsa(workload, footprint), SimRandom() % 100 < workload->writePercent);
+
+    sim.hitCnt        = 0;
+    sim.missCnt       = 0;
+    sim.flushCnt      = 0;
+    sim.flushBatchCnt = 0;
+    writeCnt          = 0;
+    for (iLookup = 0; iLookup < lookups; iLookup++)
+    {
+        write = SimRandom() % 100 < workload->writePercent;
+        writeCnt += write;
+        SimLookup(SimNextLsa(workload, footprint), write);
+    }
+
+    // all in us, the DRAM mode takes `hostTime` only
+    readTime  = (double)SIM_READ_TIME / USER_DIES;
+    writeTime = (double)SIM_PROG_TIME / USER_DIES;
+    readTime  = (readTime > SIM_XFER_TIME) ? readTime : SIM_XFER_TIME;
+    writeTime = (writeTime > SIM_XFER_TIME) ? writeTime : SIM_XFER_TIME;
+    hostTime  = (lookups - writeCnt) * readTime + writeCnt * writeTime;
+    mapTime   = (double)sim.missCnt * SIM_READ_TIME + (double)sim.flushBatchCnt * SIM_PROG_TIME;
+    iops      = lookups / (hostTime + mapTime) * 1000000;
+
+    printf("  %4u entries %6.1f MB%s  hit %5.1f%%  %7.0f IOPS %6.0f MB/s  %5.1f%% of the DRAM mode  %.2f\n",
+           entryCnt, (double)entryCnt * BYTES_PER_MAP_CACHE_ENTRY / (1024 * 1024),
+           (entryCnt > fitEntryCnt) ? "*" : " ", (double)sim.hitCnt / lookups * 100, iops,
+           iops * BYTES_PER_DATA_REGION_OF_SLICE / (1024 * 1024), hostTime / (hostTime + mapTime) * 100,
+           writeCnt ? (double)sim.flushCnt / writeCnt : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int footprintPercent, lookups, footprint, fitEntryCnt, iArg, iWorkload, iSize;
+
+    footprintPercent = SIM_DEFAULT_FOOTPRINT_PERCENT;
+    lookups          = SIM_DEFAULT_LOOKUPS;
+    for (iArg = 1; iArg < (unsigned int)argc; iArg++)
+    {
+        if (!strcmp(argv[iArg], "-f") && (iArg + 1 < (unsigned int)argc))
+            footprintPercent = (unsigned int)atoi(argv[++iArg]);
+        else if (!strcmp(argv[iArg], "-n") && (iArg + 1 < (unsigned int)argc))
+            lookups = (unsigned int)atoi(argv[++iArg]);
+    }
+    if (!lookups || !footprintPercent || (footprintPercent > 100))
+    {
+        printf("usage: %s [-f footprint percent] [-n lookups]\n", argv[0]);
+        return 2;
+    }
+
+    footprint   = (unsigned int)((unsigned long long)SLICES_PER_SSD * footprintPercent / 100);
+    fitEntryCnt = (COMPLETE_FLAG_TABLE_ADDR - MAP_CACHE_BASE_ADDR) / BYTES_PER_MAP_CACHE_ENTRY;
+
+    printf("%u map segments of %u KB, random 16KB I/O over %u GB (%u%% of the logical space), %u lookups\n",
+           (unsigned int)MAP_SEGMENTS_PER_SSD, (unsigned int)BYTES_PER_MAP_SEGMENT / 1024,
+           (unsigned int)((unsigned long long)footprint * BYTES_PER_DATA_REGION_OF_SLICE >> 30), footprintPercent,
+           lookups);
+    printf("* does not fit below `COMPLETE_FLAG_TABLE_ADDR`, at most %u entries\n", fitEntryCnt);
+    printf("the last column is the translation pages written per host write\n");
+
+    for (iWorkload = 0; iWorkload < sizeof(simWorkload) / sizeof(simWorkload[0]); iWorkload++)
+    {
+        printf("%s:\n", simWorkload[iWorkload].name);
+        for (iSize = 0; iSize < sizeof(simEntryCnt) / sizeof(simEntryCnt[0]); iSize++)
+            SimRun(&simWorkload[iWorkload], simEntryCnt[iSize], footprint, lookups, fitEntryCnt);
+    }
+
+    return 0;
+}
@@ -0,0 +1,556 @@
+//////////////////////////////////////////////////////////////////////////////////
+// vblock_layout_sim.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Virtual Block Map Layout Simulation
+// File Name: vblock_layout_sim.c
+//
+// Version: v1.1.0
+//
+// Description:
+//   - host-side microbenchmark of the layout of `VIRTUAL_BLOCK_MAP`
+//   - replay the block list operations of the FTL through a model of the L1 data cache of
+//     the Cortex-A9 (32KB, 4-way, 32B lines, LRU) and report the misses per operation
+//
+// Build and run on the host, from the root of the repository:
+//
+//   gcc -std=c99 -O2 -DHOST_DEBUG -Ibsp -IToshiba-8c8w -IToshiba-8c8w/nvme
+//       tools/vblock_layout_sim.c -o vblock_layout_sim
+//   ./vblock_layout_sim [-n writes]
+//
+// Four layouts are compared: the 12-byte bitfield entry of the original firmware, a
+// separate array per field, an 8-byte list entry plus dense arrays of the current pages and
+// the erase counts, and the current layout, i.e. the original entry with only the erase
+// counts moved to a dense array, check `VIRTUAL_BLOCK_MAP`.
+//
+// The operations follow `InvalidateOldVsa()`, `GetFromGcVictimList()`, `GetFromFbList()`,
+// `PutToFbList()` and `FindFreeVirtualSlice()` access by access, and also touch the logical
+// slice map, the valid bitmaps, the victim lists and the die map, which compete for the
+// same cache. The workload is random 16KB writes striped over all the dies, starting with
+// half of the blocks in the victim lists and half free, and a die is collected whenever
+// it runs below half of its blocks free. The copies of the valid slices are not modeled
+// beyond their current page updates.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//
+// * v1.1.0
+//   - Add the current layout, the original entry with a dense array of the erase counts
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory_map.h"
+
+#define SIM_CACHE_BYTES 32768
+#define SIM_CACHE_WAYS  4
+#define SIM_LINE_BYTES  32
+#define SIM_CACHE_SETS  (SIM_CACHE_BYTES / SIM_CACHE_WAYS / SIM_LINE_BYTES)
+
+#define SIM_BLOCKS             (USER_DIES * USER_BLOCKS_PER_DIE)
+#define SIM_DEFAULT_WRITES     4000000
+#define SIM_WARM_UP_PERCENT    50 // the writes before the misses are counted
+#define SIM_INIT_INVALID_LIMIT (SLICES_PER_BLOCK / 2)
+
+#define SIM_LAYOUT_BITFIELD 0 // the 12-byte entry of the original firmware
+#define SIM_LAYOUT_SOA      1 // an array per field
+#define SIM_LAYOUT_SPLIT    2 // an 8-byte list entry, dense current pages and erase counts
+#define SIM_LAYOUT_CURRENT  3 // the current `VIRTUAL_BLOCK_MAP`
+#define SIM_LAYOUT_COUNT    4
+
+#define SIM_FIELD_BAD          0
+#define SIM_FIELD_FREE         1
+#define SIM_FIELD_INVALID_CNT  2
+#define SIM_FIELD_PREV         3
+#define SIM_FIELD_NEXT         4
+#define SIM_FIELD_CURRENT_PAGE 5
+#define SIM_FIELD_ERASE_CNT    6
+#define SIM_FIELD_COUNT        7
+
+#define SIM_OP_INVALIDATE     0
+#define SIM_OP_GET_VICTIM     1
+#define SIM_OP_GET_FREE_BLOCK 2
+#define SIM_OP_PUT_FREE_BLOCK 3
+#define SIM_OP_COUNT          4
+
+/*
+ * The regions of the simulated address space, far enough apart not to overlap. The block
+ * map is the only region whose layout changes.
+ */
+#define SIM_BLOCK_MAP_BASE    0x10000000ULL
+#define SIM_L2V_MAP_BASE      0x20000000ULL
+#define SIM_VALID_BITMAP_BASE 0x40000000ULL
+#define SIM_VICTIM_LIST_BASE  0x50000000ULL
+#define SIM_DIE_MAP_BASE      0x51000000ULL
+#define SIM_VICTIM_BLOCK_BASE 0x52000000ULL
+
+static const char *simLayoutName[SIM_LAYOUT_COUNT] = {"12B bitfield entry", "per-field SoA", "8B entry + 2 arrays",
+                                                      "current layout"};
+static const char *simOpName[SIM_OP_COUNT]         = {"InvalidateOldVsa", "GetFromGcVictimList", "GetFromFbList",
+                                                      "PutToFbList"};
+
+/**
+ * @brief The simulated L1 data cache, and the op the misses are charged to.
+ */
+static struct
+{
+    unsigned long long tag[SIM_CACHE_SETS][SIM_CACHE_WAYS];
+    unsigned long long lastUse[SIM_CACHE_SETS][SIM_CACHE_WAYS];
+    unsigned long long now;
+    unsigned long long missCnt;
+} cache;
+
+/**
+ * @brief The simulated FTL metadata, the values are kept apart from the simulated addresses.
+ */
+static struct
+{
+    unsigned int layout;
+    unsigned int field[SIM_FIELD_COUNT][SIM_BLOCKS];
+    unsigned int headVictim[USER_DIES][SLICES_PER_BLOCK + 1];
+    unsigned int tailVictim[USER_DIES][SLICES_PER_BLOCK + 1];
+    unsigned int headFree[USER_DIES], tailFree[USER_DIES], freeCnt[USER_DIES];
+    unsigned int currentBlock[USER_DIES];
+    unsigned long long opCnt[SIM_OP_COUNT], opMissCnt[SIM_OP_COUNT];
+} sim;
+
+static unsigned int SimRandom()
+{
+    static unsigned long long seed = 0x2545f4914f6cdd1dULL;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (unsigned int)seed;
+}
+
+static void SimTouch(unsigned long long addr, unsigned int size)
+{
+    unsigned long long line, lastLine;
+    unsigned int set, way, lruWay;
+
+    lastLine = (addr + size - 1) / SIM_LINE_BYTES;
+    for (line = addr / SIM_LINE_BYTES; line <= lastLine; line++)
+    {
+        set    = (unsigned int)(line % SIM_CACHE_SETS);
+        lruWay = 0;
+        for (way = 0; way < SIM_CACHE_WAYS; way++)
+        {
+            if (cache.tag[set][way] == line + 1)
+                break;
+            if (cache.lastUse[set][way] < cache.lastUse[set][lruWay])
+                lruWay = way;
+        }
+        if (way == SIM_CACHE_WAYS)
+        {
+            way                 = lruWay;
+            cache.tag[set][way] = line + 1;
+            cache.missCnt++;
+        }
+        cache.lastUse[set][way] = ++cache.now;
+    }
+}
+
+/**
+ * @brief Touch a field of the block map at its address in the simulated layout.
+ */
+static void SimTouchField(unsigned int field, unsigned int block)
+{
+    static const unsigned int bitfieldWord[SIM_FIELD_COUNT] = {0, 0, 0, 2, 2, 1, 1};
+    static const unsigned int soaBytes[SIM_FIELD_COUNT]     = {1, 1, 2, 2, 2, 2, 2};
+    static const unsigned int splitOffset[SIM_FIELD_COUNT]  = {6, 6, 0, 2, 4, 0, 0};
+    unsigned long long base;
+    unsigned int iField;
+
+    if ((sim.layout == SIM_LAYOUT_CURRENT) && (field == SIM_FIELD_ERASE_CNT))
+        SimTouch(SIM_BLOCK_MAP_BASE + SIM_BLOCKS * 12ULL + block * 2ULL, 2);
+    else if ((sim.layout == SIM_LAYOUT_BITFIELD) || (sim.layout == SIM_LAYOUT_CURRENT))
+        SimTouch(SIM_BLOCK_MAP_BASE + block * 12ULL + bitfieldWord[field] * 4, 4);
+    else if (sim.layout == SIM_LAYOUT_SOA)
+    {
+        base = SIM_BLOCK_MAP_BASE;
+        for (iField = 0; iField < field; iField++)
+            base += (unsigned long long)SIM_BLOCKS * soaBytes[iField];
+        SimTouch(base + (unsigned long long)block * soaBytes[field], soaBytes[field]);
+    }
+    else if (field == SIM_FIELD_CURRENT_PAGE)
+        SimTouch(SIM_BLOCK_MAP_BASE + SIM_BLOCKS * 8ULL + block * 2ULL, 2);
+    else if (field == SIM_FIELD_ERASE_CNT)
+        SimTouch(SIM_BLOCK_MAP_BASE + SIM_BLOCKS * 10ULL + block * 2ULL, 2);
+    else
+        SimTouch(SIM_BLOCK_MAP_BASE + block * 8ULL + splitOffset[field], 2);
+}
+
+static unsigned int SimGet(unsigned int field, unsigned int dieNo, unsigned int blockNo)
+{
+    unsigned int block = dieNo * USER_BLOCKS_PER_DIE + blockNo;
+
+    SimTouchField(field, block);
+    return sim.field[field][block];
+}
+
+static void SimSet(unsigned int field, unsigned int dieNo, unsigned int blockNo, unsigned int value)
+{
+    unsigned int block = dieNo * USER_BLOCKS_PER_DIE + blockNo;
+
+    SimTouchField(field, block);
+    sim.field[field][block] = value;
+}
+
+static void SimTouchVictimList(unsigned int dieNo, unsigned int invalidSliceCnt)
+{
+    SimTouch(SIM_VICTIM_LIST_BASE + (dieNo * (SLICES_PER_BLOCK + 1ULL) + invalidSliceCnt) * 4, 4);
+}
+
+static void SimTouchDie(unsigned int dieNo) { SimTouch(SIM_DIE_MAP_BASE + dieNo * 12ULL, 12); }
+
+/**
+ * @brief Same accesses as `PutToGcVictimList()`.
+ */
+static void SimPutToGcVictimList(unsigned int dieNo, unsigned int blockNo, unsigned int invalidSliceCnt)
+{
+    unsigned int tailBlock = sim.tailVictim[dieNo][invalidSliceCnt];
+
+    SimTouchVictimList(dieNo, invalidSliceCnt);
+    SimSet(SIM_FIELD_PREV, dieNo, blockNo, tailBlock);
+    SimSet(SIM_FIELD_NEXT, dieNo, blockNo, BLOCK_NONE);
+    if (tailBlock != BLOCK_NONE)
+        SimSet(SIM_FIELD_NEXT, dieNo, tailBlock, blockNo);
+    else
+        sim.headVictim[dieNo][invalidSliceCnt] = blockNo;
+    sim.tailVictim[dieNo][invalidSliceCnt] = blockNo;
+}
+
+/**
+ * @brief Same accesses as `SelectiveGetFromGcVictimList()`.
+ */
+static void SimSelectiveGetFromGcVictimList(unsigned int dieNo, unsigned int blockNo)
+{
+    unsigned int nextBlock       = SimGet(SIM_FIELD_NEXT, dieNo, blockNo);
+    unsigned int prevBlock       = SimGet(SIM_FIELD_PREV, dieNo, blockNo);
+    unsigned int invalidSliceCnt = SimGet(SIM_FIELD_INVALID_CNT, dieNo, blockNo);
+
+    if (prevBlock != BLOCK_NONE)
+        SimSet(SIM_FIELD_NEXT, dieNo, prevBlock, nextBlock);
+    if (nextBlock != BLOCK_NONE)
+        SimSet(SIM_FIELD_PREV, dieNo, nextBlock, prevBlock);
+    if ((prevBlock == BLOCK_NONE) || (nextBlock == BLOCK_NONE))
+        SimTouchVictimList(dieNo, invalidSliceCnt);
+    if (prevBlock == BLOCK_NONE)
+        sim.headVictim[dieNo][invalidSliceCnt] = nextBlock;
+    if (nextBlock == BLOCK_NONE)
+        sim.tailVictim[dieNo][invalidSliceCnt] = prevBlock;
+}
+
+/**
+ * @brief Same accesses as `GetFromGcVictimList()`.
+ */
+static unsigned int SimGetFromGcVictimList(unsigned int dieNo)
+{
+    unsigned int invalidSliceCnt, blockNo, nextBlock;
+
+    for (invalidSliceCnt = SLICES_PER_BLOCK; invalidSliceCnt > 0; invalidSliceCnt--)
+    {
+        SimTouchVictimList(dieNo, invalidSliceCnt);
+        blockNo = sim.headVictim[dieNo][invalidSliceCnt];
+        if (blockNo == BLOCK_NONE)
+            continue;
+
+        nextBlock = SimGet(SIM_FIELD_NEXT, dieNo, blockNo);
+        if (nextBlock != BLOCK_NONE)
+            SimSet(SIM_FIELD_PREV, dieNo, nextBlock, BLOCK_NONE);
+        else
+            sim.tailVictim[dieNo][invalidSliceCnt] = BLOCK_NONE;
+        sim.headVictim[dieNo][invalidSliceCnt] = nextBlock;
+        return blockNo;
+    }
+
+    return BLOCK_NONE;
+}
+
+/**
+ * @brief Same accesses as `PutToFbList()`, sorted by the erase counts.
+ */
+static void SimPutToFbList(unsigned int dieNo, unsigned int blockNo)
+{
+    unsigned int prevBlock, nextBlock, eraseCnt;
+
+    SimTouchDie(dieNo);
+    eraseCnt  = SimGet(SIM_FIELD_ERASE_CNT, dieNo, blockNo);
+    prevBlock = sim.tailFree[dieNo];
+    while ((prevBlock != BLOCK_NONE) && (SimGet(SIM_FIELD_ERASE_CNT, dieNo, prevBlock) > eraseCnt))
+        prevBlock = SimGet(SIM_FIELD_PREV, dieNo, prevBlock);
+
+    if (prevBlock != BLOCK_NONE)
+    {
+        nextBlock = SimGet(SIM_FIELD_NEXT, dieNo, prevBlock);
+        SimSet(SIM_FIELD_NEXT, dieNo, prevBlock, blockNo);
+    }
+    else
+    {
+        nextBlock           = sim.headFree[dieNo];
+        sim.headFree[dieNo] = blockNo;
+    }
+
+    if (nextBlock != BLOCK_NONE)
+        SimSet(SIM_FIELD_PREV, dieNo, nextBlock, blockNo);
+    else
+        sim.tailFree[dieNo] = blockNo;
+
+    SimSet(SIM_FIELD_PREV, dieNo, blockNo, prevBlock);
+    SimSet(SIM_FIELD_NEXT, dieNo, blockNo, nextBlock);
+    sim.freeCnt[dieNo]++;
+}
+
+/**
+ * @brief Same accesses as `GetFromFbList()`.
+ */
+static unsigned int SimGetFromFbList(unsigned int dieNo)
+{
+    unsigned int blockNo, nextBlock;
+
+    SimTouchDie(dieNo);
+    blockNo   = sim.headFree[dieNo];
+    nextBlock = SimGet(SIM_FIELD_NEXT, dieNo, blockNo);
+    if (nextBlock != BLOCK_NONE)
+        SimSet(SIM_FIELD_PREV, dieNo, nextBlock, BLOCK_NONE);
+    else
+        sim.tailFree[dieNo] = BLOCK_NONE;
+    sim.headFree[dieNo] = nextBlock;
+
+    SimSet(SIM_FIELD_FREE, dieNo, blockNo, 0);
+    SimSet(SIM_FIELD_NEXT, dieNo, blockNo, BLOCK_NONE);
+    SimSet(SIM_FIELD_PREV, dieNo, blockNo, BLOCK_NONE);
+    sim.freeCnt[dieNo]--;
+
+    return blockNo;
+}
+
+/**
+ * @brief Same accesses as `InvalidateOldVsa()` on a slice of the specified block.
+ */
+static void SimInvalidateOldVsa(unsigned int dieNo, unsigned int blockNo)
+{
+    unsigned int block = dieNo * USER_BLOCKS_PER_DIE + blockNo;
+    unsigned int invalidSliceCnt;
+
+    SimTouch(SIM_L2V_MAP_BASE + (SimRandom() % SLICES_PER_SSD) * 4ULL, 4); // `GetMappedVsa()`
+    SimTouch(SIM_VALID_BITMAP_BASE + block * (SLICES_PER_BLOCK / 8ULL) + SimRandom() % (SLICES_PER_BLOCK / 8), 4);
+    SimTouch(SIM_VICTIM_BLOCK_BASE + dieNo * 4ULL, 4);
+
+    SimSelectiveGetFromGcVictimList(dieNo, blockNo);
+    invalidSliceCnt = SimGet(SIM_FIELD_INVALID_CNT, dieNo, blockNo) + 1;
+    SimSet(SIM_FIELD_INVALID_CNT, dieNo, blockNo, invalidSliceCnt);
+    SimPutToGcVictimList(dieNo, blockNo, SimGet(SIM_FIELD_INVALID_CNT, dieNo, blockNo));
+}
+
+/**
+ * @brief Like `FindFreeVirtualSlice()`, allocate the next page of the current block of the die.
+ */
+static void SimAllocateSlice(unsigned int dieNo, unsigned int measured)
+{
+    unsigned long long missCnt = cache.missCnt;
+    unsigned int currentPage;
+
+    SimTouchDie(dieNo);
+    currentPage = SimGet(SIM_FIELD_CURRENT_PAGE, dieNo, sim.currentBlock[dieNo]);
+    if (currentPage == USER_PAGES_PER_BLOCK)
+    {
+        sim.currentBlock[dieNo] = SimGetFromFbList(dieNo);
+        currentPage             = SimGet(SIM_FIELD_CURRENT_PAGE, dieNo, sim.currentBlock[dieNo]);
+        if (measured)
+        {
+            sim.opCnt[SIM_OP_GET_FREE_BLOCK]++;
+            sim.opMissCnt[SIM_OP_GET_FREE_BLOCK] += cache.missCnt - missCnt;
+        }
+    }
+    SimSet(SIM_FIELD_CURRENT_PAGE, dieNo, sim.currentBlock[dieNo], currentPage + 1);
+}
+
+/**
+ * @brief Collect the block with the most invalid slices, like `GarbageCollection()`.
+ */
+static void SimGarbageCollection(unsigned int dieNo, unsigned int measured)
+{
+    unsigned long long missCnt = cache.missCnt;
+    unsigned int victimBlock, validSliceCnt;
+
+    victimBlock = SimGetFromGcVictimList(dieNo);
+    if (measured)
+    {
+        sim.opCnt[SIM_OP_GET_VICTIM]++;
+        sim.opMissCnt[SIM_OP_GET_VICTIM] += cache.missCnt - missCnt;
+    }
+    if (victimBlock == BLOCK_NONE)
+        return;
+
+    for (validSliceCnt = SLICES_PER_BLOCK - SimGet(SIM_FIELD_INVALID_CNT, dieNo, victimBlock); validSliceCnt;
+         validSliceCnt--)
+        SimAllocateSlice(dieNo, measured);
+
+    // `EraseBlock()`
+    SimSet(SIM_FIELD_FREE, dieNo, victimBlock, 1);
+    SimSet(SIM_FIELD_ERASE_CNT, dieNo, victimBlock, SimGet(SIM_FIELD_ERASE_CNT, dieNo, victimBlock) + 1);
+    SimSet(SIM_FIELD_INVALID_CNT, dieNo, victimBlock, 0);
+    SimSet(SIM_FIELD_CURRENT_PAGE, dieNo, victimBlock, 0);
+
+    missCnt = cache.missCnt;
+    SimPutToFbList(dieNo, victimBlock);
+    if (measured)
+    {
+        sim.opCnt[SIM_OP_PUT_FREE_BLOCK]++;
+        sim.opMissCnt[SIM_OP_PUT_FREE_BLOCK] += cache.missCnt - missCnt;
+    }
+}
+
+/**
+ * @brief Pick a written block of the die that still has a valid slice to overwrite.
+ */
+static unsigned int SimPickWrittenBlock(unsigned int dieNo)
+{
+    unsigned int block, blockNo;
+
+    for (;;)
+    {
+        blockNo = SimRandom() % USER_BLOCKS_PER_DIE;
+        block   = dieNo * USER_BLOCKS_PER_DIE + blockNo;
+        if (!sim.field[SIM_FIELD_FREE][block] && (blockNo != sim.currentBlock[dieNo]) &&
+            (sim.field[SIM_FIELD_INVALID_CNT][block] < SLICES_PER_BLOCK) &&
+            (sim.field[SIM_FIELD_CURRENT_PAGE][block] == USER_PAGES_PER_BLOCK))
+            return blockNo;
+    }
+}
+
+static void SimReset(unsigned int layout)
+{
+    unsigned int dieNo, blockNo, block, invalidSliceCnt;
+
+    memset(&cache, 0, sizeof(cache));
+    memset(&sim, 0, sizeof(sim));
+    sim.layout = layout;
+
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+    {
+        for (invalidSliceCnt = 0; invalidSliceCnt <= SLICES_PER_BLOCK; invalidSliceCnt++)
+        {
+            sim.headVictim[dieNo][invalidSliceCnt] = BLOCK_NONE;
+            sim.tailVictim[dieNo][invalidSliceCnt] = BLOCK_NONE;
+        }
+        sim.headFree[dieNo] = BLOCK_NONE;
+        sim.tailFree[dieNo] = BLOCK_NONE;
+        for (blockNo = 0; blockNo < USER_BLOCKS_PER_DIE; blockNo++)
+        {
+            block                                    = dieNo * USER_BLOCKS_PER_DIE + blockNo;
+            sim.field[SIM_FIELD_PREV][block]         = BLOCK_NONE;
+            sim.field[SIM_FIELD_NEXT][block]         = BLOCK_NONE;
+            sim.field[SIM_FIELD_ERASE_CNT][block]    = 1;
+            sim.field[SIM_FIELD_CURRENT_PAGE][block] = USER_PAGES_PER_BLOCK;
+
+            if (blockNo % 2)
+            {
+                sim.field[SIM_FIELD_FREE][block]         = 1;
+                sim.field[SIM_FIELD_CURRENT_PAGE][block] = 0;
+                SimPutToFbList(dieNo, blockNo);
+            }
+            else
+            {
+                sim.field[SIM_FIELD_INVALID_CNT][block] = 1 + SimRandom() % SIM_INIT_INVALID_LIMIT;
+                SimPutToGcVictimList(dieNo, blockNo, sim.field[SIM_FIELD_INVALID_CNT][block]);
+            }
+        }
+        sim.currentBlock[dieNo] = SimGetFromFbList(dieNo);
+    }
+}
+
+/**
+ * @brief Run the random writes on the specified layout and report the misses per operation.
+ */
+static void SimRun(unsigned int layout, unsigned int writes)
+{
+    unsigned long long missCnt;
+    unsigned int iWrite, dieNo, blockNo, measured, iOp;
+
+    SimReset(layout);
+    for (iWrite = 0; iWrite < writes; iWrite++)
+    {
+        dieNo    = iWrite % USER_DIES;
+        measured = iWrite >= (unsigned long long)writes * SIM_WARM_UP_PERCENT / 100;
+
+        SimAllocateSlice(dieNo, measured);
+
+        blockNo = SimPickWrittenBlock(dieNo);
+        missCnt = cache.missCnt;
+        SimInvalidateOldVsa(dieNo, blockNo);
+        if (measured)
+        {
+            sim.opCnt[SIM_OP_INVALIDATE]++;
+            sim.opMissCnt[SIM_OP_INVALIDATE] += cache.missCnt - missCnt;
+        }
+
+        if (sim.freeCnt[dieNo] < USER_BLOCKS_PER_DIE / 2)
+            SimGarbageCollection(dieNo, measured);
+    }
+
+    printf("%-20s", simLayoutName[layout]);
+    for (iOp = 0; iOp < SIM_OP_COUNT; iOp++)
+        printf("  %*.2f", (int)strlen(simOpName[iOp]), (double)sim.opMissCnt[iOp] / sim.opCnt[iOp]);
+
+    // a scan over the erase counts of all the blocks, like `GetAvgEraseCnt()`
+    missCnt = cache.missCnt;
+    for (dieNo = 0; dieNo < USER_DIES; dieNo++)
+        for (blockNo = 0; blockNo < USER_BLOCKS_PER_DIE; blockNo++)
+            SimGet(SIM_FIELD_ERASE_CNT, dieNo, blockNo);
+    printf("  %15llu\n", cache.missCnt - missCnt);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int writes, iArg, layout, iOp;
+
+    writes = SIM_DEFAULT_WRITES;
+    for (iArg = 1; iArg < (unsigned int)argc; iArg++)
+        if (!strcmp(argv[iArg], "-n") && (iArg + 1 < (unsigned int)argc))
+            writes = (unsigned int)atoi(argv[++iArg]);
+    if (!writes)
+    {
+        printf("usage: %s [-n writes]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%u dies x %u blocks, %u random writes, L1 misses per operation:\n", USER_DIES, USER_BLOCKS_PER_DIE,
+           writes);
+    printf("%-20s", "");
+    for (iOp = 0; iOp < SIM_OP_COUNT; iOp++)
+        printf("  %s", simOpName[iOp]);
+    printf("  erase count scan\n");
+
+    for (layout = 0; layout < SIM_LAYOUT_COUNT; layout++)
+        SimRun(layout, writes);
+
+    return 0;
+}
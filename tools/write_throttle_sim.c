@@ -0,0 +1,504 @@
+//////////////////////////////////////////////////////////////////////////////////
+// write_throttle_sim.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Write Throttle Simulation
+// File Name: write_throttle_sim.c
+//
+// Version: v1.1.0
+//
+// Description:
+//   - host-side steady-state test of the host write throttling
+//   - run `AdmitHostWrite()` of the firmware against a simulated die under random writes
+//   - report the per-second write IOPS and its variance with and without the throttling
+//
+// Build and run on the host, from the root of the repository:
+//
+//   gcc -std=c99 -O2 -DHOST_DEBUG -Ibsp -IToshiba-8c8w -IToshiba-8c8w/nvme
+//       tools/write_throttle_sim.c Toshiba-8c8w/write_throttle.c -lm -o write_throttle_sim
+//   ./write_throttle_sim [-s seconds] [-op percent] [-v]
+//
+// The random writes are run with and without the throttling, both from the steady state
+// (preconditioned with random writes of twice the logical capacity) and from a full drive
+// whose over-provisioning is still free, where the GC starts during the run. `-v` prints the
+// per-second IOPS of each run. The variance is measured by the coefficient of variation (cv)
+// of the per-second IOPS, over the whole run and over each window of `SIM_WINDOW_SECONDS`.
+// The exit status is 1 if the throttling raises the cv of the steady state, or if a window
+// of a throttled run has a cv above `SIM_MAX_WINDOW_CV`, so it can be used as a test, and 2
+// if the run is too short for the GC to start. The over-provisioning must be at least 7% for
+// the GC of a single die to keep up, check `GC_START_FREE_BLOCK_COUNT`.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.1.0
+//   - Bound the cv of the throttled runs over a sliding window, instead of the largest
+//     drop of the IOPS between two seconds
+//   - Reach the steady state under the same policy as the run
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory_map.h"
+
+/*
+ * The typical timing of a MLC die, not measured on the board. A die serves one operation at
+ * a time, and the GC copies to the other dies are not modeled (check `SelectDieForGcCopy()`),
+ * so the model is the worst case of a die.
+ *
+ * The random writes are striped over all the dies, so the dies are modeled in lockstep by
+ * a single die, and each of its slices stands for `SIM_STRIPE` slices of the SSD, which is
+ * the unit of the throttling.
+ */
+#define SIM_STRIPE USER_DIES
+
+#define SIM_READ_TIME  60   // in XTime counts (us), a page read and transfer
+#define SIM_PROG_TIME  1300 // in XTime counts (us), a page program
+#define SIM_ERASE_TIME 3500 // in XTime counts (us), a block erase
+#define SIM_POLL_TIME  5    // in XTime counts (us), a pass of the main loop with nothing to do
+
+#define SIM_BLOCKS                USER_BLOCKS_PER_DIE
+#define SIM_SLICES                (SIM_BLOCKS * SLICES_PER_BLOCK)
+#define SIM_DEFAULT_OP_PERCENT    10 // check `MB_PER_OVER_PROVISION_BLOCK_SPACE`
+#define SIM_DEFAULT_SECONDS       300
+#define SIM_PRECONDITION_CAPACITY 2 // the logical capacity written to reach the steady state
+#define SIM_WINDOW_SECONDS        10
+#define SIM_MAX_WINDOW_CV         0.15 // a throttled run passes if the IOPS of each window stay within it
+
+#define SIM_NONE 0xffffffff
+
+SSD_STATISTICS ssdStatistics;
+SSD_TELEMETRY ssdTelemetry;
+NAMESPACE_MAP nsMap;
+P_VIRTUAL_DIE_MAP virtualDieMapPtr;
+
+static VIRTUAL_DIE_MAP simDieMap;
+
+typedef struct _SIM_RESULT
+{
+    double cv;          // the coefficient of variation of the per-second IOPS
+    double maxWindowCv; // the largest cv of the per-second IOPS over `SIM_WINDOW_SECONDS`
+    unsigned int gcRun; // the GC erased at least one block during the run
+} SIM_RESULT;
+
+/**
+ * @brief The simulated die, only the mapping and the block usage are tracked.
+ */
+static struct
+{
+    XTime now;
+    XTime startTime;                      // when the measured run started
+    unsigned int *l2p;                    // the slice of each logical slice, `SIM_NONE` if unmapped
+    unsigned int *p2l;                    // the owner of each slice, `SIM_NONE` if invalid
+    unsigned int validCnt[SIM_BLOCKS];
+    unsigned int freeBlock[SIM_BLOCKS];   // a FIFO of the free blocks
+    unsigned int freeHead, freeTail;
+    unsigned char isFree[SIM_BLOCKS];
+    unsigned int currentBlock, currentPage;
+    unsigned int victimBlock, victimPage; // the ongoing GC, `SIM_NONE` if none
+    unsigned int logicalSliceCnt;
+    unsigned int throttled;               // whether `AdmitHostWrite()` is used
+} sim;
+
+void XTime_GetTime(XTime *xtime) { *xtime = sim.now; }
+
+static unsigned int SimRandom()
+{
+    static unsigned long long seed = 0x2545f4914f6cdd1dULL;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (unsigned int)seed;
+}
+
+static unsigned int SimGetFreeBlock()
+{
+    unsigned int blockNo = sim.freeBlock[sim.freeHead];
+
+    // the firmware asserts too, the incremental GC needs enough over-provisioning to keep up
+    if (!simDieMap.die[0].freeBlockCnt)
+    {
+        printf("the die ran out of free blocks, the over-provisioning is too small\n");
+        exit(2);
+    }
+
+    sim.freeHead        = (sim.freeHead + 1) % SIM_BLOCKS;
+    sim.isFree[blockNo] = 0;
+    simDieMap.die[0].freeBlockCnt--;
+    return blockNo;
+}
+
+static void SimPutFreeBlock(unsigned int blockNo)
+{
+    sim.freeBlock[sim.freeTail] = blockNo;
+    sim.freeTail                = (sim.freeTail + 1) % SIM_BLOCKS;
+    sim.isFree[blockNo]         = 1;
+    simDieMap.die[0].freeBlockCnt++;
+}
+
+/**
+ * @brief Program the logical slice to the current block, like `FindFreeVirtualSlice()`.
+ */
+static void SimProgram(unsigned int lsa)
+{
+    unsigned int slice;
+
+    if (sim.currentPage == SLICES_PER_BLOCK)
+    {
+        sim.currentBlock = SimGetFreeBlock();
+        sim.currentPage  = 0;
+    }
+
+    if (sim.l2p[lsa] != SIM_NONE)
+    {
+        sim.p2l[sim.l2p[lsa]] = SIM_NONE;
+        sim.validCnt[sim.l2p[lsa] / SLICES_PER_BLOCK]--;
+    }
+
+    slice          = sim.currentBlock * SLICES_PER_BLOCK + sim.currentPage++;
+    sim.l2p[lsa]   = slice;
+    sim.p2l[slice] = lsa;
+    sim.validCnt[sim.currentBlock]++;
+    sim.now += SIM_PROG_TIME;
+}
+
+/**
+ * @brief Select the block with the fewest valid slices, like `GetFromGcVictimList()`.
+ */
+static unsigned int SimSelectVictim()
+{
+    unsigned int blockNo, victimBlock;
+
+    victimBlock = SIM_NONE;
+    for (blockNo = 0; blockNo < SIM_BLOCKS; blockNo++)
+    {
+        if (sim.isFree[blockNo] || (blockNo == sim.currentBlock) || (sim.validCnt[blockNo] == SLICES_PER_BLOCK))
+            continue;
+        if ((victimBlock == SIM_NONE) || (sim.validCnt[blockNo] < sim.validCnt[victimBlock]))
+            victimBlock = blockNo;
+    }
+
+    return victimBlock;
+}
+
+/**
+ * @brief Same result as `GetGcVictimValidSliceCnt()`, from the valid slices of the blocks.
+ */
+unsigned int GetGcVictimValidSliceCnt(unsigned int dieNo, unsigned int victimCnt)
+{
+    unsigned int blockCnt[SLICES_PER_BLOCK], blockNo, validSliceCnt, foundCnt, sum;
+
+    (void)dieNo;
+    memset(blockCnt, 0, sizeof(blockCnt));
+    for (blockNo = 0; blockNo < SIM_BLOCKS; blockNo++)
+        if (!sim.isFree[blockNo] && (blockNo != sim.currentBlock) && (blockNo != sim.victimBlock) &&
+            (sim.validCnt[blockNo] < SLICES_PER_BLOCK))
+            blockCnt[sim.validCnt[blockNo]]++;
+
+    foundCnt = 0;
+    sum      = 0;
+    for (validSliceCnt = 0; (validSliceCnt < SLICES_PER_BLOCK) && (foundCnt < victimCnt); validSliceCnt++)
+        for (; blockCnt[validSliceCnt] && (foundCnt < victimCnt); blockCnt[validSliceCnt]--)
+        {
+            sum += validSliceCnt;
+            foundCnt++;
+        }
+
+    return foundCnt ? (sum / foundCnt) : SLICES_PER_BLOCK;
+}
+
+/**
+ * @brief Copy at most `GC_COPY_PAGES_PER_STEP` valid slices, like `GarbageCollectionStep()`.
+ *
+ * @return unsigned int 1 if the victim block was erased, otherwise 0.
+ */
+static unsigned int SimGcStep()
+{
+    unsigned int copiedSliceCnt, slice;
+
+    if (sim.victimBlock == SIM_NONE)
+    {
+        sim.victimBlock = SimSelectVictim();
+        sim.victimPage  = 0;
+    }
+
+    for (copiedSliceCnt = 0; sim.victimPage < SLICES_PER_BLOCK; sim.victimPage++)
+    {
+        if (copiedSliceCnt == GC_COPY_PAGES_PER_STEP)
+            return 0;
+
+        slice = sim.victimBlock * SLICES_PER_BLOCK + sim.victimPage;
+        if (sim.p2l[slice] == SIM_NONE)
+            continue;
+
+        sim.now += SIM_READ_TIME;
+        SimProgram(sim.p2l[slice]);
+        ssdStatistics.gcCopyPageCnt += SIM_STRIPE;
+        copiedSliceCnt++;
+    }
+
+    SimPutFreeBlock(sim.victimBlock);
+    sim.victimBlock = SIM_NONE;
+    sim.now += SIM_ERASE_TIME;
+    ssdStatistics.gcEraseCnt += SIM_STRIPE;
+
+    return 1;
+}
+
+/**
+ * @brief The main loop has nothing else to do, same policy as the firmware.
+ */
+void IdleGarbageCollection()
+{
+    if (sim.victimBlock != SIM_NONE)
+        SimGcStep();
+    else if (simDieMap.die[0].freeBlockCnt <= GC_BACKGROUND_FREE_BLOCK_COUNT)
+    {
+        sim.victimBlock = SimSelectVictim();
+        sim.victimPage  = 0;
+    }
+
+    sim.now += SIM_POLL_TIME;
+}
+
+/**
+ * @brief Serve a host write of a random logical slice, same policy as the firmware.
+ *
+ * @return unsigned int 1 if the write is done, 0 if it is held by the throttling.
+ */
+static unsigned int SimHostWrite()
+{
+    if (sim.throttled && !AdmitHostWrite(SIM_STRIPE))
+        return 0;
+
+    // check `IncrementalGarbageCollection()`
+    if ((sim.victimBlock != SIM_NONE) || (simDieMap.die[0].freeBlockCnt <= GC_START_FREE_BLOCK_COUNT))
+        SimGcStep();
+
+    // check `GarbageCollection()`
+    while ((sim.currentPage == SLICES_PER_BLOCK) && (simDieMap.die[0].freeBlockCnt <= RESERVED_FREE_BLOCK_COUNT))
+    {
+        ssdTelemetry.gcBlockingCnt++;
+        while (!SimGcStep())
+            ;
+    }
+
+    SimProgram(SimRandom() % sim.logicalSliceCnt);
+    return 1;
+}
+
+static void SimReset(unsigned int throttled, unsigned int preconditioned)
+{
+    unsigned int blockNo, lsa, iWrite;
+
+    memset(&ssdStatistics, 0, sizeof(ssdStatistics));
+    memset(&ssdTelemetry, 0, sizeof(ssdTelemetry));
+    memset(&nsMap, 0, sizeof(nsMap));
+    memset(&simDieMap, 0, sizeof(simDieMap));
+    memset(sim.validCnt, 0, sizeof(sim.validCnt));
+    memset(sim.l2p, 0xff, SIM_SLICES * sizeof(unsigned int));
+    memset(sim.p2l, 0xff, SIM_SLICES * sizeof(unsigned int));
+
+    virtualDieMapPtr  = &simDieMap;
+    nsMap.dieSlice[0] = SIM_SLICES;
+    sim.freeHead      = 0;
+    sim.freeTail      = 0;
+    sim.victimBlock   = SIM_NONE;
+    sim.now           = 0;
+
+    for (blockNo = 0; blockNo < SIM_BLOCKS; blockNo++)
+        SimPutFreeBlock(blockNo);
+    sim.currentPage = SLICES_PER_BLOCK;
+
+    // a full drive, the free blocks left are the over-provisioning
+    for (lsa = 0; lsa < sim.logicalSliceCnt; lsa++)
+        SimProgram(lsa);
+
+    // the steady state is reached under the same policy as the run
+    sim.throttled = throttled;
+    InitWriteThrottle();
+    if (preconditioned)
+        for (iWrite = 0; iWrite < SIM_PRECONDITION_CAPACITY * sim.logicalSliceCnt;)
+            iWrite += SimHostWrite();
+
+    // the throttling keeps its state, only the statistics start over
+    memset(&ssdStatistics, 0, sizeof(ssdStatistics));
+    memset(&ssdTelemetry, 0, sizeof(ssdTelemetry));
+    writeThrottle.lastGcCopyCnt = 0;
+    sim.startTime               = sim.now;
+}
+
+/**
+ * @brief Get the mean and the standard deviation of the per-second IOPS.
+ *
+ * @return double the coefficient of variation, the standard deviation over the mean.
+ */
+static double SimCv(const unsigned int *iops, unsigned int seconds, double *mean, double *stdDev)
+{
+    unsigned int second;
+    double sum, sumSq;
+
+    sum   = 0;
+    sumSq = 0;
+    for (second = 0; second < seconds; second++)
+    {
+        sum += iops[second];
+        sumSq += (double)iops[second] * iops[second];
+    }
+    *mean   = sum / seconds;
+    *stdDev = sqrt(fmax(sumSq / seconds - *mean * *mean, 0));
+
+    return *mean ? (*stdDev / *mean) : 0;
+}
+
+/**
+ * @brief Run the random writes for the specified seconds and report the per-second IOPS.
+ *
+ * @param throttled whether the writes are admitted by `AdmitHostWrite()`.
+ * @param preconditioned whether to start from the steady state, or from a full drive
+ * that still has all of its over-provisioning free, so the GC starts during the run.
+ * @param result the coefficient of variation of the per-second IOPS, over the whole run
+ * and the largest over a window of `SIM_WINDOW_SECONDS`.
+ */
+static void SimRun(unsigned int throttled, unsigned int preconditioned, unsigned int seconds, unsigned int verbose,
+                   SIM_RESULT *result)
+{
+    unsigned int *iops, second, minIops, maxIops, windowSecond;
+    double mean, stdDev, windowMean, windowStdDev, windowCv;
+
+    iops = calloc(seconds, sizeof(unsigned int));
+    SimReset(throttled, preconditioned);
+
+    while (sim.now - sim.startTime < (XTime)seconds * COUNTS_PER_SECOND)
+    {
+        second = (unsigned int)((sim.now - sim.startTime) / COUNTS_PER_SECOND);
+        if (SimHostWrite())
+            iops[second] += SIM_STRIPE;
+    }
+
+    minIops = 0xffffffff;
+    maxIops = 0;
+    for (second = 0; second < seconds; second++)
+    {
+        minIops = (iops[second] < minIops) ? iops[second] : minIops;
+        maxIops = (iops[second] > maxIops) ? iops[second] : maxIops;
+    }
+    result->cv = SimCv(iops, seconds, &mean, &stdDev);
+
+    // the mean of a run entering the GC moves, so the variance around it is bounded per window
+    result->maxWindowCv = 0;
+    windowSecond        = 0;
+    for (second = 0; second + SIM_WINDOW_SECONDS <= seconds; second++)
+    {
+        windowCv = SimCv(iops + second, SIM_WINDOW_SECONDS, &windowMean, &windowStdDev);
+        if (result->maxWindowCv < windowCv)
+        {
+            result->maxWindowCv = windowCv;
+            windowSecond        = second;
+        }
+    }
+    result->gcRun = (ssdStatistics.gcEraseCnt != 0);
+
+    printf("  %-11s mean %6.0f  stddev %6.0f  cv %.3f  min %6u  max %6u  max cv in %u s %.3f at %u s\n",
+           throttled ? "throttled" : "unthrottled", mean, stdDev, result->cv, minIops, maxIops, SIM_WINDOW_SECONDS,
+           result->maxWindowCv, windowSecond);
+    printf("  %-11s gc erases %llu  gc copies %llu  blocking gc %llu  throttled time %.1f s\n", "",
+           ssdStatistics.gcEraseCnt, ssdStatistics.gcCopyPageCnt, ssdTelemetry.gcBlockingCnt,
+           (double)ssdTelemetry.writeThrottleTime / COUNTS_PER_SECOND);
+
+    if (verbose)
+        for (second = 0; second < seconds; second++)
+            printf("%s%s %u %u\n", preconditioned ? "S" : "E", throttled ? "T" : "U", second, iops[second]);
+
+    free(iops);
+}
+
+int main(int argc, char *argv[])
+{
+    SIM_RESULT steady[2], entry[2];
+    unsigned int seconds, opPercent, verbose, iArg;
+
+    seconds   = SIM_DEFAULT_SECONDS;
+    opPercent = SIM_DEFAULT_OP_PERCENT;
+    verbose   = 0;
+    for (iArg = 1; iArg < (unsigned int)argc; iArg++)
+    {
+        if (!strcmp(argv[iArg], "-v"))
+            verbose = 1;
+        else if (!strcmp(argv[iArg], "-s") && (iArg + 1 < (unsigned int)argc))
+            seconds = (unsigned int)atoi(argv[++iArg]);
+        else if (!strcmp(argv[iArg], "-op") && (iArg + 1 < (unsigned int)argc))
+            opPercent = (unsigned int)atoi(argv[++iArg]);
+    }
+    if ((seconds < SIM_WINDOW_SECONDS) || !opPercent || (opPercent >= 100))
+    {
+        printf("usage: %s [-s seconds] [-op percent] [-v]\n", argv[0]);
+        return 2;
+    }
+
+    sim.logicalSliceCnt = SIM_SLICES / 100 * (100 - opPercent);
+    sim.l2p             = malloc(SIM_SLICES * sizeof(unsigned int));
+    sim.p2l             = malloc(SIM_SLICES * sizeof(unsigned int));
+
+    printf("%u dies of %u blocks, %u%% over-provisioning, random 16KB writes for %u seconds\n", SIM_STRIPE,
+           SIM_BLOCKS, opPercent, seconds);
+    printf("steady state:\n");
+    SimRun(0, 1, seconds, verbose, &steady[0]);
+    SimRun(1, 1, seconds, verbose, &steady[1]);
+    printf("entering the GC from a full drive with the over-provisioning free:\n");
+    SimRun(0, 0, seconds, verbose, &entry[0]);
+    SimRun(1, 0, seconds, verbose, &entry[1]);
+
+    free(sim.l2p);
+    free(sim.p2l);
+
+    // without the GC in the run there is no cliff to soften, the run is too short to tell
+    if (!entry[0].gcRun)
+    {
+        printf("the GC never ran after the drive was full, increase the seconds of the run\n");
+        return 2;
+    }
+
+    // the throttling must not add variance in the steady state, and must flatten the cliff
+    if (steady[1].cv > steady[0].cv * 1.1 + 0.005)
+    {
+        printf("FAIL: the throttling raises the variance of the steady state\n");
+        return 1;
+    }
+    if ((steady[1].maxWindowCv > SIM_MAX_WINDOW_CV) || (entry[1].maxWindowCv > SIM_MAX_WINDOW_CV))
+    {
+        printf("FAIL: the throttled IOPS vary by more than a cv of %.2f in %u seconds\n", SIM_MAX_WINDOW_CV,
+               SIM_WINDOW_SECONDS);
+        return 1;
+    }
+
+    printf("PASS\n");
+    return 0;
+}